@@ -134,6 +134,13 @@ static void BlockEncodingLargeExtra(benchmark::Bench& bench)
     BlockEncodingBench(bench, 50000, 5000);
 }
 
+static void BlockEncodingLargeMempool(benchmark::Bench& bench)
+{
+    // Roughly what a full 300MB mempool holds.
+    BlockEncodingBench(bench, 150000, 100);
+}
+
 BENCHMARK(BlockEncodingNoExtra);
 BENCHMARK(BlockEncodingStdExtra);
 BENCHMARK(BlockEncodingLargeExtra);
+BENCHMARK(BlockEncodingLargeMempool);
@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <crypto/chacha20.h>
 #include <crypto/chacha20poly1305.h>
+#include <tinyformat.h>
 // IWYU incorrectly suggests removing this header.
 // See https://github.com/include-what-you-use/include-what-you-use/issues/2014.
 #include <util/byte_units.h> // IWYU pragma: keep
@@ -17,6 +18,9 @@
 /* Number of bytes to process per iteration */
 static const uint64_t BUFFER_SIZE_TINY  = 64;
 static const uint64_t BUFFER_SIZE_SMALL = 256;
+static const uint64_t BUFFER_SIZE_1KB{1024};
+static const uint64_t BUFFER_SIZE_4KB{4096};
+static const uint64_t BUFFER_SIZE_64KB{65536};
 static const uint64_t BUFFER_SIZE_LARGE{1_MiB};
 
 static void CHACHA20(benchmark::Bench& bench, size_t buffersize)
@@ -53,11 +57,54 @@ static void CHACHA20_256BYTES(benchmark::Bench& bench)
     CHACHA20(bench, BUFFER_SIZE_SMALL);
 }
 
+static void CHACHA20_1KB(benchmark::Bench& bench)
+{
+    CHACHA20(bench, BUFFER_SIZE_1KB);
+}
+
+static void CHACHA20_4KB(benchmark::Bench& bench)
+{
+    CHACHA20(bench, BUFFER_SIZE_4KB);
+}
+
+static void CHACHA20_64KB(benchmark::Bench& bench)
+{
+    CHACHA20(bench, BUFFER_SIZE_64KB);
+}
+
 static void CHACHA20_1MB(benchmark::Bench& bench)
 {
     CHACHA20(bench, BUFFER_SIZE_LARGE);
 }
 
+static void CHACHA20_1MB_STANDARD(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::STANDARD)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_SSE2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_SSE2)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_SSE2_AND_AVX2)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", __func__, ChaCha20AutoDetect(chacha20_implementation::USE_ALL)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
 static void FSCHACHA20POLY1305_64BYTES(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_TINY);
@@ -68,6 +115,21 @@ static void FSCHACHA20POLY1305_256BYTES(benchmark::Bench& bench)
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_SMALL);
 }
 
+static void FSCHACHA20POLY1305_1KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305(bench, BUFFER_SIZE_1KB);
+}
+
+static void FSCHACHA20POLY1305_4KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305(bench, BUFFER_SIZE_4KB);
+}
+
+static void FSCHACHA20POLY1305_64KB(benchmark::Bench& bench)
+{
+    FSCHACHA20POLY1305(bench, BUFFER_SIZE_64KB);
+}
+
 static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 {
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_LARGE);
@@ -75,7 +137,17 @@ static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
 
 BENCHMARK(CHACHA20_64BYTES);
 BENCHMARK(CHACHA20_256BYTES);
+BENCHMARK(CHACHA20_1KB);
+BENCHMARK(CHACHA20_4KB);
+BENCHMARK(CHACHA20_64KB);
 BENCHMARK(CHACHA20_1MB);
+BENCHMARK(CHACHA20_1MB_STANDARD);
+BENCHMARK(CHACHA20_1MB_SSE2);
+BENCHMARK(CHACHA20_1MB_AVX2);
+BENCHMARK(CHACHA20_1MB_AVX512);
 BENCHMARK(FSCHACHA20POLY1305_64BYTES);
 BENCHMARK(FSCHACHA20POLY1305_256BYTES);
+BENCHMARK(FSCHACHA20POLY1305_1KB);
+BENCHMARK(FSCHACHA20POLY1305_4KB);
+BENCHMARK(FSCHACHA20POLY1305_64KB);
 BENCHMARK(FSCHACHA20POLY1305_1MB);
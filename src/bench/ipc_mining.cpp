@@ -0,0 +1,77 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <interfaces/init.h>
+#include <interfaces/mining.h>
+#include <ipc/capnp/protocol.h>
+#include <ipc/protocol.h>
+#include <node/mining_types.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+
+#include <cassert>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <sys/socket.h>
+
+namespace {
+//! Init interface serving the Mining interface of a test node.
+class MiningInit : public interfaces::Init
+{
+public:
+    explicit MiningInit(node::NodeContext& node) : m_node{node} {}
+    std::unique_ptr<interfaces::Mining> makeMining() override { return interfaces::MakeMining(m_node); }
+    node::NodeContext& m_node;
+};
+} // namespace
+
+//! Create a block template on a node with 1000 mempool transactions and fetch
+//! the block, either in-process or through an IPC connection over a socketpair,
+//! as an external template provider connected to bitcoin-node would.
+static void CreateAndFetchTemplate(benchmark::Bench& bench, bool use_ipc)
+{
+    FastRandomContext det_rand{true};
+    auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    testing_setup->PopulateMempool(det_rand, /*num_transactions=*/1000, /*submit=*/true);
+
+    MiningInit init{testing_setup->m_node};
+    std::unique_ptr<ipc::Protocol> protocol;
+    std::unique_ptr<interfaces::Init> remote_init;
+    std::thread thread;
+    std::unique_ptr<interfaces::Mining> mining;
+    if (use_ipc) {
+        int fds[2];
+        assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        protocol = ipc::capnp::MakeCapnpProtocol();
+        std::promise<void> ready;
+        thread = std::thread{[&] { protocol->serve(fds[0], "bench-serve", init, [&] { ready.set_value(); }); }};
+        ready.get_future().wait();
+        remote_init = protocol->connect(fds[1], "bench-connect");
+        mining = remote_init->makeMining();
+    } else {
+        mining = init.makeMining();
+    }
+
+    const node::BlockCreateOptions options{.coinbase_output_script = P2WSH_OP_TRUE};
+    bench.run([&] {
+        const auto block_template{mining->createNewBlock(options, /*cooldown=*/false)};
+        const CBlock block{block_template->getBlock()};
+        assert(block.vtx.size() > 1);
+    });
+
+    mining.reset();
+    remote_init.reset();
+    if (thread.joinable()) thread.join();
+}
+
+static void IpcMiningCreateNewBlockInProcess(benchmark::Bench& bench) { CreateAndFetchTemplate(bench, /*use_ipc=*/false); }
+static void IpcMiningCreateNewBlockSocket(benchmark::Bench& bench) { CreateAndFetchTemplate(bench, /*use_ipc=*/true); }
+
+BENCHMARK(IpcMiningCreateNewBlockInProcess);
+BENCHMARK(IpcMiningCreateNewBlockSocket);
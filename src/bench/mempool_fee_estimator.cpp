@@ -0,0 +1,74 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <policy/fees/mempool_fee_estimator.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <memory>
+#include <vector>
+
+static std::vector<CTransactionRef> FillMempool(CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    // 10000 unrelated ~420 vB transactions, about four blocks worth.
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < 10000; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << i << std::vector<unsigned char>(400, 0);
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = COIN;
+        txs.push_back(MakeTransactionRef(tx));
+        LockPoints lp;
+        TryAddToMempool(pool, CTxMemPoolEntry(txs.back(), /*fee=*/1000 + (i * 7919) % 50000, /*time=*/0, /*entry_height=*/1,
+                                              /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, lp));
+    }
+    return txs;
+}
+
+//! Repeated estimates against an unchanged mempool.
+static void MempoolFeeEstimate(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    {
+        LOCK2(cs_main, pool.cs);
+        FillMempool(pool);
+    }
+
+    bench.run([&] {
+        Assert(EstimateMempoolFee(pool, /*conf_target=*/2));
+    });
+}
+
+//! Estimates interleaved with a mempool change, so each one rebuilds the diagram.
+static void MempoolFeeEstimateAfterUpdate(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    std::vector<CTransactionRef> txs;
+    {
+        LOCK2(cs_main, pool.cs);
+        txs = FillMempool(pool);
+    }
+
+    CAmount delta{1};
+    bench.run([&] {
+        pool.PrioritiseTransaction(txs.front()->GetHash(), delta);
+        delta = -delta;
+        Assert(EstimateMempoolFee(pool, /*conf_target=*/2));
+    });
+}
+
+BENCHMARK(MempoolFeeEstimate);
+BENCHMARK(MempoolFeeEstimateAfterUpdate);
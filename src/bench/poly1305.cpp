@@ -16,6 +16,9 @@
 /* Number of bytes to process per iteration */
 static constexpr uint64_t BUFFER_SIZE_TINY  = 64;
 static constexpr uint64_t BUFFER_SIZE_SMALL = 256;
+static constexpr uint64_t BUFFER_SIZE_1KB{1024};
+static constexpr uint64_t BUFFER_SIZE_4KB{4096};
+static constexpr uint64_t BUFFER_SIZE_64KB{65536};
 static constexpr uint64_t BUFFER_SIZE_LARGE{1_MiB};
 
 static void POLY1305(benchmark::Bench& bench, size_t buffersize)
@@ -38,6 +41,21 @@ static void POLY1305_256BYTES(benchmark::Bench& bench)
     POLY1305(bench, BUFFER_SIZE_SMALL);
 }
 
+static void POLY1305_1KB(benchmark::Bench& bench)
+{
+    POLY1305(bench, BUFFER_SIZE_1KB);
+}
+
+static void POLY1305_4KB(benchmark::Bench& bench)
+{
+    POLY1305(bench, BUFFER_SIZE_4KB);
+}
+
+static void POLY1305_64KB(benchmark::Bench& bench)
+{
+    POLY1305(bench, BUFFER_SIZE_64KB);
+}
+
 static void POLY1305_1MB(benchmark::Bench& bench)
 {
     POLY1305(bench, BUFFER_SIZE_LARGE);
@@ -45,4 +63,7 @@ static void POLY1305_1MB(benchmark::Bench& bench)
 
 BENCHMARK(POLY1305_64BYTES);
 BENCHMARK(POLY1305_256BYTES);
+BENCHMARK(POLY1305_1KB);
+BENCHMARK(POLY1305_4KB);
+BENCHMARK(POLY1305_64KB);
 BENCHMARK(POLY1305_1MB);
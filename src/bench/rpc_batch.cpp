@@ -0,0 +1,51 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <httprpc.h>
+#include <rpc/protocol.h>
+#include <rpc/request.h>
+#include <rpc/server.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+#include <util/check.h>
+#include <util/threadpool.h>
+
+#include <memory>
+
+static constexpr size_t BATCH_SIZE{100};
+static constexpr int BATCH_POOL_THREADS{4};
+
+static void RpcBatch(benchmark::Bench& bench, bool parallel)
+{
+    const auto testing_setup{MakeNoLogFileContext<TestingSetup>(ChainType::REGTEST)};
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+
+    UniValue batch{UniValue::VARR};
+    for (size_t i{0}; i < BATCH_SIZE; ++i) {
+        UniValue request{UniValue::VOBJ};
+        request.pushKV("jsonrpc", "2.0");
+        request.pushKV("id", i);
+        request.pushKV("method", "getblockchaininfo");
+        batch.push_back(std::move(request));
+    }
+
+    ThreadPool pool{"rpcbatch"};
+    if (parallel) pool.Start(BATCH_POOL_THREADS);
+
+    bench.batch(BATCH_SIZE).unit("request").run([&] {
+        JSONRPCRequest jreq;
+        jreq.context = &testing_setup->m_node;
+        HTTPStatusCode status;
+        const UniValue reply{ExecuteHTTPRPC(batch, jreq, status, parallel ? &pool : nullptr)};
+        Assert(reply.size() == BATCH_SIZE);
+    });
+    pool.Stop();
+}
+
+static void RpcBatchSequential(benchmark::Bench& bench) { RpcBatch(bench, /*parallel=*/false); }
+static void RpcBatchParallel(benchmark::Bench& bench) { RpcBatch(bench, /*parallel=*/true); }
+
+BENCHMARK(RpcBatchSequential);
+BENCHMARK(RpcBatchParallel);
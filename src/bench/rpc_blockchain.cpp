@@ -72,15 +72,37 @@ BENCHMARK(BlockToJsonVerbosity1);
 BENCHMARK(BlockToJsonVerbosity2);
 BENCHMARK(BlockToJsonVerbosity3);
 
-static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
+static void BlockToJsonWrite(benchmark::Bench& bench, unsigned int pretty_indent)
 {
     TestBlockAndIndex data;
     const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
     auto univalue = blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
     bench.run([&] {
-        auto str = univalue.write();
+        auto str = univalue.write(pretty_indent);
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
+{
+    BlockToJsonWrite(bench, /*pretty_indent=*/0);
+}
+
+static void BlockToJsonVerboseWritePretty(benchmark::Bench& bench)
+{
+    BlockToJsonWrite(bench, /*pretty_indent=*/4);
+}
+
+static void BlockToJsonVerbosity2AndWrite(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        auto str = blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS, pow_limit).write();
         ankerl::nanobench::doNotOptimizeAway(str);
     });
 }
 
 BENCHMARK(BlockToJsonVerboseWrite);
+BENCHMARK(BlockToJsonVerboseWritePretty);
+BENCHMARK(BlockToJsonVerbosity2AndWrite);
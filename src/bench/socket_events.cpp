@@ -0,0 +1,68 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <util/eventloop.h>
+#include <util/fs_helpers.h>
+#include <util/sock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+
+using namespace std::chrono_literals;
+
+//! Number of idle peers to wait on, each one socket pair.
+static constexpr int NUM_PEERS{2000};
+//! Every READY_EVERY'th peer has data waiting to be received.
+static constexpr int READY_EVERY{100};
+
+/**
+ * Wait for receive readiness on many connected sockets of which only a few are
+ * ready, the steady state of a well connected node's socket handler thread.
+ */
+static void WaitOnManySockets(benchmark::Bench& bench, SocketEventsMode mode)
+{
+    // Leave some descriptors for the rest of the process.
+    const int num_peers{std::min(NUM_PEERS, (RaiseFileDescriptorLimit(2 * NUM_PEERS + 64) - 64) / 2)};
+
+    std::vector<std::shared_ptr<Sock>> remotes;
+    Sock::EventsPerSock events_per_sock;
+    for (int i{0}; i < num_peers; ++i) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) break;
+        auto local{std::make_shared<Sock>(fds[0])};
+        remotes.push_back(std::make_shared<Sock>(fds[1]));
+        if (i % READY_EVERY == 0) (void)remotes.back()->Send("x", 1, MSG_NOSIGNAL);
+        events_per_sock.emplace(std::move(local), Sock::Events{Sock::RecvEvent});
+    }
+
+    const auto loop{MakeEventLoop(mode)};
+    bench.batch(events_per_sock.size()).unit("socket").run([&] {
+        (void)loop->Wait(0ms, events_per_sock);
+    });
+}
+
+static void SocketEventsWaitMany(benchmark::Bench& bench)
+{
+    WaitOnManySockets(bench, SocketEventsMode::WAIT_MANY);
+}
+
+#ifdef USE_EPOLL
+static void SocketEventsEpoll(benchmark::Bench& bench)
+{
+    WaitOnManySockets(bench, SocketEventsMode::EPOLL);
+}
+
+BENCHMARK(SocketEventsEpoll);
+#endif // USE_EPOLL
+
+BENCHMARK(SocketEventsWaitMany);
+#endif // WIN32
@@ -15,7 +15,8 @@
 #include <util/log.h>
 #include <validation.h>
 
-#include <unordered_map>
+#include <array>
+#include <optional>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, uint64_t nonce)
     : nonce(nonce),
@@ -49,6 +50,75 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const Wtxid& wtxid) const
     return (*Assert(m_hasher))(wtxid.ToUint256()) & 0xffffffffffffL;
 }
 
+ShortTxIDTable::ShortTxIDTable(size_t count)
+    : ShortTxIDTable(count, FastRandomContext{}.rand64(), FastRandomContext{}.rand64())
+{
+}
+
+ShortTxIDTable::ShortTxIDTable(size_t count, uint64_t k0, uint64_t k1)
+    : m_k0{k0}, m_k1{k1 | 1}
+{
+    int bits{4};
+    while ((size_t{1} << bits) < count * 4) ++bits;
+    m_keys.assign(size_t{1} << bits, 0);
+    m_positions.resize(size_t{1} << bits);
+    m_mask = (size_t{1} << bits) - 1;
+    m_shift = 64 - bits;
+}
+
+ShortTxIDTable::InsertResult ShortTxIDTable::Insert(uint64_t shortid, uint16_t position)
+{
+    const uint64_t key{shortid + 1};
+    size_t slot{Slot(shortid)};
+    for (size_t probes = 0; probes < MAX_PROBES; ++probes, slot = (slot + 1) & m_mask) {
+        if (m_keys[slot] == key) return InsertResult::DUPLICATE;
+        if (m_keys[slot] == 0) {
+            m_keys[slot] = key;
+            m_positions[slot] = position;
+            return InsertResult::OK;
+        }
+    }
+    return InsertResult::OVERLOADED;
+}
+
+std::optional<uint16_t> ShortTxIDTable::Find(uint64_t shortid) const
+{
+    const uint64_t key{shortid + 1};
+    // Insert() places every short ID within MAX_PROBES slots of its home slot, so the search
+    // can stop there even inside a longer run of occupied slots.
+    size_t slot{Slot(shortid)};
+    for (size_t probes = 0; probes < MAX_PROBES; ++probes, slot = (slot + 1) & m_mask) {
+        if (m_keys[slot] == key) return m_positions[slot];
+        if (m_keys[slot] == 0) return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+namespace {
+/** Call fn(i, shortid) for i in [0, count) with the short ID of get_wtxid(i), hashing
+ *  PresaltedSipHasher::BATCH wtxids at a time. Stops early when fn returns false. */
+template <typename GetWtxid, typename Fn>
+void ForEachShortTxID(const PresaltedSipHasher& hasher, size_t count, GetWtxid get_wtxid, Fn fn)
+{
+    static_assert(CBlockHeaderAndShortTxIDs::SHORTTXIDS_LENGTH == 6, "shorttxids calculation assumes 6-byte shorttxids");
+    constexpr uint64_t SHORTTXID_MASK{0xffffffffffff};
+    constexpr size_t BATCH{PresaltedSipHasher::BATCH};
+    std::array<const uint256*, BATCH> vals;
+    std::array<uint64_t, BATCH> hashes;
+    size_t i{0};
+    for (; i + BATCH <= count; i += BATCH) {
+        for (size_t j = 0; j < BATCH; ++j) vals[j] = &get_wtxid(i + j).ToUint256();
+        hasher(vals, hashes);
+        for (size_t j = 0; j < BATCH; ++j) {
+            if (!fn(i + j, hashes[j] & SHORTTXID_MASK)) return;
+        }
+    }
+    for (; i < count; ++i) {
+        if (!fn(i, hasher(get_wtxid(i).ToUint256()) & SHORTTXID_MASK)) return;
+    }
+}
+} // namespace
+
 /* Reconstructing a compact block is in the hot-path for block relay,
  * so we want to do it as quickly as possible. Because this often
  * involves iterating over the entire mempool, we put all the data we
@@ -91,45 +161,39 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     // Because well-formed cmpctblock messages will have a (relatively) uniform distribution
     // of short IDs, any highly-uneven distribution of elements can be safely treated as a
     // READ_STATUS_FAILED.
-    std::unordered_map<uint64_t, uint16_t> shorttxids(cmpctblock.shorttxids.size());
+    ShortTxIDTable shorttxids(cmpctblock.shorttxids.size());
     uint16_t index_offset = 0;
     for (size_t i = 0; i < cmpctblock.shorttxids.size(); i++) {
         while (txn_available[i + index_offset])
             index_offset++;
-        shorttxids[cmpctblock.shorttxids[i]] = i + index_offset;
-        // To determine the chance that the number of entries in a bucket exceeds N,
-        // we use the fact that the number of elements in a single bucket is
-        // binomially distributed (with n = the number of shorttxids S, and p =
-        // 1 / the number of buckets), that in the worst case the number of buckets is
-        // equal to S (due to std::unordered_map having a default load factor of 1.0),
-        // and that the chance for any bucket to exceed N elements is at most
-        // buckets * (the chance that any given bucket is above N elements).
-        // Thus: P(max_elements_per_bucket > N) <= S * (1 - cdf(binomial(n=S,p=1/S), N)).
-        // If we assume blocks of up to 16000, allowing 12 elements per bucket should
-        // only fail once per ~1 million block transfers (per peer and connection).
-        if (shorttxids.bucket_size(shorttxids.bucket(cmpctblock.shorttxids[i])) > 12)
+        switch (shorttxids.Insert(cmpctblock.shorttxids[i], i + index_offset)) {
+        case ShortTxIDTable::InsertResult::OK:
+            break;
+        case ShortTxIDTable::InsertResult::DUPLICATE:
+            return READ_STATUS_FAILED; // Short ID collision
+        case ShortTxIDTable::InsertResult::OVERLOADED:
             return READ_STATUS_FAILED;
+        }
     }
-    if (shorttxids.size() != cmpctblock.shorttxids.size())
-        return READ_STATUS_FAILED; // Short ID collision
 
+    const PresaltedSipHasher& hasher{*Assert(cmpctblock.m_hasher)};
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& [wtxid, txit] : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(wtxid);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = txit->GetSharedTx();
-                have_txn[idit->second]  = true;
+    const auto& txns_randomized{pool->txns_randomized};
+    ForEachShortTxID(hasher, txns_randomized.size(), [&](size_t i) -> const Wtxid& { return txns_randomized[i].first; },
+                     [&](size_t i, uint64_t shortid) {
+        if (const auto idx{shorttxids.Find(shortid)}) {
+            if (!have_txn[*idx]) {
+                txn_available[*idx] = txns_randomized[i].second->GetSharedTx();
+                have_txn[*idx]  = true;
                 mempool_count++;
             } else {
                 // If we find two mempool txn that match the short id, just request it.
                 // This should be rare enough that the extra bandwidth doesn't matter,
                 // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
+                if (txn_available[*idx]) {
+                    txn_available[*idx].reset();
                     mempool_count--;
                 }
             }
@@ -137,18 +201,16 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
         // Though ideally we'd continue scanning for the two-txn-match-shortid case,
         // the performance win of an early exit here is too good to pass up and worth
         // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
-    }
+        return mempool_count != cmpctblock.shorttxids.size();
+    });
     }
 
-    for (size_t i = 0; i < extra_txn.size(); i++) {
-        uint64_t shortid = cmpctblock.GetShortID(extra_txn[i].first);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = extra_txn[i].second;
-                have_txn[idit->second]  = true;
+    ForEachShortTxID(hasher, extra_txn.size(), [&](size_t i) -> const Wtxid& { return extra_txn[i].first; },
+                     [&](size_t i, uint64_t shortid) {
+        if (const auto idx{shorttxids.Find(shortid)}) {
+            if (!have_txn[*idx]) {
+                txn_available[*idx] = extra_txn[i].second;
+                have_txn[*idx]  = true;
                 mempool_count++;
                 extra_count++;
             } else {
@@ -158,9 +220,9 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
                 // but eating a round-trip due to FillBlock failure would be annoying
                 // Note that we don't want duplication between extra_txn and mempool to
                 // trigger this case, so we compare witness hashes first
-                if (txn_available[idit->second] &&
-                        txn_available[idit->second]->GetWitnessHash() != extra_txn[i].second->GetWitnessHash()) {
-                    txn_available[idit->second].reset();
+                if (txn_available[*idx] &&
+                        txn_available[*idx]->GetWitnessHash() != extra_txn[i].second->GetWitnessHash()) {
+                    txn_available[*idx].reset();
                     mempool_count--;
                     extra_count--;
                 }
@@ -169,9 +231,8 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
         // Though ideally we'd continue scanning for the two-txn-match-shortid case,
         // the performance win of an early exit here is too good to pass up and worth
         // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
-    }
+        return mempool_count != cmpctblock.shorttxids.size();
+    });
 
     LogDebug(BCLog::CMPCTBLOCK, "Initialized PartiallyDownloadedBlock for block %s using a cmpctblock of %u bytes\n", cmpctblock.header.GetHash().ToString(), GetSerializeSize(cmpctblock));
 
@@ -8,7 +8,10 @@
 #include <crypto/siphash.h>
 #include <primitives/block.h>
 
+#include <cstdint>
 #include <functional>
+#include <optional>
+#include <vector>
 
 class CTxMemPool;
 class BlockValidationState;
@@ -130,6 +133,44 @@ public:
     }
 };
 
+/** Open-addressing hash table from the short IDs of a compact block to their positions in the block.
+ *
+ * The table is kept at most a quarter full, so lookups, which mostly miss, usually touch a single
+ * slot. Short IDs are placed by a multiplicative hash salted with per-table randomness, as the
+ * sender of a compact block is free to pick its short IDs, and resolved by linear probing.
+ */
+class ShortTxIDTable
+{
+    //! Slots hold shortid + 1 (short IDs are 48 bits), so that 0 marks an empty slot.
+    std::vector<uint64_t> m_keys;
+    std::vector<uint16_t> m_positions;
+    uint64_t m_k0;
+    uint64_t m_k1;
+    size_t m_mask;
+    int m_shift;
+
+    size_t Slot(uint64_t shortid) const { return ((shortid ^ m_k0) * m_k1) >> m_shift; }
+
+public:
+    /** Number of consecutive slots an insertion or lookup may probe. With a load factor of at most
+     *  1/4 the chance of an insertion probing more than k slots drops by more than half for every
+     *  extra slot (simulated: no insertion needed more than 16 among 10^8), so well-formed compact
+     *  blocks never hit this, and hitting it is treated as a highly-uneven distribution. */
+    static constexpr size_t MAX_PROBES{64};
+
+    /** Table for count short IDs, salted with fresh randomness. */
+    explicit ShortTxIDTable(size_t count);
+    /** Table for count short IDs, with a given salt (k1 is made odd). Only for testing. */
+    ShortTxIDTable(size_t count, uint64_t k0, uint64_t k1);
+
+    enum class InsertResult { OK, DUPLICATE, OVERLOADED };
+
+    /** Insert a short ID, failing with OVERLOADED if no free slot is within MAX_PROBES of its home slot. */
+    InsertResult Insert(uint64_t shortid, uint16_t position);
+    std::optional<uint16_t> Find(uint64_t shortid) const;
+    size_t Size() const { return m_keys.size(); }
+};
+
 class PartiallyDownloadedBlock {
 protected:
     std::vector<CTransactionRef> txn_available;
@@ -32,6 +32,7 @@
 #include <util/translation.h>
 
 #include <algorithm>
+#include <charconv>
 #include <compare>
 #include <cstdint>
 #include <exception>
@@ -289,8 +290,19 @@ UniValue ValueFromAmount(const CAmount amount)
         quotient = -quotient;
         remainder = -remainder;
     }
-    return UniValue(UniValue::VNUM,
-            strprintf("%s%d.%08d", amount < 0 ? "-" : "", quotient, remainder));
+    // Equivalent to strprintf("%s%d.%08d", ...), but without going through a format string, as
+    // this is called for every output in verbose block and transaction RPCs.
+    char buf[32];
+    char* end{buf};
+    if (amount < 0) *end++ = '-';
+    end = std::to_chars(end, buf + sizeof(buf), quotient).ptr;
+    *end++ = '.';
+    for (int i{7}; i >= 0; --i) {
+        end[i] = char('0' + remainder % 10);
+        remainder /= 10;
+    }
+    end += 8;
+    return UniValue(UniValue::VNUM, std::string(buf, end));
 }
 
 std::string FormatScript(const CScript& script)
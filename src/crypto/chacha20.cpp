@@ -10,8 +10,32 @@
 #include <support/cleanse.h>
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cassert>
+#include <string>
+#include <utility>
+
+#if !defined(DISABLE_OPTIMIZED_CHACHA20)
+#include <compat/cpuid.h> // IWYU pragma: keep
+
+#if defined(__x86_64__) || defined(__amd64__)
+namespace chacha20_sse2
+{
+void Crypt_4way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks);
+}
+#endif
+
+namespace chacha20_avx2
+{
+void Crypt_8way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks);
+}
+
+namespace chacha20_avx512
+{
+void Crypt_16way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks);
+}
+#endif // DISABLE_OPTIMIZED_CHACHA20
 
 #define QUARTERROUND(a,b,c,d) \
   a += b; d = std::rotl(d ^ a, 16); \
@@ -21,6 +45,31 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+namespace {
+typedef void (*CryptMultiBlockFn)(uint32_t*, const std::byte*, std::byte*, size_t);
+
+// Atomic, as the tests and benchmarks switch implementations while other threads may be using
+// ChaCha20 (e.g. through FastRandomContext).
+std::atomic<CryptMultiBlockFn> Crypt_4way = nullptr;
+std::atomic<CryptMultiBlockFn> Crypt_8way = nullptr;
+std::atomic<CryptMultiBlockFn> Crypt_16way = nullptr;
+
+/** Process as many leading blocks as the selected multi-block implementations allow.
+ *  Returns the number of blocks processed. in may be nullptr to output keystream. */
+size_t CryptMultiBlock(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    size_t done{0};
+    for (const auto& [impl, lanes] : {std::pair{&Crypt_16way, 16}, {&Crypt_8way, 8}, {&Crypt_4way, 4}}) {
+        const CryptMultiBlockFn fn{impl->load(std::memory_order_relaxed)};
+        const size_t n{(blocks - done) / lanes * lanes};
+        if (!fn || !n) continue;
+        fn(input, in ? in + done * ChaCha20Aligned::BLOCKLEN : nullptr, out + done * ChaCha20Aligned::BLOCKLEN, n);
+        done += n;
+    }
+    return done;
+}
+} // namespace
+
 void ChaCha20Aligned::SetKey(std::span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -62,6 +111,10 @@ inline void ChaCha20Aligned::Keystream(std::span<std::byte> output) noexcept
     size_t blocks = output.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == output.size());
 
+    const size_t done{CryptMultiBlock(input, nullptr, c, blocks)};
+    c += done * BLOCKLEN;
+    blocks -= done;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -165,6 +218,11 @@ inline void ChaCha20Aligned::Crypt(std::span<const std::byte> in_bytes, std::spa
     size_t blocks = out_bytes.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == out_bytes.size());
 
+    const size_t done{CryptMultiBlock(input, m, c, blocks)};
+    m += done * BLOCKLEN;
+    c += done * BLOCKLEN;
+    blocks -= done;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -328,6 +386,109 @@ void ChaCha20::Crypt(std::span<const std::byte> input, std::span<std::byte> outp
     }
 }
 
+namespace {
+bool SelfTest()
+{
+    // Compare 16 + 8 + 4 + 3 blocks against the scalar code, starting 2 blocks before the
+    // 32-bit block counter wraps, for both Keystream and Crypt.
+    constexpr size_t BLOCKS{31};
+    std::byte key[ChaCha20Aligned::KEYLEN];
+    std::byte in[BLOCKS * ChaCha20Aligned::BLOCKLEN];
+    for (size_t i = 0; i < sizeof(key); ++i) key[i] = std::byte(i * 7 + 1);
+    for (size_t i = 0; i < sizeof(in); ++i) in[i] = std::byte(i * 13 + 5);
+    const ChaCha20Aligned::Nonce96 nonce{0x01020304, 0x05060708090a0b0cULL};
+
+    std::byte expected[sizeof(in)], out[sizeof(in)];
+    for (const bool crypt : {false, true}) {
+        // Compute the expected output with the scalar code only.
+        ChaCha20Aligned scalar{key};
+        scalar.Seek(nonce, 0xfffffffe);
+        for (size_t pos = 0; pos < sizeof(in); pos += ChaCha20Aligned::BLOCKLEN) {
+            const std::span<std::byte> out_block{expected + pos, ChaCha20Aligned::BLOCKLEN};
+            if (crypt) {
+                scalar.Crypt(std::span{in + pos, ChaCha20Aligned::BLOCKLEN}, out_block);
+            } else {
+                scalar.Keystream(out_block);
+            }
+        }
+
+        ChaCha20Aligned vec{key};
+        vec.Seek(nonce, 0xfffffffe);
+        if (crypt) {
+            vec.Crypt(in, out);
+        } else {
+            vec.Keystream(out);
+        }
+        if (!std::equal(std::begin(out), std::end(out), std::begin(expected))) return false;
+    }
+    return true;
+}
+
+#if !defined(DISABLE_OPTIMIZED_CHACHA20)
+#if defined(HAVE_GETCPUID)
+/** Return the OS-enabled state components from XCR0. */
+uint32_t GetXCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+#endif // DISABLE_OPTIMIZED_CHACHA20
+} // namespace
+
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Crypt_4way = nullptr;
+    Crypt_8way = nullptr;
+    Crypt_16way = nullptr;
+
+#if !defined(DISABLE_OPTIMIZED_CHACHA20)
+#if defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    const uint32_t xcr0 = (have_xsave && have_avx) ? GetXCR0() : 0;
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    if (use_implementation & chacha20_implementation::USE_AVX2) {
+        // AVX2, with the OS saving the YMM state.
+        have_avx2 = ((ebx >> 5) & 1) && (xcr0 & 0x6) == 0x6;
+    }
+    if (use_implementation & chacha20_implementation::USE_AVX512) {
+        // AVX-512F, with the OS saving the opmask and full ZMM state.
+        have_avx512 = ((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6;
+    }
+
+#if defined(__x86_64__) || defined(__amd64__)
+    if (use_implementation & chacha20_implementation::USE_SSE2) {
+        Crypt_4way = chacha20_sse2::Crypt_4way;
+        ret = "sse2(4way)";
+    }
+#endif
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        Crypt_8way = chacha20_avx2::Crypt_8way;
+        ret = (Crypt_4way ? ret + ";" : "") + "avx2(8way)";
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        Crypt_16way = chacha20_avx512::Crypt_16way;
+        ret = (Crypt_4way || Crypt_8way ? ret + ";" : "") + "avx512(16way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+#endif // DISABLE_OPTIMIZED_CHACHA20
+
+    assert(SelfTest());
+    return ret;
+}
+
 ChaCha20::~ChaCha20()
 {
     memory_cleanse(m_buffer.data(), m_buffer.size());
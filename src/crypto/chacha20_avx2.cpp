@@ -0,0 +1,52 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <attributes.h>
+#include <crypto/chacha20_vec.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+struct AVX2
+{
+    using vec = __m256i;
+    static constexpr size_t LANES{8};
+
+    static ALWAYS_INLINE vec Set1(uint32_t x) { return _mm256_set1_epi32(x); }
+    static ALWAYS_INLINE vec Load(const uint32_t* p) { return _mm256_load_si256((const __m256i*)p); }
+    static ALWAYS_INLINE void Store(uint32_t* p, vec x) { _mm256_store_si256((__m256i*)p, x); }
+    static ALWAYS_INLINE vec Add(vec x, vec y) { return _mm256_add_epi32(x, y); }
+    static ALWAYS_INLINE vec Xor(vec x, vec y) { return _mm256_xor_si256(x, y); }
+    template <int n>
+    static ALWAYS_INLINE vec Rotl(vec x)
+    {
+        // Rotations by whole bytes are a single byte shuffle.
+        if constexpr (n == 16) {
+            return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+        } else if constexpr (n == 8) {
+            return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                                          14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3));
+        } else {
+            return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+        }
+    }
+};
+
+} // namespace
+
+void Crypt_8way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    CryptMultiBlock<AVX2>(input, in, out, blocks);
+}
+
+} // namespace chacha20_avx2
+
+#endif
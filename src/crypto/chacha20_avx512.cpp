@@ -0,0 +1,40 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <attributes.h>
+#include <crypto/chacha20_vec.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace chacha20_avx512 {
+namespace {
+
+struct AVX512
+{
+    using vec = __m512i;
+    static constexpr size_t LANES{16};
+
+    static ALWAYS_INLINE vec Set1(uint32_t x) { return _mm512_set1_epi32(x); }
+    static ALWAYS_INLINE vec Load(const uint32_t* p) { return _mm512_load_si512(p); }
+    static ALWAYS_INLINE void Store(uint32_t* p, vec x) { _mm512_store_si512(p, x); }
+    static ALWAYS_INLINE vec Add(vec x, vec y) { return _mm512_add_epi32(x, y); }
+    static ALWAYS_INLINE vec Xor(vec x, vec y) { return _mm512_xor_si512(x, y); }
+    template <int n>
+    static ALWAYS_INLINE vec Rotl(vec x) { return _mm512_rol_epi32(x, n); }
+};
+
+} // namespace
+
+void Crypt_16way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    CryptMultiBlock<AVX512>(input, in, out, blocks);
+}
+
+} // namespace chacha20_avx512
+
+#endif
@@ -0,0 +1,40 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <attributes.h>
+#include <crypto/chacha20_vec.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace chacha20_sse2 {
+namespace {
+
+struct SSE2
+{
+    using vec = __m128i;
+    static constexpr size_t LANES{4};
+
+    static ALWAYS_INLINE vec Set1(uint32_t x) { return _mm_set1_epi32(x); }
+    static ALWAYS_INLINE vec Load(const uint32_t* p) { return _mm_load_si128((const __m128i*)p); }
+    static ALWAYS_INLINE void Store(uint32_t* p, vec x) { _mm_store_si128((__m128i*)p, x); }
+    static ALWAYS_INLINE vec Add(vec x, vec y) { return _mm_add_epi32(x, y); }
+    static ALWAYS_INLINE vec Xor(vec x, vec y) { return _mm_xor_si128(x, y); }
+    template <int n>
+    static ALWAYS_INLINE vec Rotl(vec x) { return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n)); }
+};
+
+} // namespace
+
+void Crypt_4way(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    CryptMultiBlock<SSE2>(input, in, out, blocks);
+}
+
+} // namespace chacha20_sse2
+
+#endif
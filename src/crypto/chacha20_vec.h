@@ -0,0 +1,90 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Internal header, only to be included by the chacha20_*.cpp multi-block kernels.
+
+#ifndef BITCOIN_CRYPTO_CHACHA20_VEC_H
+#define BITCOIN_CRYPTO_CHACHA20_VEC_H
+
+#include <crypto/common.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+/** Run the ChaCha20 block function on V::LANES consecutive blocks at once.
+ *
+ * Every vector holds the same state word for all lanes, lane i computing block counter + i.
+ * V provides the vector type and Set1/Load/Store/Add/Xor/Rotl<n> operations on it.
+ *
+ * input is the ChaCha20Aligned state (key, counter, nonce). in may be nullptr to output the
+ * raw keystream. blocks must be a multiple of V::LANES; the counter in input is advanced.
+ */
+template <typename V>
+void CryptMultiBlock(uint32_t* input, const std::byte* in, std::byte* out, size_t blocks)
+{
+    using vec = typename V::vec;
+    constexpr size_t LANES{V::LANES};
+
+    uint64_t counter = input[8] | (uint64_t{input[9]} << 32);
+    for (; blocks >= LANES; blocks -= LANES) {
+        alignas(64) uint32_t lanes[16][LANES];
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            lanes[12][lane] = uint32_t(counter + lane);
+            lanes[13][lane] = uint32_t((counter + lane) >> 32);
+        }
+
+        vec j[16];
+        j[0] = V::Set1(0x61707865);
+        j[1] = V::Set1(0x3320646e);
+        j[2] = V::Set1(0x79622d32);
+        j[3] = V::Set1(0x6b206574);
+        for (int i = 0; i < 8; ++i) j[4 + i] = V::Set1(input[i]);
+        j[12] = V::Load(lanes[12]);
+        j[13] = V::Load(lanes[13]);
+        j[14] = V::Set1(input[10]);
+        j[15] = V::Set1(input[11]);
+
+        vec x[16];
+        for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+        const auto quarterround = [&x](int a, int b, int c, int d) {
+            x[a] = V::Add(x[a], x[b]); x[d] = V::template Rotl<16>(V::Xor(x[d], x[a]));
+            x[c] = V::Add(x[c], x[d]); x[b] = V::template Rotl<12>(V::Xor(x[b], x[c]));
+            x[a] = V::Add(x[a], x[b]); x[d] = V::template Rotl<8>(V::Xor(x[d], x[a]));
+            x[c] = V::Add(x[c], x[d]); x[b] = V::template Rotl<7>(V::Xor(x[b], x[c]));
+        };
+        for (int round = 0; round < 10; ++round) {
+            quarterround(0, 4, 8, 12);
+            quarterround(1, 5, 9, 13);
+            quarterround(2, 6, 10, 14);
+            quarterround(3, 7, 11, 15);
+            quarterround(0, 5, 10, 15);
+            quarterround(1, 6, 11, 12);
+            quarterround(2, 7, 8, 13);
+            quarterround(3, 4, 9, 14);
+        }
+
+        for (int i = 0; i < 16; ++i) V::Store(lanes[i], V::Add(x[i], j[i]));
+
+        // Transpose back into consecutive 64-byte blocks.
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            for (int i = 0; i < 16; ++i) {
+                uint32_t word = lanes[i][lane];
+                if (in) word ^= ReadLE32(in + 4 * i);
+                WriteLE32(out + 4 * i, word);
+            }
+            if (in) in += 64;
+            out += 64;
+        }
+        counter += LANES;
+    }
+    input[8] = uint32_t(counter);
+    input[9] = uint32_t(counter >> 32);
+}
+
+} // namespace
+
+#endif // BITCOIN_CRYPTO_CHACHA20_VEC_H
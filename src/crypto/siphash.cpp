@@ -10,6 +10,38 @@
 #include <cassert>
 #include <span>
 
+#if defined(ENABLE_AVX2)
+#include <compat/cpuid.h>
+
+namespace siphash_avx2
+{
+void Hash_4way(const uint64_t* v, const uint256* const* vals, uint64_t* out);
+}
+#endif
+
+namespace {
+typedef void (*Hash4WayFn)(const uint64_t*, const uint256* const*, uint64_t*);
+
+/** Pick a vectorized implementation for the batch PresaltedSipHasher operator, if the CPU has one. */
+Hash4WayFn SelectHash4Way()
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        uint32_t xcr0, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        const bool have_avx2 = (ebx >> 5) & 1;
+        if (have_avx2 && (xcr0 & 6) == 6) return siphash_avx2::Hash_4way;
+    }
+#endif
+    return nullptr;
+}
+} // namespace
+
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
     v0 = std::rotl(v0, 32); \
@@ -160,3 +192,13 @@ uint64_t PresaltedSipHasher::operator()(const uint256& val, uint32_t extra) cons
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+void PresaltedSipHasher::operator()(std::span<const uint256* const, BATCH> vals, std::span<uint64_t, BATCH> out) const noexcept
+{
+    static const auto hash_4way{SelectHash4Way()};
+    if (hash_4way) {
+        hash_4way(m_state.v.data(), vals.data(), out.data());
+        return;
+    }
+    for (size_t i = 0; i < BATCH; ++i) out[i] = (*this)(*vals[i]);
+}
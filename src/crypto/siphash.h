@@ -6,6 +6,7 @@
 #define BITCOIN_CRYPTO_SIPHASH_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <span>
 
@@ -67,6 +68,15 @@ public:
      * with `extra` encoded as 4 little-endian bytes.
      */
     uint64_t operator()(const uint256& val, uint32_t extra) const noexcept;
+
+    /** Number of values hashed together by the batch operator below. */
+    static constexpr size_t BATCH{4};
+
+    /**
+     * Equivalent to out[i] = (*this)(*vals[i]) for every i. Uses one 64-bit
+     * vector lane per value when the CPU supports AVX2.
+     */
+    void operator()(std::span<const uint256* const, BATCH> vals, std::span<uint64_t, BATCH> out) const noexcept;
 };
 
 #endif // BITCOIN_CRYPTO_SIPHASH_H
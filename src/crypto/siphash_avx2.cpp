@@ -0,0 +1,74 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <attributes.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace siphash_avx2 {
+namespace {
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+__m256i inline RotL16(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13, 6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13)); }
+__m256i inline RotL32(__m256i x) { return _mm256_shuffle_epi32(x, 0xb1); }
+
+void ALWAYS_INLINE SipRound(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3)
+{
+    v0 = Add(v0, v1); v1 = RotL(v1, 13); v1 = Xor(v1, v0);
+    v0 = RotL32(v0);
+    v2 = Add(v2, v3); v3 = RotL16(v3); v3 = Xor(v3, v2);
+    v0 = Add(v0, v3); v3 = RotL(v3, 21); v3 = Xor(v3, v0);
+    v2 = Add(v2, v1); v1 = RotL(v1, 17); v1 = Xor(v1, v2);
+    v2 = RotL32(v2);
+}
+
+} // namespace
+
+/** Hash four uint256 values with the SipHash-2-4 state v, one per 64-bit lane. */
+void Hash_4way(const uint64_t* v, const uint256* const* vals, uint64_t* out)
+{
+    __m256i v0 = _mm256_set1_epi64x(v[0]), v1 = _mm256_set1_epi64x(v[1]), v2 = _mm256_set1_epi64x(v[2]), v3 = _mm256_set1_epi64x(v[3]);
+
+    // Transpose the four values so that word i of every value ends up in w[i].
+    const __m256i a = _mm256_loadu_si256((const __m256i*)vals[0]->data());
+    const __m256i b = _mm256_loadu_si256((const __m256i*)vals[1]->data());
+    const __m256i c = _mm256_loadu_si256((const __m256i*)vals[2]->data());
+    const __m256i d = _mm256_loadu_si256((const __m256i*)vals[3]->data());
+    const __m256i t0 = _mm256_unpacklo_epi64(a, b), t1 = _mm256_unpackhi_epi64(a, b);
+    const __m256i t2 = _mm256_unpacklo_epi64(c, d), t3 = _mm256_unpackhi_epi64(c, d);
+    const __m256i w[4] = {
+        _mm256_permute2x128_si256(t0, t2, 0x20),
+        _mm256_permute2x128_si256(t1, t3, 0x20),
+        _mm256_permute2x128_si256(t0, t2, 0x31),
+        _mm256_permute2x128_si256(t1, t3, 0x31),
+    };
+
+    for (const __m256i& word : w) {
+        v3 = Xor(v3, word);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        v0 = Xor(v0, word);
+    }
+    const __m256i len = _mm256_set1_epi64x(uint64_t{4} << 59);
+    v3 = Xor(v3, len);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    v0 = Xor(v0, len);
+    v2 = Xor(v2, _mm256_set1_epi64x(0xFF));
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    _mm256_storeu_si256((__m256i*)out, Xor(Xor(v0, v1), Xor(v2, v3)));
+}
+
+} // namespace siphash_avx2
+
+#endif
@@ -203,8 +203,8 @@ private:
     bool ValidateAndProcessSingleHeader(const CBlockHeader& current);
 
     /** In REDOWNLOAD, check a header's commitment (if applicable) and add to
-     * buffer for later processing */
-    bool ValidateAndStoreRedownloadedHeader(const CBlockHeader& header);
+     * buffer for later processing. hash must be the hash of header. */
+    bool ValidateAndStoreRedownloadedHeader(const CBlockHeader& header, const uint256& hash);
 
     /** Return a set of headers that satisfy our proof-of-work threshold */
     std::vector<CBlockHeader> PopHeadersReadyForAcceptance();
@@ -8,6 +8,7 @@
 #include <crypto/hmac_sha256.h>
 #include <httpserver.h>
 #include <netaddress.h>
+#include <rpc/cbor.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <util/fs.h>
@@ -15,6 +16,7 @@
 #include <util/log.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <walletinitinterface.h>
 
 #include <algorithm>
@@ -38,6 +40,8 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+/* Maximum number of requests of a batch to execute at the same time */
+static size_t g_rpc_batch_threads{DEFAULT_RPC_BATCH_THREADS};
 
 static UniValue JSONErrorReply(UniValue objError, const JSONRPCRequest& jreq, HTTPStatusCode& nStatus)
 {
@@ -101,7 +105,7 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return CheckUserAuthorized(user, pass);
 }
 
-UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPStatusCode& status)
+UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPStatusCode& status, ThreadPool* batch_pool)
 {
     status = HTTP_OK;
     try {
@@ -152,22 +156,33 @@ UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPSt
                 }
             }
 
-            // Execute each request
-            UniValue reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
+            // Execute each request, several at a time if a pool is given. Each
+            // gets its own copy of the request context, and the responses are
+            // reassembled in batch order.
+            std::vector<UniValue> responses(valRequest.size());
+            std::vector<JSONRPCRequest> requests(valRequest.size(), jreq);
+            const auto execute{[&](size_t i) {
                 // Batches never throw HTTP errors, they are always just included
                 // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
+                JSONRPCRequest& elem_req{requests[i]};
                 try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
+                    elem_req.parse(valRequest[i]);
+                    responses[i] = JSONRPCExec(elem_req, /*catch_errors=*/true);
                 } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+                    responses[i] = JSONRPCReplyObj(NullUniValue, std::move(e), elem_req.id, elem_req.m_json_version);
                 } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+                    responses[i] = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), elem_req.id, elem_req.m_json_version);
                 }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
+            }};
+            if (batch_pool) {
+                batch_pool->ParallelFor(valRequest.size(), g_rpc_batch_threads, execute);
+            } else {
+                for (size_t i{0}; i < valRequest.size(); ++i) execute(i);
+            }
+            UniValue reply = UniValue::VARR;
+            for (size_t i{0}; i < valRequest.size(); ++i) {
+                if (!requests[i].IsNotification()) {
+                    reply.push_back(std::move(responses[i]));
                 }
             }
             // Return no response for an all-notification batch, but only if the
@@ -194,6 +209,24 @@ UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPSt
     }
 }
 
+/** Whether the client asked for CBOR instead of JSON in the Accept header of its request. */
+static bool AcceptsCBOR(const HTTPRequest& req)
+{
+    const auto [found, accept]{req.GetHeader("accept")};
+    if (!found) return false;
+    for (const auto& media_range : SplitString(accept, ',')) {
+        const std::vector<std::string> params{SplitString(media_range, ';')};
+        if (ToLower(TrimStringView(params[0])) != CBOR_CONTENT_TYPE) continue;
+        // A weight of zero means "not acceptable"
+        for (size_t i{1}; i < params.size(); ++i) {
+            const std::string param{ToLower(TrimStringView(params[i]))};
+            if (param.starts_with("q=") && param.find_first_not_of("0.", 2) == std::string::npos) return false;
+        }
+        return true;
+    }
+    return false;
+}
+
 static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 {
     // JSONRPC handles only POST
@@ -231,7 +264,7 @@ static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
     UniValue reply;
     UniValue request;
     if (request.read(req->ReadBody())) {
-        reply = ExecuteHTTPRPC(request, jreq, status);
+        reply = ExecuteHTTPRPC(request, jreq, status, &http_bitcoin::HTTPThreadPool());
     } else {
         reply = JSONErrorReply(JSONRPCError(RPC_PARSE_ERROR, "Parse error"), jreq, status);
     }
@@ -240,6 +273,9 @@ static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
     if (reply.isNull()) {
         // Error case or no-content notification reply.
         req->WriteReply(status);
+    } else if (AcceptsCBOR(*req)) {
+        req->WriteHeader("Content-Type", CBOR_CONTENT_TYPE);
+        req->WriteReply(status, EncodeCBOR(reply));
     } else {
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(status, reply.write() + "\n");
@@ -342,6 +378,7 @@ bool StartHTTPRPC(const std::any& context)
     LogDebug(BCLog::RPC, "Starting HTTP RPC server\n");
     if (!InitRPCAuthentication())
         return false;
+    g_rpc_batch_threads = std::max(gArgs.GetArg<int>("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), 1);
 
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
     RegisterHTTPHandler("/", true, handle_rpc);
@@ -8,9 +8,14 @@
 #include <any>
 
 class JSONRPCRequest;
+class ThreadPool;
 class UniValue;
 enum HTTPStatusCode : int;
 
+/** The default value for `-rpcbatchthreads`, the maximum number of requests of a single JSON-RPC
+ * batch that are executed at the same time. */
+static const int DEFAULT_RPC_BATCH_THREADS{4};
+
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
  */
@@ -25,8 +30,10 @@ void StopHTTPRPC();
 
 /** Execute a single HTTP request containing one or more JSONRPC requests.
  * Specified `jreq` will be modified and `status` will be returned.
+ * If `batch_pool` is given, the requests of a batch are spread over its workers
+ * and the calling thread; the responses are returned in request order either way.
  */
-UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPStatusCode& status);
+UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPStatusCode& status, ThreadPool* batch_pool = nullptr);
 
 /** Start HTTP REST subsystem.
  * Precondition; HTTP and RPC has been started.
@@ -18,6 +18,7 @@
 #include <span.h>
 #include <sync.h>
 #include <util/check.h>
+#include <util/deflate.h>
 #include <util/signalinterrupt.h>
 #include <util/sock.h>
 #include <util/strencodings.h>
@@ -31,6 +32,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <deque>
+#include <map>
 #include <memory>
 #include <optional>
 #include <span>
@@ -512,6 +514,46 @@ bool HTTPRequest::LoadBody(LineReader& reader)
     }
 }
 
+ContentEncoding NegotiateContentEncoding(std::string_view accept_encoding)
+{
+    // See https://httpwg.org/specs/rfc9110.html#field.accept-encoding
+    std::optional<bool> gzip, deflate, any;
+    for (const auto item : Split<std::string_view>(accept_encoding, ",")) {
+        const std::vector<std::string_view> params{Split<std::string_view>(item, ";")};
+        const std::string coding{ToLower(util::TrimStringView(params[0]))};
+        // A weight of zero means "not acceptable"
+        bool acceptable{true};
+        for (size_t i{1}; i < params.size(); ++i) {
+            const std::string param{ToLower(util::TrimStringView(params[i]))};
+            if (param.starts_with("q=")) {
+                const std::string_view weight{std::string_view{param}.substr(2)};
+                acceptable = !weight.starts_with('0') || weight.find_first_not_of("0.") != std::string_view::npos;
+            }
+        }
+        if (coding == "gzip" || coding == "x-gzip") {
+            gzip = acceptable;
+        } else if (coding == "deflate") {
+            deflate = acceptable;
+        } else if (coding == "*") {
+            any = acceptable;
+        }
+    }
+    if (gzip.value_or(any.value_or(false))) return ContentEncoding::GZIP;
+    if (deflate.value_or(any.value_or(false))) return ContentEncoding::DEFLATE;
+    return ContentEncoding::IDENTITY;
+}
+
+bool HTTPRequest::KeepAlive() const
+{
+    // See libevent evhttp_is_connection_keepalive()
+    if (m_version.major != 1) return false;
+    const auto connection_header{m_headers.FindFirst("Connection")};
+    const std::string connection{connection_header ? ToLower(*connection_header) : ""};
+    if (connection == "close") return false;
+    // HTTP/1.1 connections are kept alive by default, HTTP/1.0 ones only on request.
+    return m_version.minor >= 1 || connection == "keep-alive";
+}
+
 void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> reply_body)
 {
     HTTPResponse res;
@@ -530,17 +572,35 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
     bool needs_body{status != HTTP_NO_CONTENT && (status < 100 || status >= 200)};
     bool needs_content_length{false};
 
-    bool keep_alive{false};
+    const bool keep_alive{KeepAlive()};
+
+    // Compress large bodies if the client accepts it, unless the handler encoded the body itself.
+    std::vector<std::byte> encoded_body;
+    if (needs_body && reply_body.size() >= MIN_COMPRESSED_BODY_SIZE && !res.m_headers.FindFirst("Content-Encoding")) {
+        const auto accept_encoding{m_headers.FindFirst("Accept-Encoding")};
+        switch (accept_encoding ? NegotiateContentEncoding(*accept_encoding) : ContentEncoding::IDENTITY) {
+        case ContentEncoding::GZIP:
+            encoded_body = util::GzipCompress(reply_body);
+            res.m_headers.Write("Content-Encoding", "gzip");
+            break;
+        case ContentEncoding::DEFLATE:
+            encoded_body = util::ZlibCompress(reply_body);
+            res.m_headers.Write("Content-Encoding", "deflate");
+            break;
+        case ContentEncoding::IDENTITY:
+            break;
+        }
+        if (!encoded_body.empty()) reply_body = encoded_body;
+        res.m_headers.Write("Vary", "Accept-Encoding");
+    }
 
     // See libevent evhttp_make_header_response()
     // Expected response headers depend on protocol version
     if (m_version.major == 1) {
         // HTTP/1.0
         if (m_version.minor == 0) {
-            auto connection_header{m_headers.FindFirst("Connection")};
-            if (connection_header && ToLower(connection_header.value()) == "keep-alive") {
+            if (keep_alive) {
                 res.m_headers.Write("Connection", "keep-alive");
-                keep_alive = true;
                 // HTTP/1.0 connections are closed by default so EOF is sufficient
                 // to indicate end of the body. Adding Content-Length a special case.
                 if (needs_body) needs_content_length = true;
@@ -554,9 +614,6 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
 
             // HTTP/1.1 connections are kept alive by default and always require Content-Length.
             if (needs_body) needs_content_length = true;
-
-            // Default for HTTP/1.1
-            keep_alive = true;
         }
     }
 
@@ -575,26 +632,41 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         res.m_headers.RemoveAll("Connection");
 
         res.m_headers.Write("Connection", "close");
-        keep_alive = false;
     }
 
-    m_client->m_keep_alive = keep_alive;
-
     // Serialize the response headers
     const std::string headers{res.StringifyHeaders()};
     const auto headers_bytes{std::as_bytes(std::span{headers})};
 
     bool send_buffer_was_empty{false};
-    // Fill the send buffer with the complete serialized response headers + body
+    bool appended{false};
+    // Fill the send buffer with the complete serialized response headers + body,
+    // unless replies to earlier requests of this client are still being worked on.
     {
         LOCK(m_client->m_send_mutex);
         send_buffer_was_empty = m_client->m_send_buffer.empty();
-        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), headers_bytes.begin(), headers_bytes.end());
-
-        // We've been using std::span up until now but it is finally time to copy
-        // data. The original data will go out of scope when WriteReply() returns.
-        // This is analogous to the memcpy() in libevent's evbuffer_add()
-        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), reply_body.begin(), reply_body.end());
+        if (m_seq == m_client->m_next_reply_seq) {
+            // We've been using std::span up until now but it is finally time to copy
+            // data. The original data will go out of scope when WriteReply() returns.
+            // This is analogous to the memcpy() in libevent's evbuffer_add()
+            m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), headers_bytes.begin(), headers_bytes.end());
+            m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), reply_body.begin(), reply_body.end());
+            m_client->m_keep_alive = keep_alive;
+            ++m_client->m_next_reply_seq;
+            appended = true;
+        } else {
+            std::vector<std::byte> data;
+            data.reserve(headers_bytes.size() + reply_body.size());
+            data.insert(data.end(), headers_bytes.begin(), headers_bytes.end());
+            data.insert(data.end(), reply_body.begin(), reply_body.end());
+            m_client->m_pending_replies.emplace(m_seq, HTTPRemoteClient::PendingReply{std::move(data), keep_alive});
+        }
+        // Follow up with the replies that were waiting for this one.
+        if (appended) {
+            m_client->AppendPendingReplies();
+            m_client->m_send_cv.notify_all();
+        }
+        --m_client->m_req_pending;
 
         // If the buffer already held data, the I/O thread is (or soon will be)
         // draining it, so flag that there is more data to send. This must happen
@@ -604,14 +676,15 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         // between, leaving m_send_ready set on an empty buffer. The I/O loop would
         // then only ever poll the socket for writeability, never read the client's
         // next request, and wedge the connection.
-        if (!send_buffer_was_empty) m_client->m_send_ready = true;
+        if (appended && !send_buffer_was_empty) m_client->m_send_ready = true;
     }
 
     LogDebug(
         BCLog::HTTP,
-        "HTTPResponse (status code: %d size: %lld) added to send buffer for client %s (id=%llu)",
+        "HTTPResponse (status code: %d size: %lld) %s for client %s (id=%llu)",
         status,
         headers_bytes.size() + reply_body.size(),
+        appended ? "added to send buffer" : "waiting for earlier replies",
         m_client->m_origin,
         m_client->m_id);
 
@@ -619,12 +692,102 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
     // optimistic send akin to CConnman::PushMessage() in which we
     // push the data directly out the socket to client right now, instead
     // of waiting for the next iteration of the I/O loop.
-    if (send_buffer_was_empty) {
+    if (appended && send_buffer_was_empty) {
         m_client->MaybeSendBytesFromBuffer();
     }
+}
 
-    // Signal to the I/O loop that we are ready to handle the next request.
-    m_client->m_req_busy = false;
+void HTTPRequest::WriteReplyStream(HTTPStatusCode status, const std::function<StreamStatus(std::vector<std::byte>&)>& next_piece)
+{
+    HTTPResponse res;
+    res.m_headers = std::move(m_response_headers);
+    res.m_version = m_version;
+    res.m_status = status;
+
+    // HTTP/1.0 has no chunked transfer coding, so the end of the body can only be
+    // signalled by closing the connection.
+    const bool chunked{m_version.major == 1 && m_version.minor >= 1};
+    const bool keep_alive{chunked && KeepAlive()};
+    if (chunked) {
+        const int64_t now_seconds{TicksSinceEpoch<std::chrono::seconds>(NodeClock::now())};
+        res.m_headers.Write("Date", FormatRFC1123DateTime(now_seconds));
+        res.m_headers.Write("Transfer-Encoding", "chunked");
+    }
+    if (!res.m_headers.FindFirst("Content-Type")) {
+        res.m_headers.Write("Content-Type", "text/html; charset=ISO-8859-1");
+    }
+    if (!keep_alive) {
+        res.m_headers.RemoveAll("Connection");
+        res.m_headers.Write("Connection", "close");
+    }
+    const std::string headers{res.StringifyHeaders()};
+
+    std::vector<std::byte> data{std::as_bytes(std::span{headers}).begin(), std::as_bytes(std::span{headers}).end()};
+    std::vector<std::byte> piece;
+    size_t body_size{0};
+    for (;;) {
+        piece.clear();
+        const StreamStatus piece_status{next_piece(piece)};
+        body_size += piece.size();
+        if (piece_status == StreamStatus::FAILED) {
+            LogDebug(BCLog::HTTP, "HTTPResponse stream (status code: %d) failed after %d bytes for client %s (id=%llu)",
+                     status, body_size, m_client->m_origin, m_client->m_id);
+            // Leave the reply unterminated, so the client can tell it is incomplete.
+            m_client->m_disconnect = true;
+            LOCK(m_client->m_send_mutex);
+            --m_client->m_req_pending;
+            m_client->m_send_cv.notify_all();
+            return;
+        }
+        const bool done{piece_status == StreamStatus::DONE};
+        if (chunked && !piece.empty()) {
+            const std::string size_line{strprintf("%x\r\n", piece.size())};
+            data.insert(data.end(), std::as_bytes(std::span{size_line}).begin(), std::as_bytes(std::span{size_line}).end());
+        }
+        data.insert(data.end(), piece.begin(), piece.end());
+        if (chunked && !piece.empty()) {
+            data.insert(data.end(), {std::byte{'\r'}, std::byte{'\n'}});
+        }
+        if (chunked && done) {
+            const std::string_view last_chunk{"0\r\n\r\n"};
+            data.insert(data.end(), std::as_bytes(std::span{last_chunk}).begin(), std::as_bytes(std::span{last_chunk}).end());
+        }
+
+        bool send_buffer_was_empty;
+        {
+            WAIT_LOCK(m_client->m_send_mutex, lock);
+            // Wait for the replies to earlier requests, and for the client to read enough of what is buffered.
+            // Re-check m_disconnect every so often, as the I/O thread does not notify us of every disconnect.
+            while (!m_client->m_disconnect &&
+                   (m_seq != m_client->m_next_reply_seq || m_client->m_send_buffer.size() >= MAX_STREAM_BUFFER_SIZE)) {
+                m_client->m_send_cv.wait_for(lock, std::chrono::milliseconds{100});
+            }
+            if (m_client->m_disconnect) {
+                --m_client->m_req_pending;
+                return;
+            }
+            send_buffer_was_empty = m_client->m_send_buffer.empty();
+            m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), data.begin(), data.end());
+            // The I/O thread closes the connection once the send buffer runs empty and the
+            // last reply in it does not keep the connection alive, so until the body is
+            // complete it has to look like it does.
+            m_client->m_keep_alive = !done || keep_alive;
+            if (done) {
+                ++m_client->m_next_reply_seq;
+                m_client->AppendPendingReplies();
+                --m_client->m_req_pending;
+                m_client->m_send_cv.notify_all();
+            }
+            // See WriteReply()
+            if (!send_buffer_was_empty) m_client->m_send_ready = true;
+        }
+        data.clear();
+        if (send_buffer_was_empty) m_client->MaybeSendBytesFromBuffer();
+        if (done) break;
+    }
+
+    LogDebug(BCLog::HTTP, "HTTPResponse stream (status code: %d size: %lld) added to send buffer for client %s (id=%llu)",
+             status, headers.size() + body_size, m_client->m_origin, m_client->m_id);
 }
 
 CService HTTPRequest::GetPeer() const
@@ -984,9 +1147,15 @@ void HTTPServer::ThreadSocketHandler()
 void HTTPServer::MaybeDispatchRequestsFromClient(const std::shared_ptr<HTTPRemoteClient>& client) const
 {
     // Try reading (potentially multiple) HTTP requests from the buffer
-    while (!client->m_recv_buffer.empty()) {
+    while (!client->m_req_closing && !client->m_recv_buffer.empty()) {
         // Create a new request object and try to fill it with data from the receive buffer
         auto req = std::make_unique<HTTPRequest>(client);
+        // Requests, including the ones we fail to read, are replied to in the order they came in.
+        req->m_seq = client->m_next_req_seq;
+        const auto count_request{[&] {
+            ++client->m_next_req_seq;
+            ++client->m_req_pending;
+        }};
         try {
             // Stop reading if we need more data from the client to parse a complete request
             if (!client->ReadRequest(*req)) break;
@@ -998,6 +1167,7 @@ void HTTPServer::MaybeDispatchRequestsFromClient(const std::shared_ptr<HTTPRemot
                 client->m_id,
                 e.what());
 
+            count_request();
             req->WriteReply(HTTP_CONTENT_TOO_LARGE);
             client->m_disconnect = true;
             return;
@@ -1010,6 +1180,7 @@ void HTTPServer::MaybeDispatchRequestsFromClient(const std::shared_ptr<HTTPRemot
                 e.what());
 
             // We failed to read a complete request from the buffer
+            count_request();
             req->WriteReply(HTTP_BAD_REQUEST);
             client->m_disconnect = true;
             return;
@@ -1025,20 +1196,20 @@ void HTTPServer::MaybeDispatchRequestsFromClient(const std::shared_ptr<HTTPRemot
             client->m_id);
 
         // add request to client queue
+        count_request();
+        client->m_req_closing = !req->KeepAlive();
         client->m_req_queue.push_back(std::move(req));
     }
 
-    // If we are already handling a request from
-    // this client, do nothing. We'll check again on the next I/O
-    // loop iteration.
-    if (client->m_req_busy) return;
-
-    // Otherwise, if there is a pending request in the queue, handle it.
-    if (!client->m_req_queue.empty()) {
-        LOCK(m_request_dispatcher_mutex);
-        client->m_req_busy = true;
-        m_request_dispatcher(std::move(client->m_req_queue.front()));
+    // Hand queued requests to worker threads, as long as fewer than
+    // MAX_PIPELINED_REQUESTS of this client are being handled. We'll
+    // check again on the next I/O loop iteration.
+    while (!client->m_req_queue.empty() &&
+           client->m_req_pending - client->m_req_queue.size() < MAX_PIPELINED_REQUESTS) {
+        auto req{std::move(client->m_req_queue.front())};
         client->m_req_queue.pop_front();
+        LOCK(m_request_dispatcher_mutex);
+        m_request_dispatcher(std::move(req));
     }
 }
 
@@ -1054,7 +1225,7 @@ void HTTPServer::DisconnectClients()
                                         // thread keeping the socket open even after "disconnecting".
                                         const bool is_idle{m_rpcservertimeout.count() > 0 &&
                                                            now - client->m_idle_since.load() > m_rpcservertimeout &&
-                                                           !client->m_req_busy};
+                                                           client->m_req_pending == 0};
 
                                         // Disconnect this client due to error, end of communication, or idle timeout.
                                         // May drop unsent data if we are closing due to error.
@@ -1124,6 +1295,20 @@ bool HTTPRemoteClient::ReadRequest(HTTPRequest& req)
     return true;
 }
 
+bool HTTPRemoteClient::AppendPendingReplies()
+{
+    bool appended{false};
+    for (auto it{m_pending_replies.begin()};
+         it != m_pending_replies.end() && it->first == m_next_reply_seq;
+         it = m_pending_replies.erase(it)) {
+        m_send_buffer.insert(m_send_buffer.end(), it->second.data.begin(), it->second.data.end());
+        m_keep_alive = it->second.keep_alive;
+        ++m_next_reply_seq;
+        appended = true;
+    }
+    return appended;
+}
+
 bool HTTPRemoteClient::MaybeSendBytesFromBuffer()
 {
     // Send as much data from this client's buffer as we can
@@ -1166,6 +1351,7 @@ bool HTTPRemoteClient::MaybeSendBytesFromBuffer()
                     NetworkErrorString(err));
                 m_send_ready = false;
                 m_disconnect = true;
+                m_send_cv.notify_all();
 
                 // Do not attempt to read from this client.
                 return false;
@@ -1176,6 +1362,7 @@ bool HTTPRemoteClient::MaybeSendBytesFromBuffer()
         Assume(static_cast<size_t>(bytes_sent) <= m_send_buffer.size());
         m_send_buffer.erase(m_send_buffer.begin(),
                             m_send_buffer.begin() + bytes_sent);
+        m_send_cv.notify_all();
 
         LogDebug(
             BCLog::HTTP,
@@ -1189,7 +1376,8 @@ bool HTTPRemoteClient::MaybeSendBytesFromBuffer()
         // on an already-empty m_send_buffer because the connection might have just been opened.
         if (m_send_buffer.empty()) {
             m_send_ready = false;
-            m_connection_busy = false;
+            // Pipelined requests may still be in worker threads.
+            m_connection_busy = m_req_pending > 0;
 
             // Our work is done here
             if (!m_keep_alive) {
@@ -1309,4 +1497,9 @@ void StopHTTPServer()
     }
     LogDebug(BCLog::HTTP, "Stopped HTTP server");
 }
+
+ThreadPool& HTTPThreadPool()
+{
+    return g_threadpool_http;
+}
 } // namespace http_bitcoin
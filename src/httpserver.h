@@ -6,13 +6,16 @@
 #define BITCOIN_HTTPSERVER_H
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <netaddress.h>
@@ -25,6 +28,7 @@
 #include <util/threadinterrupt.h>
 #include <util/time.h>
 
+class ThreadPool;
 namespace util {
 class SignalInterrupt;
 } // namespace util
@@ -79,6 +83,38 @@ constexpr size_t MAX_HEADERS_SIZE{8192};
 //! Maximum size of an HTTP request body
 constexpr uint64_t MAX_BODY_SIZE{32_MiB};
 
+//! Maximum number of requests from a single client handled by worker threads at the same time.
+//! Further pipelined requests wait in the client's queue.
+constexpr size_t MAX_PIPELINED_REQUESTS{8};
+
+//! Response bodies smaller than this are never compressed.
+constexpr size_t MIN_COMPRESSED_BODY_SIZE{1024};
+
+//! A streamed reply waits for the client's send buffer to drain below this size before adding
+//! more to it, which bounds the memory a single streamed reply takes.
+constexpr size_t MAX_STREAM_BUFFER_SIZE{1_MiB};
+
+//! Result of producing the next piece of a streamed reply body, see HTTPRequest::WriteReplyStream().
+enum class StreamStatus {
+    MORE,   //!< More of the body follows.
+    DONE,   //!< This was the last piece of the body.
+    FAILED, //!< The body cannot be completed; the connection is closed without terminating it.
+};
+
+//! Content codings the server can apply to response bodies.
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE,
+};
+
+/**
+ * Choose the content coding for a response from the value of the request's
+ * Accept-Encoding header, preferring gzip over deflate.
+ * @returns ContentEncoding::IDENTITY if the client accepts neither.
+ */
+ContentEncoding NegotiateContentEncoding(std::string_view accept_encoding);
+
 //! Thrown when a request body exceeds MAX_BODY_SIZE (or *will* exceed, in chunked transfer)
 //! so the server can reply with more specific code 413 (content too large) vs general 400 (bad request)
 struct ContentTooLargeError : std::runtime_error {
@@ -156,6 +192,10 @@ public:
     HTTPHeaders m_headers;
     std::string m_body;
 
+    //! Position of this request among those received from the client, which is also
+    //! the position of its reply in what is sent back.
+    uint64_t m_seq{0};
+
     //! Pointer to the client that made the request so we know who to respond to.
     std::shared_ptr<HTTPRemoteClient> m_client;
 
@@ -186,6 +226,18 @@ public:
         WriteReply(status, std::as_bytes(std::span{reply_body_view}));
     }
 
+    /**
+     * Reply with a body that is produced piece by piece, so it never has to be held in memory
+     * as a whole. next_piece is called repeatedly with an empty buffer to append the next piece
+     * of the body to, until it returns something other than StreamStatus::MORE.
+     *
+     * HTTP/1.1 clients get the body with chunked transfer coding. HTTP/1.0 clients get it
+     * until the connection is closed. Bodies are never compressed. This blocks the calling
+     * worker thread until the whole body has been handed to the send buffer, waiting for
+     * the client to read the reply whenever more than MAX_STREAM_BUFFER_SIZE of it is buffered.
+     */
+    void WriteReplyStream(HTTPStatusCode status, const std::function<StreamStatus(std::vector<std::byte>&)>& next_piece);
+
     // These methods reimplement the API from http_libevent::HTTPRequest
     // for downstream JSONRPC and REST modules.
     std::string GetURI() const { return m_target; }
@@ -195,6 +247,9 @@ public:
     std::pair<bool, std::string> GetHeader(std::string_view hdr) const;
     std::string ReadBody() const { return m_body; }
     void WriteHeader(std::string&& hdr, std::string&& value);
+
+    //! Whether the connection stays open after the reply to this request.
+    bool KeepAlive() const;
 };
 
 class HTTPServer
@@ -463,15 +518,22 @@ public:
      */
     std::vector<std::byte> m_recv_buffer{};
 
-    //! Requests from a client must be processed in the order in which
-    //! they were received, blocking on a per-client basis. We won't
-    //! process the next request in the queue if we are currently busy
-    //! handling a previous request.
+    //! Requests read from the client that are not passed to a worker thread yet.
+    //! Up to MAX_PIPELINED_REQUESTS are handled at the same time; their replies
+    //! are sent in the order the requests were received.
     std::deque<std::unique_ptr<HTTPRequest>> m_req_queue;
 
-    //! Set to true by the I/O thread when a request is popped off
-    //! and passed to a worker thread, reset to false by the worker thread.
-    std::atomic_bool m_req_busy{false};
+    //! Sequence number for the next request read from the client. Only used in the I/O thread.
+    uint64_t m_next_req_seq{0};
+
+    //! Set by the I/O thread after reading a request whose reply closes the connection.
+    //! Anything the client sent after it is ignored.
+    bool m_req_closing{false};
+
+    //! Number of requests read from the client that have not been replied to yet, whether
+    //! queued or in a worker thread. Incremented by the I/O thread and decremented by
+    //! WriteReply() while holding m_send_mutex.
+    std::atomic<size_t> m_req_pending{0};
 
     /**
      * Response data destined for this client.
@@ -492,6 +554,26 @@ public:
     */
     bool m_send_ready GUARDED_BY(m_send_mutex){false};
 
+    //! A serialized reply and whether the connection stays open after it.
+    struct PendingReply {
+        std::vector<std::byte> data;
+        bool keep_alive;
+    };
+
+    /**
+     * Replies written by worker threads before all replies to earlier requests
+     * were, keyed by request sequence number. They are moved to m_send_buffer,
+     * in order, once the replies before them are.
+     */
+    /// @{
+    std::map<uint64_t, PendingReply> m_pending_replies GUARDED_BY(m_send_mutex);
+    uint64_t m_next_reply_seq GUARDED_BY(m_send_mutex){0};
+    /// @}
+
+    //! Notified when m_send_buffer shrinks or m_next_reply_seq advances, which
+    //! streamed replies wait for.
+    std::condition_variable m_send_cv;
+
     /**
      * Mutex that serializes the Send() and Recv() calls on `m_sock`. Reading
      * from the client occurs in the I/O thread but writing back to a client
@@ -517,7 +599,8 @@ public:
     std::atomic_bool m_connection_busy{true};
 
     //! Client has requested to keep the connection open after all requests have been responded to.
-    //! Set by (potentially multiple) worker threads and checked in the HTTPServer I/O loop.
+    //! Set by (potentially multiple) worker threads, in request order as their replies are
+    //! moved to the send buffer, and checked in the HTTPServer I/O loop.
     //! `m_keep_alive=true` can be overridden `by HTTPServer.m_disconnect_all_clients` (we disconnect).
     std::atomic_bool m_keep_alive{false};
 
@@ -552,6 +635,12 @@ public:
      * @returns false if we are done with this client and HTTPServer can skip the next read operation from it.
      */
     bool MaybeSendBytesFromBuffer() EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex, !m_sock_mutex);
+
+    /**
+     * Move the replies in m_pending_replies that are next in order to m_send_buffer.
+     * @returns whether any reply was moved.
+     */
+    bool AppendPendingReplies() EXCLUSIVE_LOCKS_REQUIRED(m_send_mutex);
 };
 
 /** Initialize HTTP server.
@@ -570,6 +659,10 @@ void InterruptHTTPServer();
 
 /** Stop HTTP server */
 void StopHTTPServer();
+
+/** The HTTP worker threads, for handlers that spread the work of a single request over several of
+ * them. It has no workers before StartHTTPServer and after StopHTTPServer. */
+ThreadPool& HTTPThreadPool();
 } // namespace http_bitcoin
 
 #endif // BITCOIN_HTTPSERVER_H
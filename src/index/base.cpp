@@ -114,7 +114,7 @@ bool BaseIndex::Init()
                              return &m_chain->context()->chainman->ValidatedChainstate());
     // Register to validation interface before setting the 'm_synced' flag, so that
     // callbacks are not missed once m_synced is true.
-    m_chain->context()->validation_signals->RegisterValidationInterface(this);
+    m_chain->context()->validation_signals->RegisterValidationInterface(this, m_thread_name);
 
     const auto locator{GetDB().ReadBestBlock()};
 
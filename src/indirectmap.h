@@ -6,6 +6,8 @@
 #define BITCOIN_INDIRECTMAP_H
 
 #include <map>
+#include <memory>
+#include <utility>
 
 template <class T>
 struct DereferencingComparator { bool operator()(const T a, const T b) const { return *a < *b; } };
@@ -20,17 +22,21 @@ struct DereferencingComparator { bool operator()(const T a, const T b) const { r
  * Objects pointed to by keys must not be modified in any way that changes the
  * result of DereferencingComparator.
  */
-template <class K, class T>
+template <class K, class T, class Allocator = std::allocator<std::pair<const K* const, T>>>
 class indirectmap {
 private:
-    typedef std::map<const K*, T, DereferencingComparator<const K*> > base;
+    typedef std::map<const K*, T, DereferencingComparator<const K*>, Allocator> base;
     base m;
 public:
+    typedef Allocator allocator_type;
     typedef typename base::iterator iterator;
     typedef typename base::const_iterator const_iterator;
     typedef typename base::size_type size_type;
     typedef typename base::value_type value_type;
 
+    indirectmap() = default;
+    explicit indirectmap(const allocator_type& alloc) : m(alloc) {}
+
     // passthrough (pointer interface)
     std::pair<iterator, bool> insert(const value_type& value) { return m.insert(value); }
 
@@ -53,6 +59,7 @@ public:
     const_iterator end() const      { return m.end(); }
     const_iterator cbegin() const   { return m.cbegin(); }
     const_iterator cend() const     { return m.cend(); }
+    allocator_type get_allocator() const { return m.get_allocator(); }
 };
 
 #endif // BITCOIN_INDIRECTMAP_H
@@ -94,6 +94,15 @@ public:
      * Interrupts the current wait for the next block template.
     */
     virtual void interruptWait() = 0;
+
+    /**
+     * Changes from the template waitNext() was called on to create this one,
+     * so clients can update their copy of it in place instead of fetching
+     * the whole block.
+     *
+     * @retval std::nullopt if this template was not created by waitNext().
+     */
+    virtual std::optional<node::BlockTemplateDiff> getDiff() = 0;
 };
 
 //! Interface giving clients (RPC, Stratum v2 Template Provider in the future)
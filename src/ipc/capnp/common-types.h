@@ -27,6 +27,7 @@
 #include <mp/type-struct.h>
 #include <mp/type-threadmap.h>
 #include <mp/type-vector.h>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -68,11 +69,15 @@ void CustomBuildField(TypeList<LocalType>, Priority<1>, InvokeContext& invoke_co
 // over more narrow overloads for specific LocalTypes.
 requires Serializable<LocalType, DataStream> && std::is_same_v<LocalType, std::remove_cv_t<std::remove_reference_t<LocalType>>>
 {
-    DataStream stream;
-    auto wrapper{ipc::capnp::Wrap(stream)};
+    // Serialize straight into the message buffer, after a first pass to
+    // compute its size, instead of copying from an intermediate stream.
+    SizeComputer sizer;
+    auto size_wrapper{ipc::capnp::Wrap(sizer)};
+    value.Serialize(size_wrapper);
+    auto result = output.init(sizer.size());
+    SpanWriter writer{std::as_writable_bytes(std::span{result.begin(), result.size()})};
+    auto wrapper{ipc::capnp::Wrap(writer)};
     value.Serialize(wrapper);
-    auto result = output.init(stream.size());
-    memcpy(result.begin(), stream.data(), stream.size());
 }
 
 //! Overload multiprocess library's CustomReadField hook to allow any object
@@ -4,6 +4,7 @@
 
 #include <kernel/context.h>
 
+#include <crypto/chacha20.h>
 #include <crypto/sha256.h>
 #include <random.h>
 #include <util/log.h>
@@ -18,6 +19,8 @@ Context::Context()
     std::call_once(globals_initialized, []() {
         std::string sha256_algo = SHA256AutoDetect();
         LogInfo("Using the '%s' SHA256 implementation\n", sha256_algo);
+        std::string chacha20_algo = ChaCha20AutoDetect();
+        LogInfo("Using the '%s' ChaCha20 implementation\n", chacha20_algo);
         RandomInit();
     });
 }
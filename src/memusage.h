@@ -147,6 +147,17 @@ static inline size_t IncrementalDynamicUsage(const indirectmap<X, Y>& m)
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X*, Y> >));
 }
 
+/**
+ * Usage of a PoolResource: all of its chunks, including the memory of freed elements, which the
+ * resource keeps on its freelists rather than returning it. The chunks are stored in a std::list,
+ * so each also costs a node of 3 pointers: next, previous, and a pointer to the chunk.
+ */
+template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+static inline size_t DynamicUsage(const PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& resource)
+{
+    return (MallocUsage(sizeof(void*) * 3) + MallocUsage(resource.ChunkSizeBytes())) * resource.NumAllocatedChunks();
+}
+
 template<typename X>
 static inline size_t DynamicUsage(const std::unique_ptr<X>& p)
 {
@@ -205,14 +216,7 @@ static inline size_t DynamicUsage(const std::unordered_map<Key,
                                                                          MAX_BLOCK_SIZE_BYTES,
                                                                          ALIGN_BYTES>>& m)
 {
-    auto* pool_resource = m.get_allocator().resource();
-
-    // The allocated chunks are stored in a std::list. Size per node should
-    // therefore be 3 pointers: next, previous, and a pointer to the chunk.
-    size_t estimated_list_node_size = MallocUsage(sizeof(void*) * 3);
-    size_t usage_resource = estimated_list_node_size * pool_resource->NumAllocatedChunks();
-    size_t usage_chunks = MallocUsage(pool_resource->ChunkSizeBytes()) * pool_resource->NumAllocatedChunks();
-    return usage_resource + usage_chunks + MallocUsage(sizeof(void*) * m.bucket_count());
+    return DynamicUsage(*m.get_allocator().resource()) + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
 } // namespace memusage
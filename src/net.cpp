@@ -30,6 +30,7 @@
 #include <scheduler.h>
 #include <util/fs.h>
 #include <util/overflow.h>
+#include <util/eventloop.h>
 #include <util/sock.h>
 #include <util/strencodings.h>
 #include <util/thread.h>
@@ -45,6 +46,7 @@
 #include <cstring>
 #include <functional>
 #include <optional>
+#include <stdexcept>
 #include <string_view>
 #include <unordered_map>
 
@@ -643,6 +645,7 @@ void CNode::CopyStats(CNodeStats& stats)
         LOCK(cs_vSend);
         X(mapSendBytesPerMsgType);
         X(nSendBytes);
+        X(m_send_calls);
     }
     {
         LOCK(cs_vRecv);
@@ -1608,8 +1611,8 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
 {
     auto it = node.vSendMsg.begin();
     size_t nSentSize = 0;
-    bool data_left{false}; //!< second return value (whether unsent data remains)
     std::optional<bool> expected_more;
+    std::vector<uint8_t>& staging{node.m_send_staging};
 
     while (true) {
         if (it != node.vSendMsg.end()) {
@@ -1628,36 +1631,79 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
         // bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
         // verify that the previously returned 'more' was correct.
         if (expected_more.has_value()) Assume(!data.empty() == *expected_more);
-        expected_more = more;
-        data_left = !data.empty(); // will be overwritten on next loop if all of data gets sent
-        int nBytes = 0;
-        if (!data.empty()) {
-            LOCK(node.m_sock_mutex);
+        expected_more.reset();
+        if (data.empty() && staging.empty()) break;
+
+        {
             // There is no socket in case we've already disconnected, or in test cases without
             // real connections. In these cases, we bail out immediately and just leave things
             // in the send queue and transport.
-            if (!node.m_sock) {
-                break;
-            }
+            LOCK(node.m_sock_mutex);
+            if (!node.m_sock) break;
+        }
+
+        // Small pieces (message headers, inv, tx, ...) are collected in the staging buffer so
+        // several of them go out with one system call. Larger ones are sent straight from the
+        // transport, after anything already staged.
+        //
+        // The transport only hands out its next piece once the current one is marked as sent, so
+        // staged bytes are marked when copied, but only accounted for once the socket accepted
+        // them. Nothing is staged before a v1 header's worth of bytes has actually been sent, as
+        // V2Transport::ShouldReconnectV1() relies on what it was told has been sent.
+        const bool fits{!data.empty() && node.nSendBytes >= CMessageHeader::HEADER_SIZE &&
+                        staging.size() + data.size() <= SEND_COALESCE_BYTES};
+        if (fits) {
+            staging.insert(staging.end(), data.begin(), data.end());
+            node.m_send_staged_msg_types.emplace_back(msg_type, data.size());
+            node.m_transport->MarkBytesSent(data.size());
+            expected_more = more;
+            if (more) continue;
+        }
+        const bool send_staged{!staging.empty()};
+        const std::span<const uint8_t> to_send{send_staged ? std::span<const uint8_t>{staging} : data};
+        // More follows the staged bytes if a piece did not fit behind them.
+        const bool more_after{send_staged ? !fits && !data.empty() : more};
+
+        int nBytes = 0;
+        {
+            LOCK(node.m_sock_mutex);
+            if (!node.m_sock) break;
             int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
 #ifdef MSG_MORE
-            if (more) {
+            if (more_after) {
                 flags |= MSG_MORE;
             }
 #endif
-            nBytes = node.m_sock->Send(data.data(), data.size(), flags);
+            nBytes = node.m_sock->Send(to_send.data(), to_send.size(), flags);
+            ++node.m_send_calls;
         }
         if (nBytes > 0) {
             node.m_last_send = NodeClock::now();
             node.nSendBytes += nBytes;
-            // Notify transport that bytes have been processed.
-            node.m_transport->MarkBytesSent(nBytes);
-            // Update statistics per message type.
-            if (!msg_type.empty()) { // don't report v2 handshake bytes for now
-                node.AccountForSentBytes(msg_type, nBytes);
-            }
             nSentSize += nBytes;
-            if ((size_t)nBytes != data.size()) {
+            const bool all_sent{(size_t)nBytes == to_send.size()};
+            if (send_staged) {
+                staging.erase(staging.begin(), staging.begin() + nBytes);
+                // Update statistics per message type for the staged pieces that went out.
+                for (size_t left{size_t(nBytes)}; left > 0;) {
+                    auto& [staged_type, staged_size]{node.m_send_staged_msg_types.front()};
+                    const size_t accounted{std::min(left, staged_size)};
+                    if (!staged_type.empty()) { // don't report v2 handshake bytes for now
+                        node.AccountForSentBytes(staged_type, accounted);
+                    }
+                    left -= accounted;
+                    staged_size -= accounted;
+                    if (staged_size == 0) node.m_send_staged_msg_types.pop_front();
+                }
+            } else {
+                // Notify transport that bytes have been processed.
+                node.m_transport->MarkBytesSent(nBytes);
+                if (!msg_type.empty()) {
+                    node.AccountForSentBytes(msg_type, nBytes);
+                }
+                if (all_sent) expected_more = more;
+            }
+            if (!all_sent) {
                 // could not send full message; stop sending more
                 break;
             }
@@ -1674,7 +1720,10 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
         }
     }
 
-    node.fPauseSend = node.m_send_memusage + node.m_transport->GetSendMemoryUsage() > nSendBufferMaxSize;
+    // whether unsent data remains
+    const bool data_left{!staging.empty() || !std::get<0>(node.m_transport->GetBytesToSend(it != node.vSendMsg.end())).empty()};
+
+    node.fPauseSend = node.m_send_memusage + staging.size() + node.m_transport->GetSendMemoryUsage() > nSendBufferMaxSize;
 
     if (it == node.vSendMsg.end()) {
         assert(node.m_send_memusage == 0);
@@ -2101,7 +2150,7 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
             // once a potential message from vSendMsg is handed to the transport. GetBytesToSend
             // determines both of these in a single call.
             const auto& [to_send, more, _msg_type] = pnode->m_transport->GetBytesToSend(!pnode->vSendMsg.empty());
-            select_send = !to_send.empty() || more;
+            select_send = !pnode->m_send_staging.empty() || !to_send.empty() || more;
         }
         if (!select_recv && !select_send) continue;
 
@@ -2115,6 +2164,17 @@ Sock::EventsPerSock CConnman::GenerateWaitSockets(std::span<CNode* const> nodes)
     return events_per_sock;
 }
 
+void CConnman::InitEventLoop(SocketEventsMode mode)
+{
+    try {
+        m_event_loop = MakeEventLoop(mode);
+    } catch (const std::runtime_error& e) {
+        LogWarning("Unable to use -socketevents=%s (%s), falling back to %s",
+                   SocketEventsModeToString(mode), e.what(), SocketEventsModeToString(SocketEventsMode::WAIT_MANY));
+        m_event_loop = MakeEventLoop(SocketEventsMode::WAIT_MANY);
+    }
+}
+
 void CConnman::SocketHandler()
 {
     AssertLockNotHeld(m_nodes_mutex);
@@ -2132,7 +2192,7 @@ void CConnman::SocketHandler()
         // select(2)). If none are ready, wait for a short while and return
         // empty sets.
         events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        if (!m_event_loop->Wait(timeout, events_per_sock)) {
             m_interrupt_net->sleep_for(timeout);
         }
 
@@ -3196,6 +3256,8 @@ void CConnman::ThreadMessageHandler()
 
     LOCK(NetEventsInterface::g_msgproc_mutex);
 
+    // Whether this iteration was triggered by an event rather than by the polling timeout.
+    bool woken{true};
     while (!flagInterruptMsgProc)
     {
         bool fMoreWork = false;
@@ -3215,8 +3277,10 @@ void CConnman::ThreadMessageHandler()
                 fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
                 if (flagInterruptMsgProc)
                     return;
-                // Send messages
-                m_msgproc->SendMessages(*pnode);
+                // Send messages. On polling iterations only peers with timed work due need this.
+                if (woken || fMoreNodeWork || m_msgproc->SendMessagesDue(*pnode)) {
+                    m_msgproc->SendMessages(*pnode);
+                }
 
                 if (flagInterruptMsgProc)
                     return;
@@ -3227,6 +3291,7 @@ void CConnman::ThreadMessageHandler()
         if (!fMoreWork) {
             condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return fMsgProcWake; });
         }
+        woken = fMoreWork || fMsgProcWake;
         fMsgProcWake = false;
     }
 }
@@ -4175,11 +4240,11 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         // give it a message to send.
         const auto& [to_send, more, _msg_type] =
             pnode->m_transport->GetBytesToSend(/*have_next_message=*/true);
-        const bool queue_was_empty{to_send.empty() && pnode->vSendMsg.empty()};
+        const bool queue_was_empty{to_send.empty() && pnode->vSendMsg.empty() && pnode->m_send_staging.empty()};
 
         // Update memory usage of send buffer.
         pnode->m_send_memusage += msg.GetMemoryUsage();
-        if (pnode->m_send_memusage + pnode->m_transport->GetSendMemoryUsage() > nSendBufferMaxSize) pnode->fPauseSend = true;
+        if (pnode->m_send_memusage + pnode->m_send_staging.size() + pnode->m_transport->GetSendMemoryUsage() > nSendBufferMaxSize) pnode->fPauseSend = true;
         // Move message to vSendMsg queue.
         pnode->vSendMsg.push_back(std::move(msg));
 
@@ -30,6 +30,7 @@
 #include <sync.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/eventloop.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
 
@@ -97,9 +98,19 @@ static constexpr bool DEFAULT_DNSSEED{true};
 static constexpr bool DEFAULT_FIXEDSEEDS{true};
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
+/** Outgoing data pieces up to this size are copied into a per-peer buffer and
+ *  handed to the socket together, instead of with one system call each. */
+static constexpr size_t SEND_COALESCE_BYTES{16 * 1024};
 
 static constexpr bool DEFAULT_V2_TRANSPORT{true};
 
+/** Default for -socketevents. */
+#ifdef USE_EPOLL
+static constexpr SocketEventsMode DEFAULT_SOCKET_EVENTS_MODE{SocketEventsMode::EPOLL};
+#else
+static constexpr SocketEventsMode DEFAULT_SOCKET_EVENTS_MODE{SocketEventsMode::WAIT_MANY};
+#endif
+
 typedef int64_t NodeId;
 
 struct AddedNodeParams {
@@ -206,6 +217,7 @@ public:
     // Peer requested high bandwidth connection
     bool m_bip152_highbandwidth_from;
     uint64_t nSendBytes;
+    uint64_t m_send_calls;
     mapMsgTypeSize mapSendBytesPerMsgType;
     uint64_t nRecvBytes;
     mapMsgTypeSize mapRecvBytesPerMsgType;
@@ -702,6 +714,14 @@ public:
     uint64_t nSendBytes GUARDED_BY(cs_vSend){0};
     /** Messages still to be fed to m_transport->SetMessageToSend. */
     std::deque<CSerializedNetMsg> vSendMsg GUARDED_BY(cs_vSend);
+    /** Bytes already taken from m_transport, but not yet accepted by the socket
+     *  (see CConnman::SocketSendData). Its capacity is kept between sends. */
+    std::vector<uint8_t> m_send_staging GUARDED_BY(cs_vSend);
+    /** Message type and size of the pieces in m_send_staging, in order. They are accounted for in
+     *  mapSendBytesPerMsgType as the socket accepts them. */
+    std::deque<std::pair<std::string, size_t>> m_send_staged_msg_types GUARDED_BY(cs_vSend);
+    /** Number of send system calls made to this peer's socket. */
+    uint64_t m_send_calls GUARDED_BY(cs_vSend){0};
     Mutex cs_vSend;
     Mutex m_sock_mutex;
     Mutex cs_vRecv;
@@ -1070,6 +1090,14 @@ public:
      */
     virtual bool SendMessages(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
 
+    /**
+     * Whether SendMessages() has anything to do for a given node that only the passing of time
+     * could have caused. Message handler iterations that no event woke up call SendMessages()
+     * only for nodes where this returns true.
+     *
+     * @param[in]   node            The node which we would send messages to.
+     */
+    virtual bool SendMessagesDue(const CNode& node) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex) = 0;
 
 protected:
     /**
@@ -1110,6 +1138,7 @@ public:
         bool whitelist_forcerelay = DEFAULT_WHITELISTFORCERELAY;
         bool whitelist_relay = DEFAULT_WHITELISTRELAY;
         bool m_capture_messages = false;
+        SocketEventsMode socket_events_mode = SocketEventsMode::WAIT_MANY;
     };
 
     void Init(const Options& connOptions) EXCLUSIVE_LOCKS_REQUIRED(!m_added_nodes_mutex, !m_total_bytes_sent_mutex)
@@ -1148,6 +1177,7 @@ public:
         whitelist_forcerelay = connOptions.whitelist_forcerelay;
         whitelist_relay = connOptions.whitelist_relay;
         m_capture_messages = connOptions.m_capture_messages;
+        InitEventLoop(connOptions.socket_events_mode);
     }
 
     // test only
@@ -1490,6 +1520,9 @@ private:
      */
     Sock::EventsPerSock GenerateWaitSockets(std::span<CNode* const> nodes);
 
+    /** (Re)create m_event_loop, falling back to `SocketEventsMode::WAIT_MANY` on failure. */
+    void InitEventLoop(SocketEventsMode mode);
+
     /**
      * Check connected and listening sockets for IO readiness and process them accordingly.
      */
@@ -1750,6 +1783,9 @@ private:
      */
     std::unique_ptr<i2p::sam::Session> m_i2p_sam_session;
 
+    /** Waits for socket readiness in SocketHandler(). Only used by threadSocketHandler. */
+    std::unique_ptr<EventLoop> m_event_loop{std::make_unique<WaitManyEventLoop>()};
+
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
@@ -30,6 +30,7 @@
 #include <netaddress.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
+#include <node/blockdownloadstats.h>
 #include <node/blockstorage.h>
 #include <node/connection_types.h>
 #include <node/protocol_version.h>
@@ -58,7 +59,9 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/time.h>
+#include <util/timingwheel.h>
 #include <util/trace.h>
 #include <validation.h>
 
@@ -70,7 +73,6 @@
 #include <deque>
 #include <exception>
 #include <functional>
-#include <future>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
@@ -126,8 +128,11 @@ static const unsigned int MAX_LOCATOR_SZ = 101;
 static const unsigned int MAX_INV_SZ = 50000;
 /** Limit to avoid sending big packets. Not used in processing incoming GETDATA for compatibility */
 static const unsigned int MAX_GETDATA_SZ = 1000;
-/** Number of blocks that can be requested at any given time from a single peer. */
-static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
+/** Number of blocks that can be requested at any given time from a single peer, outside of the
+ *  main block download loop, which sizes it per peer (see node::BlockDownloadStats). */
+static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = node::DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER;
+/** Number of peers a block holding back the download window may be requested from at once. */
+static constexpr size_t MAX_PARALLEL_DOWNLOADS_PER_BLOCK{2};
 /** Default time during which a peer must stall block download progress before being disconnected.
  * the actual timeout is increased temporarily if peers are disconnected for hitting the timeout */
 static constexpr auto BLOCK_STALLING_TIMEOUT_DEFAULT{2s};
@@ -180,6 +185,11 @@ static_assert(INVENTORY_BROADCAST_MAX <= node::MAX_PEER_TX_ANNOUNCEMENTS, "INVEN
 static constexpr auto AVG_FEEFILTER_BROADCAST_INTERVAL{10min};
 /** Maximum feefilter broadcast delay after significant change. */
 static constexpr auto MAX_FEEFILTER_CHANGE_DELAY{5min};
+/** Granularity of the per-peer SendMessages() deadlines (ping, addr, inv and feefilter timers). */
+static constexpr auto SEND_TIMER_RESOLUTION{10ms};
+/** Longest (real) time a peer goes without SendMessages(), which covers the timeouts that have no
+ *  deadline of their own (block download, stalling, headers sync, reconciliation requests). */
+static constexpr auto SEND_MESSAGES_MAX_IDLE{1s};
 /** Maximum number of compact filters that may be requested with one getcfilters. See BIP 157. */
 static constexpr uint32_t MAX_GETCFILTERS_SIZE = 1000;
 /** Maximum number of cf hashes that may be requested with one getcfheaders. See BIP 157. */
@@ -208,6 +218,8 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the block was requested. */
+    std::chrono::microseconds m_requested{0us};
 };
 
 /**
@@ -390,6 +402,15 @@ struct Peer {
     Mutex m_getdata_requests_mutex;
     /** Work queue of items requested by this peer **/
     std::deque<CInv> m_getdata_requests GUARDED_BY(m_getdata_requests_mutex);
+    /** Set while a block requested by this peer is being sent by m_block_serve_pool. Nothing
+     *  else is processed or sent for the peer until it is cleared, so responses stay in order. */
+    std::atomic<bool> m_block_serve_in_flight{false};
+
+    /** Set when SendMessages() must run on the next message handler iteration, even one no
+     *  event woke up: a message was processed or one of the peer's timers expired. */
+    bool m_send_due GUARDED_BY(NetEventsInterface::g_msgproc_mutex){true};
+    /** When SendMessages() last ran for this peer. */
+    std::chrono::steady_clock::time_point m_last_send_messages GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
 
     /** Time of the last getheaders message to this peer */
     NodeClock::time_point m_last_getheaders_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
@@ -450,6 +471,10 @@ struct CNodeState {
     std::list<QueuedBlock> vBlocksInFlight;
     //! When the first entry in vBlocksInFlight started downloading. Don't care when vBlocksInFlight is empty.
     std::chrono::microseconds m_downloading_since{0us};
+    //! How quickly this peer has been delivering the blocks we requested.
+    node::BlockDownloadStats m_block_download;
+    //! The number of blocks we were last willing to have in flight from this peer.
+    int m_max_blocks_in_flight{MAX_BLOCKS_IN_TRANSIT_PER_PEER};
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload{false};
     /** Whether this peer wants invs or cmpctblocks (when possible) for block announcements. */
@@ -527,6 +552,8 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex);
     bool SendMessages(CNode& node) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, g_msgproc_mutex, !m_tx_download_mutex);
+    bool SendMessagesDue(const CNode& node) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, g_msgproc_mutex, !m_tx_download_mutex);
 
     /** Implement PeerManager */
     void StartScheduledTasks(CScheduler& scheduler) override;
@@ -663,7 +690,7 @@ private:
      * announcements for blocks interacting with the 2hr (MAX_FUTURE_BLOCK_TIME) rule). */
     void HandleUnconnectingHeaders(CNode& pfrom, Peer& peer, const std::vector<CBlockHeader>& headers) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
     /** Return true if the headers connect to each other, false otherwise */
-    bool CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers) const;
+    bool CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers, std::span<const uint256> hashes) const;
     /** Try to continue a low-work headers sync that has already begun.
      * Assumes the caller has already verified the headers connect, and has
      * checked that each header satisfies the proof-of-work target included in
@@ -784,9 +811,22 @@ private:
      */
     Mutex m_tx_download_mutex ACQUIRED_BEFORE(m_mempool.cs);
     node::TxDownloadManager m_txdownloadman GUARDED_BY(m_tx_download_mutex);
+    /** Set when a response, an orphan or a disconnection may have made a transaction requestable from
+     *  another peer, which NextRequestTime() does not cover. Wakes up SendMessages() for all peers. */
+    bool m_tx_requests_reselected GUARDED_BY(m_tx_download_mutex){false};
 
     std::unique_ptr<TxReconciliationTracker> m_txreconciliation;
 
+    /** Next deadline of each peer's periodic SendMessages() work, see ScheduleSendTimer(). */
+    TimingWheel<NodeId> m_send_timers GUARDED_BY(NetEventsInterface::g_msgproc_mutex){SEND_TIMER_RESOLUTION};
+
+    /** Put the earliest of the peer's ping, addr, inv and feefilter deadlines into m_send_timers. */
+    void ScheduleSendTimer(const CNode& node, Peer& peer) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+
+    /** The body of SendMessages(), for a peer that exists. */
+    bool SendMessagesToPeer(CNode& node, Peer& peer)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, g_msgproc_mutex, !m_tx_download_mutex);
+
     /** The height of the best chain */
     std::atomic<int> m_best_height{-1};
     /** The time of the best chain tip block */
@@ -873,6 +913,11 @@ private:
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> m_most_recent_compact_block GUARDED_BY(m_most_recent_block_mutex);
     uint256 m_most_recent_block_hash GUARDED_BY(m_most_recent_block_mutex);
     std::unique_ptr<const std::map<GenTxid, CTransactionRef>> m_most_recent_block_txs GUARDED_BY(m_most_recent_block_mutex);
+    /** Serialized announcements of m_most_recent_block, built once and copied to every peer
+     *  instead of re-serializing per peer: the cmpctblock message, and the headers message
+     *  carrying only its header. */
+    std::shared_ptr<const CSerializedNetMsg> m_most_recent_cmpctblock_msg GUARDED_BY(m_most_recent_block_mutex);
+    std::shared_ptr<const CSerializedNetMsg> m_most_recent_headers_msg GUARDED_BY(m_most_recent_block_mutex);
 
     // Data about the low-work headers synchronization, aggregated from all peers' HeadersSyncStates.
     /** Mutex guarding the other m_headers_presync_* variables. */
@@ -916,6 +961,13 @@ private:
      */
     bool BlockRequested(NodeId nodeid, const CBlockIndex& block, std::list<QueuedBlock>::iterator** pit = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Update the download statistics of a peer that delivered a block we requested from it. */
+    void BlockDelivered(NodeId nodeid, const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** Whether a block that is in flight from other peers, and holds back the download window, should
+     *  also be requested from this peer because it is likely to deliver it sooner. */
+    bool ShouldRequestStuckBlock(const Peer& peer, const CNodeState& state, const CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     bool TipMayBeStale() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     /** Update pindexLastCommonBlock and add not-in-flight missing successors to vBlocks, until it has
@@ -962,12 +1014,15 @@ private:
     /** When our tip was last updated. */
     std::atomic<std::chrono::seconds> m_last_tip_update{0s};
 
+    /** Announce transactions to a peer by inv at the end of a reconciliation round. */
+    void AnnounceReconciledTxs(CNode& node, Peer& peer, std::span<const Wtxid> wtxids);
+
     /** Determine whether or not a peer can request a transaction, and return it (or nullptr if not found or not allowed). */
     CTransactionRef FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, !tx_relay.m_tx_inventory_mutex);
 
     void ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
         LOCKS_EXCLUDED(::cs_main);
 
     /** Process a new block. Perform any post-processing housekeeping */
@@ -1029,7 +1084,23 @@ private:
     bool BlockRequestAllowed(const CBlockIndex& block_index) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
-        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_peer_mutex, !m_most_recent_block_mutex);
+
+    /**
+     * Hand reading a (witness) block from disk and sending it to the peer to
+     * m_block_serve_pool. The peer's other messages wait until it is sent.
+     * @return false if the pool is not running and the caller has to send the block itself.
+     */
+    bool ServeBlockFromDiskAsync(CNode& pfrom, const CInv& inv, const CBlockIndex& index, FlatFilePos block_pos, const uint256& tip_hash)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
+
+    /** Read a (witness) block from disk and send it to the peer, followed by a continuation inv if due. */
+    void SendBlockFromDisk(CNode& pfrom, Peer& peer, const CInv& inv, const CBlockIndex& index, FlatFilePos block_pos, const uint256& tip_hash)
+        EXCLUSIVE_LOCKS_REQUIRED(!peer.m_block_inv_mutex);
+
+    /** Send an inv for our tip if the peer's getblocks batch ends at the block just sent. */
+    void MaybeSendContinuationInv(CNode& pfrom, Peer& peer, const uint256& block_hash, const uint256& tip_hash)
+        EXCLUSIVE_LOCKS_REQUIRED(!peer.m_block_inv_mutex);
 
     /**
      * Validation logic for compact filters request handling.
@@ -1105,6 +1176,10 @@ private:
 
     /// The transactions to be broadcast privately.
     PrivateBroadcast m_tx_for_private_broadcast;
+
+    /** Workers for ServeBlockFromDiskAsync(). Declared last, so it is stopped
+     *  before anything its tasks use is destroyed. */
+    ThreadPool m_block_serve_pool{"blkserve"};
 };
 
 const CNodeState* PeerManagerImpl::State(NodeId pnode) const
@@ -1268,7 +1343,7 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     RemoveBlockRequest(hash, nodeid);
 
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr)});
+            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr), GetTime<std::chrono::microseconds>()});
     if (state->vBlocksInFlight.size() == 1) {
         // We're starting a block download (batch) from this peer.
         state->m_downloading_since = GetTime<std::chrono::microseconds>();
@@ -1281,6 +1356,37 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     return true;
 }
 
+void PeerManagerImpl::BlockDelivered(NodeId nodeid, const uint256& hash)
+{
+    for (auto range = mapBlocksInFlight.equal_range(hash); range.first != range.second; range.first++) {
+        const auto& [node_id, list_it]{range.first->second};
+        if (node_id != nodeid) continue;
+        CNodeState& state = *Assert(State(node_id));
+        state.m_block_download.BlockReceived(list_it->m_requested, GetTime<std::chrono::microseconds>());
+        return;
+    }
+}
+
+bool PeerManagerImpl::ShouldRequestStuckBlock(const Peer& peer, const CNodeState& state, const CBlockIndex& block)
+{
+    // Only peers that have shown how quickly they deliver blocks qualify.
+    const auto latency{state.m_block_download.Latency()};
+    if (!latency) return false;
+
+    auto range = mapBlocksInFlight.equal_range(block.GetBlockHash());
+    if (size_t(std::distance(range.first, range.second)) >= MAX_PARALLEL_DOWNLOADS_PER_BLOCK) return false;
+    const auto now{GetTime<std::chrono::microseconds>()};
+    for (; range.first != range.second; range.first++) {
+        const auto& [node_id, list_it]{range.first->second};
+        if (node_id == peer.m_id) return false;
+        // Compact block downloads are short-lived and handled separately.
+        if (list_it->partialBlock) return false;
+        const auto in_flight{now - list_it->m_requested};
+        if (!Assert(State(node_id))->m_block_download.IsStuck(in_flight) || *latency >= in_flight) return false;
+    }
+    return true;
+}
+
 void PeerManagerImpl::MaybeSetPeerAsAnnouncingHeaderAndIDs(NodeId nodeid)
 {
     AssertLockHeld(cs_main);
@@ -1527,6 +1633,16 @@ void PeerManagerImpl::FindNextBlocks(std::vector<const CBlockIndex*>& vBlocks, c
                 if (waitingfor == -1) {
                     // This is the first already-in-flight block.
                     waitingfor = mapBlocksInFlight.lower_bound(pindex->GetBlockHash())->second.first;
+                    // It holds back the download window for every peer. If it is taking far longer
+                    // than usual, also ask this peer, rather than waiting for the stalling timeout.
+                    if (nodeStaller && ShouldRequestStuckBlock(peer, *state, *pindex)) {
+                        LogDebug(BCLog::NET, "Block %s (%d) is stuck at peer=%d, also requesting it from peer=%d\n",
+                                 pindex->GetBlockHash().ToString(), pindex->nHeight, waitingfor, peer.m_id);
+                        vBlocks.push_back(pindex);
+                        if (vBlocks.size() == count) {
+                            return;
+                        }
+                    }
                 }
                 continue;
             }
@@ -1688,6 +1804,10 @@ void PeerManagerImpl::ReattemptPrivateBroadcast(CScheduler& scheduler)
 void PeerManagerImpl::FinalizeNode(const CNode& node)
 {
     NodeId nodeid = node.GetId();
+    // A block being sent from m_block_serve_pool still uses the CNode, which
+    // is about to be deleted. Wait for it before taking cs_main, which the
+    // task may need.
+    if (PeerRef peer{GetPeerRef(nodeid)}) peer->m_block_serve_in_flight.wait(true);
     {
     LOCK(cs_main);
     {
@@ -1721,6 +1841,7 @@ void PeerManagerImpl::FinalizeNode(const CNode& node)
     {
         LOCK(m_tx_download_mutex);
         m_txdownloadman.DisconnectedPeer(nodeid);
+        m_tx_requests_reselected = true;
     }
     if (m_txreconciliation) m_txreconciliation->ForgetPeer(nodeid);
     m_num_preferred_download_peers -= state->fPreferredDownload;
@@ -1822,6 +1943,10 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
             if (queue.pindex)
                 stats.vHeightInFlight.push_back(queue.pindex->nHeight);
         }
+        stats.m_max_blocks_in_flight = state->m_max_blocks_in_flight;
+        stats.m_blocks_received = state->m_block_download.BlocksReceived();
+        stats.m_block_latency = state->m_block_download.Latency();
+        stats.m_block_transfer_time = state->m_block_download.TransferTime();
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -1877,6 +2002,7 @@ PeerManagerInfo PeerManagerImpl::GetInfo() const
         .median_outbound_time_offset = m_outbound_time_offsets.Median(),
         .ignores_incoming_txs = m_opts.ignore_incoming_txs,
         .private_broadcast = m_opts.private_broadcast,
+        .txreconciliation = m_txreconciliation ? std::make_optional(m_txreconciliation->GetStats()) : std::nullopt,
     };
 }
 
@@ -2052,6 +2178,9 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+    if (opts.block_serve_threads > 0) {
+        m_block_serve_pool.Start(opts.block_serve_threads);
+    }
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -2135,6 +2264,9 @@ void PeerManagerImpl::BlockDisconnected(const std::shared_ptr<const CBlock> &blo
 void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock)
 {
     auto pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs>(*pblock, FastRandomContext().rand64());
+    auto cmpctblock_msg{std::make_shared<const CSerializedNetMsg>(NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock))};
+    auto headers_msg{std::make_shared<const CSerializedNetMsg>(
+        NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(std::vector<CBlock>{CBlock{pcmpctblock->header}})))};
 
     LOCK(cs_main);
 
@@ -2145,8 +2277,6 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
     if (!DeploymentActiveAt(*pindex, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return;
 
     uint256 hashBlock(pblock->GetHash());
-    const std::shared_future<CSerializedNetMsg> lazy_ser{
-        std::async(std::launch::deferred, [&] { return NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock); })};
 
     {
         auto most_recent_block_txs = std::make_unique<std::map<GenTxid, CTransactionRef>>();
@@ -2160,9 +2290,11 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
         m_most_recent_block = pblock;
         m_most_recent_compact_block = pcmpctblock;
         m_most_recent_block_txs = std::move(most_recent_block_txs);
+        m_most_recent_cmpctblock_msg = cmpctblock_msg;
+        m_most_recent_headers_msg = std::move(headers_msg);
     }
 
-    m_connman.ForEachNode([this, pindex, &lazy_ser, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    m_connman.ForEachNode([this, pindex, &cmpctblock_msg, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
 
         if (pnode->GetCommonVersion() < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect)
@@ -2176,8 +2308,7 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
             LogDebug(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerManager::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
 
-            const CSerializedNetMsg& ser_cmpctblock{lazy_ser.get()};
-            PushMessage(*pnode, ser_cmpctblock.Copy());
+            PushMessage(*pnode, cmpctblock_msg->Copy());
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -2367,10 +2498,12 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
 {
     std::shared_ptr<const CBlock> a_recent_block;
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
+    std::shared_ptr<const CSerializedNetMsg> a_recent_cmpctblock_msg;
     {
         LOCK(m_most_recent_block_mutex);
         a_recent_block = m_most_recent_block;
         a_recent_compact_block = m_most_recent_compact_block;
+        a_recent_cmpctblock_msg = m_most_recent_cmpctblock_msg;
     }
 
     bool need_activate_chain = false;
@@ -2441,6 +2574,10 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     std::shared_ptr<const CBlock> pblock;
     if (a_recent_block && a_recent_block->GetHash() == inv.hash) {
         pblock = a_recent_block;
+    } else if ((inv.IsMsgBlk() || inv.IsMsgWitnessBlk()) &&
+               ServeBlockFromDiskAsync(pfrom, inv, *pindex, block_pos, tip->GetBlockHash())) {
+        // Read and sent from the block serve pool, including any continuation inv.
+        return;
     } else if (inv.IsMsgWitnessBlk()) {
         // Fast-path: in this case it is possible to serve the block directly from disk,
         // as the network format matches the format on disk
@@ -2505,7 +2642,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
             // instead we respond with the full, non-compact block.
             if (can_direct_fetch && pindex->nHeight >= tip->nHeight - MAX_CMPCTBLOCK_DEPTH) {
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == inv.hash) {
-                    MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
+                    PushMessage(pfrom, a_recent_cmpctblock_msg->Copy());
                 } else {
                     CBlockHeaderAndShortTxIDs cmpctblock{*pblock, m_rng.rand64()};
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, cmpctblock);
@@ -2516,19 +2653,80 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         }
     }
 
-    {
-        LOCK(peer.m_block_inv_mutex);
-        // Trigger the peer node to send a getblocks request for the next batch of inventory
-        if (inv.hash == peer.m_continuation_block) {
-            // Send immediately. This must send even if redundant,
-            // and we want it right after the last block so they don't
-            // wait for other stuff first.
-            std::vector<CInv> vInv;
-            vInv.emplace_back(MSG_BLOCK, tip->GetBlockHash());
-            MakeAndPushMessage(pfrom, NetMsgType::INV, vInv);
-            peer.m_continuation_block.SetNull();
+    MaybeSendContinuationInv(pfrom, peer, inv.hash, tip->GetBlockHash());
+}
+
+void PeerManagerImpl::MaybeSendContinuationInv(CNode& pfrom, Peer& peer, const uint256& block_hash, const uint256& tip_hash)
+{
+    LOCK(peer.m_block_inv_mutex);
+    // Trigger the peer node to send a getblocks request for the next batch of inventory
+    if (block_hash == peer.m_continuation_block) {
+        // Send immediately. This must send even if redundant,
+        // and we want it right after the last block so they don't
+        // wait for other stuff first.
+        std::vector<CInv> vInv;
+        vInv.emplace_back(MSG_BLOCK, tip_hash);
+        MakeAndPushMessage(pfrom, NetMsgType::INV, vInv);
+        peer.m_continuation_block.SetNull();
+    }
+}
+
+bool PeerManagerImpl::ServeBlockFromDiskAsync(CNode& pfrom, const CInv& inv, const CBlockIndex& index, FlatFilePos block_pos, const uint256& tip_hash)
+{
+    PeerRef peer{GetPeerRef(pfrom.GetId())};
+    if (!peer) return false;
+
+    // ProcessGetData() does not get here while a block is in flight for the peer.
+    if (!Assume(!peer->m_block_serve_in_flight)) return false;
+
+    // Keep the CNode around while the task runs (see CConnman::DisconnectNodes).
+    pfrom.AddRef();
+    peer->m_block_serve_in_flight = true;
+    auto submitted{m_block_serve_pool.Submit([this, &pfrom, peer, inv, &index, block_pos, tip_hash] {
+        try {
+            SendBlockFromDisk(pfrom, *peer, inv, index, block_pos, tip_hash);
+        } catch (const std::exception& e) {
+            LogError("Failed to send block %s: %s, %s", inv.hash.ToString(), e.what(), pfrom.DisconnectMsg());
+            pfrom.fDisconnect = true;
         }
+        pfrom.Release();
+        m_connman.WakeMessageHandler();
+        // FinalizeNode() waits for this; the CNode must not be touched afterwards.
+        peer->m_block_serve_in_flight = false;
+        peer->m_block_serve_in_flight.notify_all();
+    })};
+    if (!submitted) {
+        peer->m_block_serve_in_flight = false;
+        pfrom.Release();
+        return false;
     }
+    return true;
+}
+
+void PeerManagerImpl::SendBlockFromDisk(CNode& pfrom, Peer& peer, const CInv& inv, const CBlockIndex& index, FlatFilePos block_pos, const uint256& tip_hash)
+{
+    Assume(inv.IsMsgBlk() || inv.IsMsgWitnessBlk());
+    bool read_ok;
+    if (inv.IsMsgWitnessBlk()) {
+        // The network format matches the format on disk.
+        const auto block_data{m_chainman.m_blockman.ReadRawBlock(block_pos)};
+        read_ok = block_data.has_value();
+        if (read_ok) MakeAndPushMessage(pfrom, NetMsgType::BLOCK, std::span{*block_data});
+    } else {
+        CBlock block;
+        read_ok = m_chainman.m_blockman.ReadBlock(block, block_pos, inv.hash);
+        if (read_ok) MakeAndPushMessage(pfrom, NetMsgType::BLOCK, TX_NO_WITNESS(block));
+    }
+    if (!read_ok) {
+        if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(index))) {
+            LogDebug(BCLog::NET, "Block was pruned before it could be read, %s", pfrom.DisconnectMsg());
+        } else {
+            LogError("Cannot load block from disk, %s", pfrom.DisconnectMsg());
+        }
+        pfrom.fDisconnect = true;
+        return;
+    }
+    MaybeSendContinuationInv(pfrom, peer, inv.hash, tip_hash);
 }
 
 CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
@@ -2555,10 +2753,47 @@ CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay,
     return {};
 }
 
+void PeerManagerImpl::AnnounceReconciledTxs(CNode& node, Peer& peer, std::span<const Wtxid> wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay || wtxids.empty()) return;
+
+    // Reconciling peers always use wtxid relay.
+    std::vector<CInv> invs;
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    const CFeeRate filterrate{tx_relay->m_fee_filter_received.load()};
+    {
+        LOCK(tx_relay->m_bloom_filter_mutex);
+        for (const Wtxid& wtxid : wtxids) {
+            // Not in the mempool anymore? don't bother sending it.
+            auto txinfo = m_mempool.info(wtxid);
+            if (!txinfo.tx) continue;
+            if (tx_relay->m_tx_inventory_known_filter.contains(wtxid.ToUint256())) continue;
+            if (txinfo.fee < filterrate.GetFee(txinfo.vsize)) continue;
+            if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
+            tx_relay->m_tx_inventory_known_filter.insert(wtxid.ToUint256());
+            invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+            if (invs.size() == MAX_INV_SZ) {
+                MakeAndPushMessage(node, NetMsgType::INV, invs);
+                invs.clear();
+            }
+        }
+    }
+    if (!invs.empty()) MakeAndPushMessage(node, NetMsgType::INV, invs);
+
+    // Ensure we'll respond to GETDATA requests for anything we've just announced
+    LOCK(m_mempool.cs);
+    tx_relay->m_last_inv_sequence = m_mempool.GetSequence();
+}
+
 void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(cs_main);
 
+    // Responses must follow a block still being sent from the block serve pool,
+    // which also ensures only one such block is in flight per peer.
+    if (peer.m_block_serve_in_flight) return;
+
     auto tx_relay = peer.GetTxRelay();
 
     std::deque<CInv>::iterator it = peer.m_getdata_requests.begin();
@@ -2656,14 +2891,18 @@ void PeerManagerImpl::SendBlockTransactions(CNode& pfrom, Peer& peer, const CBlo
 
 bool PeerManagerImpl::CheckHeadersPoW(const std::vector<CBlockHeader>& headers, Peer& peer)
 {
+    // Hash all headers up front, several at a time; only the checks linking
+    // each header to the previous one below need to run in order.
+    const std::vector<uint256> hashes{GetBlockHeaderHashes(headers)};
+
     // Do these headers have proof-of-work matching what's claimed?
-    if (!HasValidProofOfWork(headers, m_chainparams.GetConsensus())) {
+    if (!HasValidProofOfWork(headers, hashes, m_chainparams.GetConsensus())) {
         Misbehaving(peer, "header with invalid proof of work");
         return false;
     }
 
     // Are these headers connected to each other?
-    if (!CheckHeadersAreContinuous(headers)) {
+    if (!CheckHeadersAreContinuous(headers, hashes)) {
         Misbehaving(peer, "non-continuous headers sequence");
         return false;
     }
@@ -2708,14 +2947,12 @@ void PeerManagerImpl::HandleUnconnectingHeaders(CNode& pfrom, Peer& peer,
     WITH_LOCK(cs_main, UpdateBlockAvailability(pfrom.GetId(), headers.back().GetHash()));
 }
 
-bool PeerManagerImpl::CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers) const
+bool PeerManagerImpl::CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers, std::span<const uint256> hashes) const
 {
-    uint256 hashLastBlock;
-    for (const CBlockHeader& header : headers) {
-        if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+    for (size_t i = 1; i < headers.size(); ++i) {
+        if (headers[i].hashPrevBlock != hashes[i - 1]) {
             return false;
         }
-        hashLastBlock = header.GetHash();
     }
     return true;
 }
@@ -3173,6 +3410,8 @@ std::optional<node::PackageToValidate> PeerManagerImpl::ProcessInvalidTx(NodeId
         state.ToString());
 
     const auto& [add_extra_compact_tx, unique_parents, package_to_validate] = m_txdownloadman.MempoolRejectedTx(ptx, state, nodeid, first_time_failure);
+    // Missing parents of an orphan may now be requested from any peer that announced it.
+    m_tx_requests_reselected = true;
 
     if (add_extra_compact_tx && RecursiveDynamicUsage(*ptx) < 100000) {
         AddToCompactExtraTransactions(ptx);
@@ -4176,6 +4415,10 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(peer, inv.hash);
+                // No need to reconcile a transaction the peer told us about.
+                if (m_txreconciliation && inv.IsMsgWtx()) {
+                    m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
+                }
 
                 if (!m_chainman.IsInitialBlockDownload()) {
                     const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
@@ -4217,6 +4460,65 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reqrecon from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        uint16_t peer_recon_set_size, peer_q;
+        vRecv >> peer_recon_set_size >> peer_q;
+        const auto skdata{m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_recon_set_size, peer_q,
+                                                                         GetTime<std::chrono::microseconds>())};
+        if (!skdata) {
+            if (skdata.error() == ReconciliationRequestError::RATE_LIMITED) {
+                LogDebug(BCLog::NET, "reqrecon from peer=%d ignored, as it came too soon after the previous one\n", pfrom.GetId());
+            } else {
+                Misbehaving(peer, "unexpected reqrecon");
+            }
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::SKETCH, *skdata);
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "sketch from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        const auto result{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)};
+        if (!result) {
+            Misbehaving(peer, "unexpected or malformed sketch");
+            return;
+        }
+        // Tell the peer what we are missing (or that we failed), then announce what it is missing.
+        MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{result->success}, result->txs_to_request);
+        AnnounceReconciledTxs(pfrom, peer, result->txs_to_announce);
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "reconcildiff from peer=%d ignored, as we do not reconcile transactions with it\n", pfrom.GetId());
+            return;
+        }
+
+        uint8_t success;
+        std::vector<uint32_t> ask_shortids;
+        vRecv >> success >> ask_shortids;
+        const auto txs_to_announce{m_txreconciliation->HandleReconciliationDifference(pfrom.GetId(), success != 0, ask_shortids)};
+        if (!txs_to_announce) {
+            Misbehaving(peer, "unexpected reconcildiff");
+            return;
+        }
+        AnnounceReconciledTxs(pfrom, peer, *txs_to_announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::GETDATA) {
         std::vector<CInv> vInv;
         vRecv >> vInv;
@@ -4509,6 +4811,7 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
         LOCK2(cs_main, m_tx_download_mutex);
 
         const auto& [should_validate, package_to_validate] = m_txdownloadman.ReceivedTx(pfrom.GetId(), ptx);
+        m_tx_requests_reselected = true;
         if (!should_validate) {
             if (pfrom.HasPermission(NetPermissionFlags::ForceRelay)) {
                 // Always relay transactions received from peers with forcerelay
@@ -4907,6 +5210,7 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
             // Always process the block if we requested it, since we may
             // need it even when it's not a candidate for a new best tip.
             forceProcessing = IsBlockRequested(hash);
+            BlockDelivered(pfrom.GetId(), hash);
             RemoveBlockRequest(hash, pfrom.GetId());
             // mapBlockSource is only used for punishing peers and setting
             // which peers send us compact blocks, so the race between here and
@@ -5125,6 +5429,7 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
         }
         LOCK(m_tx_download_mutex);
         m_txdownloadman.ReceivedNotFound(pfrom.GetId(), tx_invs);
+        m_tx_requests_reselected = true;
         return;
     }
 
@@ -5185,6 +5490,10 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     // has been sent first before processing any incoming messages
     if (!node.IsInboundConn() && !peer.m_outbound_version_message_sent) return false;
 
+    // Wait for a block being sent from the block serve pool, which wakes us
+    // when done, so our responses to this peer stay in order.
+    if (peer.m_block_serve_in_flight) return false;
+
     {
         LOCK(peer.m_getdata_requests_mutex);
         if (!peer.m_getdata_requests.empty()) {
@@ -5192,6 +5501,10 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
         }
     }
 
+    // ProcessGetData() may have handed a block to the block serve pool. Nothing
+    // else may be sent to this peer before it.
+    if (peer.m_block_serve_in_flight) return false;
+
     const bool processed_orphan = ProcessOrphanTx(peer);
 
     if (node.fDisconnect)
@@ -5214,6 +5527,7 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
         // No message to process
         return false;
     }
+    peer.m_send_due = true;
 
     CNetMessage& msg{poll_result->first};
     bool fMoreWork = poll_result->second;
@@ -5828,6 +6142,60 @@ void PeerManagerImpl::ProcessAddrs(std::string_view msg_type, CNode& pfrom, Peer
     }
 }
 
+bool PeerManagerImpl::SendMessagesDue(const CNode& node)
+{
+    AssertLockNotHeld(m_tx_download_mutex);
+    AssertLockHeld(g_msgproc_mutex);
+
+    const auto current_time{GetTime<std::chrono::microseconds>()};
+    for (const NodeId expired : m_send_timers.Advance(current_time)) {
+        if (PeerRef peer{GetPeerRef(expired)}) peer->m_send_due = true;
+    }
+
+    // A transaction announcement became requestable, or a request expired, possibly for any peer.
+    bool requests_due;
+    {
+        LOCK(m_tx_download_mutex);
+        const auto next_request{m_txdownloadman.NextRequestTime()};
+        requests_due = std::exchange(m_tx_requests_reselected, false) || (next_request && *next_request <= current_time);
+    }
+    if (requests_due) {
+        LOCK(m_peer_mutex);
+        for (auto& [_, peer] : m_peer_map) peer->m_send_due = true;
+    }
+
+    PeerRef peer{GetPeerRef(node.GetId())};
+    if (!peer) return false;
+    return peer->m_send_due || peer->m_ping_queued ||
+           // Transactions are announced to these peers without trickle delay.
+           node.HasPermission(NetPermissionFlags::NoBan) ||
+           std::chrono::steady_clock::now() - peer->m_last_send_messages >= SEND_MESSAGES_MAX_IDLE;
+}
+
+void PeerManagerImpl::ScheduleSendTimer(const CNode& node, Peer& peer)
+{
+    auto deadline{std::chrono::microseconds::max()};
+    const auto ping_start{peer.m_ping_start.load().time_since_epoch()};
+    deadline = std::min(deadline, std::chrono::duration_cast<std::chrono::microseconds>(ping_start + (peer.m_ping_nonce_sent ? TIMEOUT_INTERVAL : PING_INTERVAL)));
+    {
+        LOCK(peer.m_addr_send_times_mutex);
+        if (peer.m_addr_relay_enabled) deadline = std::min(deadline, peer.m_next_addr_send);
+        if (peer.m_next_local_addr_send != 0us) deadline = std::min(deadline, peer.m_next_local_addr_send);
+    }
+    if (auto tx_relay = peer.GetTxRelay(); tx_relay != nullptr) {
+        LOCK(tx_relay->m_tx_inventory_mutex);
+        if (tx_relay->m_next_inv_send_time != 0s) deadline = std::min(deadline, tx_relay->m_next_inv_send_time);
+    }
+    if (peer.m_next_send_feefilter != 0us) deadline = std::min(deadline, peer.m_next_send_feefilter);
+
+    // The checks in SendMessages() fire once the current time is strictly past a deadline.
+    if (deadline == std::chrono::microseconds::max()) {
+        m_send_timers.Cancel(node.GetId());
+    } else {
+        m_send_timers.Schedule(node.GetId(), deadline + 1us);
+    }
+}
+
 bool PeerManagerImpl::SendMessages(CNode& node)
 {
     AssertLockNotHeld(m_tx_download_mutex);
@@ -5836,12 +6204,28 @@ bool PeerManagerImpl::SendMessages(CNode& node)
     PeerRef maybe_peer{GetPeerRef(node.GetId())};
     if (!maybe_peer) return false;
     Peer& peer{*maybe_peer};
+
+    peer.m_send_due = false;
+    peer.m_last_send_messages = std::chrono::steady_clock::now();
+    const bool ret{SendMessagesToPeer(node, peer)};
+    ScheduleSendTimer(node, peer);
+    return ret;
+}
+
+bool PeerManagerImpl::SendMessagesToPeer(CNode& node, Peer& peer)
+{
+    AssertLockNotHeld(m_tx_download_mutex);
+    AssertLockHeld(g_msgproc_mutex);
+
     const Consensus::Params& consensusParams = m_chainparams.GetConsensus();
 
     // We must call MaybeDiscourageAndDisconnect first, to ensure that we'll
     // disconnect misbehaving peers even before the version handshake is complete.
     if (MaybeDiscourageAndDisconnect(node, peer)) return true;
 
+    // Nothing may overtake a block being sent from the block serve pool.
+    if (peer.m_block_serve_in_flight) return true;
+
     // Initiate version handshake for outbound connections
     if (!node.IsInboundConn() && !peer.m_outbound_version_message_sent) {
         PushNodeVersion(node, peer);
@@ -6015,15 +6399,15 @@ bool PeerManagerImpl::SendMessages(CNode& node)
                     LogDebug(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", __func__,
                             vHeaders.front().GetHash().ToString(), node.GetId());
 
-                    std::optional<CSerializedNetMsg> cached_cmpctblock_msg;
+                    std::shared_ptr<const CSerializedNetMsg> cached_cmpctblock_msg;
                     {
                         LOCK(m_most_recent_block_mutex);
                         if (m_most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            cached_cmpctblock_msg = NetMsg::Make(NetMsgType::CMPCTBLOCK, *m_most_recent_compact_block);
+                            cached_cmpctblock_msg = m_most_recent_cmpctblock_msg;
                         }
                     }
-                    if (cached_cmpctblock_msg.has_value()) {
-                        PushMessage(node, std::move(cached_cmpctblock_msg.value()));
+                    if (cached_cmpctblock_msg) {
+                        PushMessage(node, cached_cmpctblock_msg->Copy());
                     } else {
                         CBlock block;
                         const bool ret{m_chainman.m_blockman.ReadBlock(block, *pBestIndex)};
@@ -6042,7 +6426,18 @@ bool PeerManagerImpl::SendMessages(CNode& node)
                         LogDebug(BCLog::NET, "%s: sending header %s to peer=%d\n", __func__,
                                 vHeaders.front().GetHash().ToString(), node.GetId());
                     }
-                    MakeAndPushMessage(node, NetMsgType::HEADERS, TX_WITH_WITNESS(vHeaders));
+                    std::shared_ptr<const CSerializedNetMsg> cached_headers_msg;
+                    if (vHeaders.size() == 1) {
+                        LOCK(m_most_recent_block_mutex);
+                        if (m_most_recent_block_hash == pBestIndex->GetBlockHash()) {
+                            cached_headers_msg = m_most_recent_headers_msg;
+                        }
+                    }
+                    if (cached_headers_msg) {
+                        PushMessage(node, cached_headers_msg->Copy());
+                    } else {
+                        MakeAndPushMessage(node, NetMsgType::HEADERS, TX_WITH_WITNESS(vHeaders));
+                    }
                     state.pindexBestHeaderSent = pBestIndex;
                 } else
                     fRevertToInv = true;
@@ -6161,6 +6556,7 @@ bool PeerManagerImpl::SendMessages(CNode& node)
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
                     unsigned int nRelayedTransactions = 0;
+                    const bool reconciling{m_txreconciliation && m_txreconciliation->IsPeerRegistered(node.GetId())};
                     LOCK(tx_relay->m_bloom_filter_mutex);
                     size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.size()/1000)*5};
                     broadcast_max = std::min<size_t>(INVENTORY_BROADCAST_MAX, broadcast_max);
@@ -6192,6 +6588,12 @@ bool PeerManagerImpl::SendMessages(CNode& node)
                             continue;
                         }
                         if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
+                        // Unless the peer was picked to have this transaction flooded to it, leave
+                        // the announcement to the next reconciliation round (if its set has room).
+                        if (reconciling && !m_txreconciliation->ShouldFanoutTo(wtxid, node.GetId()) &&
+                            m_txreconciliation->AddToSet(node.GetId(), wtxid)) {
+                            continue;
+                        }
                         // Send
                         vInv.push_back(inv);
                         nRelayedTransactions++;
@@ -6210,6 +6612,16 @@ bool PeerManagerImpl::SendMessages(CNode& node)
         if (!vInv.empty())
             MakeAndPushMessage(node, NetMsgType::INV, vInv);
 
+        if (m_txreconciliation) {
+            if (const auto txs_to_announce{m_txreconciliation->ExpireReconciliationRound(node.GetId(), current_time)}) {
+                AnnounceReconciledTxs(node, peer, *txs_to_announce);
+            }
+            if (const auto request{m_txreconciliation->InitiateReconciliationRequest(node.GetId(), current_time)}) {
+                const auto [local_set_size, q]{*request};
+                MakeAndPushMessage(node, NetMsgType::REQRECON, local_set_size, q);
+            }
+        }
+
         // Detect whether we're stalling
         auto stalling_timeout = m_block_stalling_timeout.load();
         if (state.m_stalling_since.count() && state.m_stalling_since < current_time - stalling_timeout) {
@@ -6281,11 +6693,14 @@ bool PeerManagerImpl::SendMessages(CNode& node)
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (CanServeBlocks(peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        const auto min_ping_time{node.m_min_ping_time.load()};
+        state.m_max_blocks_in_flight = state.m_block_download.MaxBlocksInFlight(
+            min_ping_time == NodeClock::duration::max() ? 0us : std::chrono::duration_cast<std::chrono::microseconds>(min_ping_time));
+        if (CanServeBlocks(peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(peer)) || !m_chainman.IsInitialBlockDownload()) && static_cast<int>(state.vBlocksInFlight.size()) < state.m_max_blocks_in_flight) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
             auto get_inflight_budget = [&state]() {
-                return std::max(0, MAX_BLOCKS_IN_TRANSIT_PER_PEER - static_cast<int>(state.vBlocksInFlight.size()));
+                return std::max(0, state.m_max_blocks_in_flight - static_cast<int>(state.vBlocksInFlight.size()));
             };
 
             // If there are multiple chainstates, download blocks for the
@@ -9,6 +9,7 @@
 #include <consensus/amount.h>
 #include <net.h>
 #include <node/txorphanage.h>
+#include <node/txreconciliation.h>
 #include <node/types.h>
 #include <private_broadcast.h>
 #include <protocol.h>
@@ -42,6 +43,10 @@ static constexpr bool DEFAULT_TXRECONCILIATION_ENABLE{false};
 /** Default number of non-mempool transactions to keep around for block reconstruction. Includes
     orphan, replaced, and rejected transactions. */
 static const uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
+/** Default number of threads reading requested blocks from disk and sending them to peers. */
+static constexpr int DEFAULT_BLOCK_SERVE_THREADS{2};
+/** Maximum for -blockservethreads. */
+static constexpr int MAX_BLOCK_SERVE_THREADS{16};
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
@@ -57,6 +62,10 @@ struct CNodeStateStats {
     int nCommonHeight = -1;
     NodeClock::duration m_ping_wait;
     std::vector<int> vHeightInFlight;
+    int m_max_blocks_in_flight{0};
+    uint64_t m_blocks_received{0};
+    std::optional<std::chrono::microseconds> m_block_latency;
+    std::optional<std::chrono::microseconds> m_block_transfer_time;
     bool m_relay_txs;
     int m_inv_to_send = 0;
     uint64_t m_last_inv_seq{0};
@@ -73,6 +82,8 @@ struct PeerManagerInfo {
     std::chrono::seconds median_outbound_time_offset{0s};
     bool ignores_incoming_txs{false};
     bool private_broadcast{DEFAULT_PRIVATE_BROADCAST};
+    /** Set if transaction reconciliation is enabled. */
+    std::optional<TxReconciliationStats> txreconciliation;
 };
 
 class PeerManager : public CValidationInterface, public NetEventsInterface
@@ -96,6 +107,9 @@ public:
         uint32_t max_headers_result{MAX_HEADERS_RESULTS};
         //! Whether private broadcast is used for sending transactions.
         bool private_broadcast{DEFAULT_PRIVATE_BROADCAST};
+        //! Number of threads serving getdata block requests from disk. With 0,
+        //! blocks are served from the message handler thread.
+        int block_serve_threads{DEFAULT_BLOCK_SERVE_THREADS};
     };
 
     static std::unique_ptr<PeerManager> make(CConnman& connman, AddrMan& addrman,
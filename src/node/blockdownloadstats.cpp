@@ -0,0 +1,59 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockdownloadstats.h>
+
+#include <algorithm>
+
+namespace node {
+namespace {
+/** Move an average 1/8 of the way towards a new sample, as TCP does for its round trip time. */
+std::chrono::microseconds UpdateAverage(std::chrono::microseconds average, std::chrono::microseconds sample)
+{
+    return average + (sample - average) / 8;
+}
+} // namespace
+
+void BlockDownloadStats::BlockReceived(std::chrono::microseconds requested, std::chrono::microseconds now)
+{
+    const auto latency{std::max(now - requested, std::chrono::microseconds{0})};
+    const auto transfer_time{std::max(now - std::max(requested, m_last_delivery), std::chrono::microseconds{0})};
+    if (m_blocks_received == 0) {
+        m_latency = latency;
+        m_transfer_time = transfer_time;
+    } else {
+        m_latency = UpdateAverage(m_latency, latency);
+        m_transfer_time = UpdateAverage(m_transfer_time, transfer_time);
+    }
+    m_last_delivery = std::max(m_last_delivery, now);
+    ++m_blocks_received;
+}
+
+std::optional<std::chrono::microseconds> BlockDownloadStats::Latency() const
+{
+    if (m_blocks_received == 0) return std::nullopt;
+    return m_latency;
+}
+
+std::optional<std::chrono::microseconds> BlockDownloadStats::TransferTime() const
+{
+    if (m_blocks_received == 0) return std::nullopt;
+    return m_transfer_time;
+}
+
+int BlockDownloadStats::MaxBlocksInFlight(std::chrono::microseconds rtt) const
+{
+    if (m_blocks_received == 0) return DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER;
+    const auto transfer_time{std::max(m_transfer_time, std::chrono::microseconds{1})};
+    const auto wanted{(std::max(rtt, std::chrono::microseconds{0}) + BLOCK_DOWNLOAD_QUEUE_TIME) / transfer_time + 1};
+    return int(std::clamp<int64_t>(wanted, MIN_BLOCKS_IN_TRANSIT_PER_PEER, MAX_BLOCKS_IN_TRANSIT_PER_PEER_ADAPTIVE));
+}
+
+bool BlockDownloadStats::IsStuck(std::chrono::microseconds in_flight) const
+{
+    if (in_flight < BLOCK_STUCK_TIMEOUT_MIN) return false;
+    // Without measurements, only the minimum applies.
+    return m_blocks_received == 0 || in_flight > BLOCK_STUCK_LATENCY_FACTOR * m_latency;
+}
+} // namespace node
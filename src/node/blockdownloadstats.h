@@ -0,0 +1,65 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKDOWNLOADSTATS_H
+#define BITCOIN_NODE_BLOCKDOWNLOADSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace node {
+/** Number of blocks in flight allowed from a peer we have no measurements for yet. */
+static constexpr int DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER{16};
+/** Lower bound on the number of blocks in flight allowed from a single peer, however slow. */
+static constexpr int MIN_BLOCKS_IN_TRANSIT_PER_PEER{2};
+/** Upper bound on the number of blocks in flight allowed from a single peer, however fast. */
+static constexpr int MAX_BLOCKS_IN_TRANSIT_PER_PEER_ADAPTIVE{64};
+/** Time worth of blocks to keep queued at a peer on top of a round trip, so that it does not go
+ *  idle between our requests. */
+static constexpr std::chrono::seconds BLOCK_DOWNLOAD_QUEUE_TIME{1};
+/** A block is never considered stuck before it has been in flight this long. */
+static constexpr std::chrono::seconds BLOCK_STUCK_TIMEOUT_MIN{2};
+/** A block is considered stuck once it has been in flight this many times longer than the peer
+ *  usually takes to deliver one. */
+static constexpr int BLOCK_STUCK_LATENCY_FACTOR{4};
+
+/** Tracks how quickly a peer serves the blocks we request from it.
+ *
+ * Two exponentially weighted moving averages are kept over the blocks it delivered:
+ * - latency: the time from our request to the delivery of the block.
+ * - transfer time: the time the peer spent on the block itself, i.e. since the request or since
+ *   the previous delivery, whichever is later. Its inverse is the peer's throughput.
+ *
+ * These size the number of blocks requested from the peer at once, and tell when a block requested
+ * from it is taking unusually long.
+ */
+class BlockDownloadStats
+{
+    std::chrono::microseconds m_latency{0};
+    std::chrono::microseconds m_transfer_time{0};
+    std::chrono::microseconds m_last_delivery{0};
+    uint64_t m_blocks_received{0};
+
+public:
+    /** Record the delivery of a block requested at time requested. */
+    void BlockReceived(std::chrono::microseconds requested, std::chrono::microseconds now);
+
+    uint64_t BlocksReceived() const { return m_blocks_received; }
+    /** Average time from request to delivery, if any block was delivered. */
+    std::optional<std::chrono::microseconds> Latency() const;
+    /** Average time the peer takes to send one block, if any block was delivered. */
+    std::optional<std::chrono::microseconds> TransferTime() const;
+
+    /** The number of blocks to keep in flight from this peer: enough to cover a round trip plus
+     *  BLOCK_DOWNLOAD_QUEUE_TIME at its throughput, so fast peers are kept busy while slow peers
+     *  do not hold back the download window with many outstanding blocks. */
+    int MaxBlocksInFlight(std::chrono::microseconds rtt) const;
+
+    /** Whether a block in flight from this peer for the given time should be considered stuck. */
+    bool IsStuck(std::chrono::microseconds in_flight) const;
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKDOWNLOADSTATS_H
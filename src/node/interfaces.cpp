@@ -502,7 +502,9 @@ public:
     explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications)
         : m_signals{signals}, m_proxy{std::make_shared<NotificationsProxy>(std::move(notifications))}
     {
-        m_signals.RegisterSharedValidationInterface(m_proxy);
+        // Chain clients share a notification queue, so that they do not hold up
+        // indexes and other subscribers.
+        m_signals.RegisterSharedValidationInterface(m_proxy, "wallet");
     }
     ~NotificationsHandlerImpl() override { disconnect(); }
     void disconnect() override
@@ -880,9 +882,11 @@ class BlockTemplateImpl : public BlockTemplate
 public:
     explicit BlockTemplateImpl(BlockCreateOptions create_options,
                                std::unique_ptr<CBlockTemplate> block_template,
-                               const NodeContext& node) : m_create_options(std::move(create_options)),
-                                                          m_block_template(std::move(block_template)),
-                                                          m_node(node)
+                               const NodeContext& node,
+                               std::optional<std::vector<CTransactionRef>> previous_txs = std::nullopt) : m_create_options(std::move(create_options)),
+                                                                                                          m_block_template(std::move(block_template)),
+                                                                                                          m_previous_txs(std::move(previous_txs)),
+                                                                                                          m_node(node)
     {
         assert(m_block_template);
     }
@@ -935,7 +939,7 @@ public:
                                                   /*wait_options=*/options,
                                                   /*create_options=*/m_create_options,
                                                   /*interrupt_wait=*/m_interrupt_wait);
-        if (new_template) return std::make_unique<BlockTemplateImpl>(m_create_options, std::move(new_template), m_node);
+        if (new_template) return std::make_unique<BlockTemplateImpl>(m_create_options, std::move(new_template), m_node, m_block_template->block.vtx);
         return nullptr;
     }
 
@@ -944,10 +948,19 @@ public:
         InterruptWait(notifications(), m_interrupt_wait);
     }
 
+    std::optional<BlockTemplateDiff> getDiff() override
+    {
+        if (!m_previous_txs) return std::nullopt;
+        return GetBlockTemplateDiff(*m_previous_txs, *m_block_template);
+    }
+
     const BlockCreateOptions m_create_options;
 
     const std::unique_ptr<CBlockTemplate> m_block_template;
 
+    //! Transactions of the template this one was created from by waitNext()
+    const std::optional<std::vector<CTransactionRef>> m_previous_txs;
+
     bool m_interrupt_wait{false};
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     KernelNotifications& notifications() { return *Assert(m_node.notifications); }
@@ -4,6 +4,7 @@
 
 #include <node/mempool_persist.h>
 
+#include <chain.h>
 #include <clientversion.h>
 #include <consensus/amount.h>
 #include <primitives/transaction.h>
@@ -22,6 +23,7 @@
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
@@ -38,7 +40,18 @@ using fsbridge::FopenFn;
 namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
-static const uint64_t MEMPOOL_DUMP_VERSION{2};
+static const uint64_t MEMPOOL_DUMP_VERSION_NO_CHAIN_TIP{2};
+static const uint64_t MEMPOOL_DUMP_VERSION{3};
+/** Number of transactions submitted to the mempool at once while loading. */
+static constexpr size_t MEMPOOL_LOAD_BATCH_SIZE{1000};
+/**
+ * Number of transactions submitted at once when the file was written at the current chain tip. All
+ * transactions are then expected to be accepted, so larger batches waste no script verification
+ * work and give the script check threads more to do in parallel. This does not lengthen cs_main
+ * hold times, as AcceptToMemoryPoolBatch() runs the script checks without cs_main and releases it
+ * between small groups of submissions.
+ */
+static constexpr size_t MEMPOOL_LOAD_BATCH_SIZE_SAME_TIP{10000};
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -63,7 +76,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
 
         if (version == MEMPOOL_DUMP_VERSION_NO_XOR_KEY) {
             file.SetObfuscation({});
-        } else if (version == MEMPOOL_DUMP_VERSION) {
+        } else if (version == MEMPOOL_DUMP_VERSION_NO_CHAIN_TIP || version == MEMPOOL_DUMP_VERSION) {
             Obfuscation obfuscation;
             file >> obfuscation;
             file.SetObfuscation(obfuscation);
@@ -71,11 +84,48 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             return false;
         }
 
+        size_t batch_size{MEMPOOL_LOAD_BATCH_SIZE};
+        if (version == MEMPOOL_DUMP_VERSION) {
+            uint256 chain_tip;
+            file >> chain_tip;
+            const bool same_tip{WITH_LOCK(cs_main, return active_chainstate.m_chain.Tip() &&
+                                                          active_chainstate.m_chain.Tip()->GetBlockHash() == chain_tip)};
+            if (same_tip) {
+                LogInfo("Mempool file was written at the current chain tip %s\n", chain_tip.ToString());
+                batch_size = MEMPOOL_LOAD_BATCH_SIZE_SAME_TIP;
+            }
+        }
+
         uint64_t total_txns_to_load;
         file >> total_txns_to_load;
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
         int next_tenth_to_report = 0;
+
+        // Transactions are submitted in batches, so that their script checks can be run in parallel.
+        std::vector<std::pair<CTransactionRef, int64_t>> batch;
+        batch.reserve(std::min<uint64_t>(batch_size, total_txns_to_load));
+        const auto submit_batch{[&] {
+            if (batch.empty()) return;
+            const auto results{AcceptToMemoryPoolBatch(active_chainstate, batch, /*bypass_limits=*/false)};
+            for (size_t i{0}; i < batch.size(); ++i) {
+                if (results[i].m_result_type == MempoolAcceptResult::ResultType::VALID) {
+                    ++count;
+                } else {
+                    // mempool may contain the transaction already, e.g. from
+                    // wallet(s) having loaded it while we were processing
+                    // mempool transactions; consider these as valid, instead of
+                    // failed, but mark them as 'already there'
+                    if (pool.exists(batch[i].first->GetHash())) {
+                        ++already_there;
+                    } else {
+                        ++failed;
+                    }
+                }
+            }
+            batch.clear();
+        }};
+
         while (txns_tried < total_txns_to_load) {
             const int percentage_done(100.0 * txns_tried / total_txns_to_load);
             if (next_tenth_to_report < percentage_done / 10) {
@@ -101,27 +151,15 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
                 pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
             }
             if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
-                LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
-                if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
-                    ++count;
-                } else {
-                    // mempool may contain the transaction already, e.g. from
-                    // wallet(s) having loaded it while we were processing
-                    // mempool transactions; consider these as valid, instead of
-                    // failed, but mark them as 'already there'
-                    if (pool.exists(tx->GetHash())) {
-                        ++already_there;
-                    } else {
-                        ++failed;
-                    }
-                }
+                batch.emplace_back(std::move(tx), nTime);
+                if (batch.size() >= batch_size) submit_batch();
             } else {
                 ++expired;
             }
             if (active_chainstate.m_chainman.m_interrupt)
                 return false;
         }
+        submit_batch();
         std::map<Txid, CAmount> mapDeltas;
         file >> mapDeltas;
 
@@ -150,7 +188,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
     return true;
 }
 
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, const uint256& chain_tip, FopenFn mockable_fopen_function, bool skip_file_commit)
 {
     auto start = SteadyClock::now();
 
@@ -186,6 +224,7 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
             const Obfuscation obfuscation{FastRandomContext{}.randbytes<Obfuscation::KEY_SIZE>()};
             file << obfuscation;
             file.SetObfuscation(obfuscation);
+            file << chain_tip;
         } else {
             file.SetObfuscation({});
         }
@@ -9,11 +9,15 @@
 
 class Chainstate;
 class CTxMemPool;
+class uint256;
 
 namespace node {
 
-/** Dump the mempool to a file. */
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path,
+/**
+ * Dump the mempool to a file. The hash of the chain tip the mempool was built on top of is
+ * recorded, which allows LoadMempool() to take a faster path when restarting at the same tip.
+ */
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, const uint256& chain_tip,
                  fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
                  bool skip_file_commit = false);
 
@@ -32,6 +32,7 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/feefrac.h>
+#include <util/hasher.h>
 #include <util/log.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
@@ -50,7 +51,9 @@
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace node {
 
@@ -362,6 +365,38 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
     block.fChecked = false;
 }
 
+BlockTemplateDiff GetBlockTemplateDiff(const std::vector<CTransactionRef>& previous, const CBlockTemplate& block_template)
+{
+    const auto& vtx{block_template.block.vtx};
+    Assume(vtx.size() == block_template.vTxFees.size() + 1);
+    BlockTemplateDiff diff;
+    diff.header = block_template.block;
+    diff.coinbase_tx = block_template.m_coinbase_tx;
+
+    // Position 0 is the coinbase transaction, which is not part of the diff.
+    std::unordered_map<Wtxid, uint32_t, SaltedWtxidHasher> previous_index;
+    previous_index.reserve(previous.size());
+    for (uint32_t i{1}; i < previous.size(); ++i) previous_index.emplace(previous[i]->GetWitnessHash(), i);
+
+    // Keep transactions found in the previous template as long as they appear
+    // in the same relative order, so that the diff can be applied in place.
+    std::vector<bool> kept(previous.size(), false);
+    uint32_t last_kept{0};
+    for (uint32_t i{1}; i < vtx.size(); ++i) {
+        const auto it{previous_index.find(vtx[i]->GetWitnessHash())};
+        if (it != previous_index.end() && it->second > last_kept) {
+            kept[it->second] = true;
+            last_kept = it->second;
+        } else {
+            diff.added.push_back({.index = i, .tx = vtx[i], .fee = block_template.vTxFees[i - 1], .sigops = block_template.vTxSigOpsCost[i - 1]});
+        }
+    }
+    for (uint32_t i{1}; i < previous.size(); ++i) {
+        if (!kept[i]) diff.removed.push_back(i);
+    }
+    return diff;
+}
+
 namespace {
 class SubmitBlockStateCatcher final : public CValidationInterface
 {
@@ -134,6 +134,14 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
 //! Returns whether ProcessNewBlock accepted the block.
 bool SubmitBlock(ChainstateManager& chainman, const std::shared_ptr<const CBlock>& block, bool* new_block, std::string& reason, std::string& debug);
 
+/**
+ * Compute the changes from a template with the transactions previous to
+ * block_template. Transactions kept by both are matched by witness txid;
+ * transactions whose order relative to the others changed are reported as
+ * removed and added again.
+ */
+BlockTemplateDiff GetBlockTemplateDiff(const std::vector<CTransactionRef>& previous, const CBlockTemplate& block_template);
+
 /* Interrupt a blocking call. */
 void InterruptWait(KernelNotifications& kernel_notifications, bool& interrupt_wait);
 /**
@@ -14,6 +14,7 @@
 #include <consensus/amount.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
+#include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <uint256.h>
@@ -173,6 +174,35 @@ struct CoinbaseTx {
     uint32_t lock_time;
 };
 
+/** A transaction added to a block template, see BlockTemplateDiff. */
+struct BlockTemplateTx {
+    //! Position in the block, counting the coinbase transaction as 0
+    uint32_t index;
+    CTransactionRef tx;
+    CAmount fee;
+    int64_t sigops;
+};
+
+/**
+ * Changes from one block template to the next, for clients that keep a copy
+ * of the previous template's transactions and update it in place. Removing
+ * the transactions at the positions in `removed`, then inserting those in
+ * `added` at their positions, in order, yields the new template's
+ * transactions.
+ */
+struct BlockTemplateDiff {
+    //! Positions of the previous template's transactions that are not in the
+    //! new one (or that moved), in increasing order
+    std::vector<uint32_t> removed;
+    //! Transactions of the new template that were not in the previous one (or
+    //! that moved), in increasing order of position
+    std::vector<BlockTemplateTx> added;
+    //! Header of the new template
+    CBlockHeader header;
+    //! Coinbase fields of the new template, including its witness commitment
+    CoinbaseTx coinbase_tx;
+};
+
 } // namespace node
 
 #endif // BITCOIN_NODE_MINING_TYPES_H
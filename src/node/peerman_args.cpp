@@ -25,6 +25,10 @@ void ApplyArgsManOptions(const ArgsManager& argsman, PeerManager::Options& optio
     if (auto value{argsman.GetBoolArg("-blocksonly")}) options.ignore_incoming_txs = *value;
 
     if (auto value{argsman.GetBoolArg("-privatebroadcast")}) options.private_broadcast = *value;
+
+    if (auto value{argsman.GetIntArg("-blockservethreads")}) {
+        options.block_serve_threads = std::clamp<int64_t>(*value, 0, MAX_BLOCK_SERVE_THREADS);
+    }
 }
 
 } // namespace node
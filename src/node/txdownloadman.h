@@ -9,8 +9,10 @@
 #include <node/txorphanage.h>
 #include <policy/packages.h>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 class CBlock;
 class CRollingBloomFilter;
@@ -140,6 +142,9 @@ public:
     /** Get getdata requests to send. */
     std::vector<GenTxid> GetRequestsToSend(NodeId nodeid, std::chrono::microseconds current_time);
 
+    /** Earliest time at which GetRequestsToSend() may return more for some peer (see TxRequestTracker::NextTimePoint). */
+    std::optional<std::chrono::microseconds> NextRequestTime() const;
+
     /** Should be called when a notfound for a tx has been received. */
     void ReceivedNotFound(NodeId nodeid, const std::vector<GenTxid>& gtxids);
 
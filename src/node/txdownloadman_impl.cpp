@@ -47,6 +47,10 @@ std::vector<GenTxid> TxDownloadManager::GetRequestsToSend(NodeId nodeid, std::ch
 {
     return m_impl->GetRequestsToSend(nodeid, current_time);
 }
+std::optional<std::chrono::microseconds> TxDownloadManager::NextRequestTime() const
+{
+    return m_impl->m_txrequest.NextTimePoint();
+}
 void TxDownloadManager::ReceivedNotFound(NodeId nodeid, const std::vector<GenTxid>& gtxids)
 {
     m_impl->ReceivedNotFound(nodeid, gtxids);
@@ -5,9 +5,16 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
+#include <node/minisketchwrapper.h>
+#include <serialize.h>
 #include <util/check.h>
+#include <util/hasher.h>
 #include <util/log.h>
 
+#include <algorithm>
+#include <cmath>
+#include <set>
 #include <unordered_map>
 #include <variant>
 
@@ -29,6 +36,27 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/** Short transaction ID used in sketches, as specified by BIP-330. Never zero. */
+uint32_t ComputeShortID(const PresaltedSipHasher& hasher, const Wtxid& wtxid)
+{
+    return 1 + uint32_t(hasher(wtxid.ToUint256()) % 0xFFFFFFFF);
+}
+
+/**
+ * Sketch capacity needed to decode the difference between sets of the given sizes. The
+ * difference is estimated as the size difference, plus q times the smaller set for transactions
+ * only one side has, plus one.
+ */
+size_t EstimateSketchCapacity(size_t local_set_size, size_t remote_set_size, double q)
+{
+    const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+    const size_t estimated_diff{set_size_diff + size_t(q * std::min(local_set_size, remote_set_size)) + 1};
+    return std::min(Minisketch::ComputeCapacity(32, estimated_diff, RECON_FALSE_POSITIVE_COEF), MAX_SKETCH_CAPACITY);
+}
+
+/** Once this many fanout decisions are cached they are all dropped. */
+constexpr size_t MAX_FANOUT_CACHE_SIZE{10000};
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +64,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +72,64 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions to be reconciled with the peer in the next round. */
+    std::set<Wtxid> m_local_set;
+
+    /** m_local_set as it was when the current round started, by short ID. */
+    std::unordered_map<uint32_t, Wtxid> m_snapshot;
+
+    /**
+     * Whether a round is in progress: as the initiator we are waiting for a SKETCH, as the
+     * responder we are waiting for a RECONCILDIFF.
+     */
+    bool m_round_in_progress{false};
+
+    /** When the current round started. */
+    std::chrono::microseconds m_round_started{0};
+
+    /**
+     * As the initiator, when we next request a reconciliation. As the responder, when we next
+     * accept a request.
+     */
+    std::chrono::microseconds m_next_request{0};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Move m_local_set into m_snapshot. Transactions whose short ID collides stay for the next round. */
+    void TakeSnapshot()
+    {
+        const PresaltedSipHasher hasher{m_k0, m_k1};
+        m_snapshot.clear();
+        for (auto it = m_local_set.begin(); it != m_local_set.end();) {
+            if (m_snapshot.emplace(ComputeShortID(hasher, *it), *it).second) {
+                it = m_local_set.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /** Return and forget all transactions of m_snapshot. */
+    std::vector<Wtxid> TakeWholeSnapshot()
+    {
+        std::vector<Wtxid> result;
+        result.reserve(m_snapshot.size());
+        for (const auto& [short_id, wtxid] : m_snapshot) result.push_back(wtxid);
+        m_snapshot.clear();
+        return result;
+    }
+
+    /** Build a sketch of m_snapshot with the given capacity. */
+    Minisketch MakeSketch(size_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const auto& [short_id, wtxid] : m_snapshot) sketch.Add(short_id);
+        return sketch;
+    }
 };
 
 } // namespace
@@ -76,6 +151,24 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Salted hasher ranking peers for fanout, per transaction. */
+    const PresaltedSipHasher m_fanout_hasher{FastRandomContext().rand64(), FastRandomContext().rand64()};
+
+    /**
+     * Peers each recent transaction is flooded to. Cached so that the ranking is computed once
+     * per transaction rather than once per (transaction, peer) pair.
+     */
+    std::unordered_map<Wtxid, std::vector<NodeId>, SaltedWtxidHasher> m_fanout_cache GUARDED_BY(m_txreconciliation_mutex);
+
+    TxReconciliationStats m_stats GUARDED_BY(m_txreconciliation_mutex);
+
+    TxReconciliationState* GetRegisteredState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -122,6 +215,7 @@ public:
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
         recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        m_fanout_cache.clear();
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -131,6 +225,7 @@ public:
         LOCK(m_txreconciliation_mutex);
         if (m_states.erase(peer_id)) {
             LogDebug(BCLog::TXRECONCILIATION, "Forget txreconciliation state of peer=%d\n", peer_id);
+            m_fanout_cache.clear();
         }
     }
 
@@ -142,6 +237,198 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state) return false;
+        if (state->m_local_set.contains(wtxid)) return true;
+        if (state->m_local_set.size() >= MAX_RECONSET_SIZE) return false;
+        state->m_local_set.insert(wtxid);
+        ++m_stats.txs_added;
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        return state && state->m_local_set.erase(wtxid) > 0;
+    }
+
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        if (!GetRegisteredState(peer_id)) return true;
+
+        auto it{m_fanout_cache.find(wtxid)};
+        if (it == m_fanout_cache.end()) {
+            if (m_fanout_cache.size() >= MAX_FANOUT_CACHE_SIZE) m_fanout_cache.clear();
+
+            std::vector<std::pair<uint64_t, NodeId>> inbounds, outbounds;
+            for (const auto& [id, recon_state] : m_states) {
+                const auto* state{std::get_if<TxReconciliationState>(&recon_state)};
+                if (!state) continue;
+                (state->m_we_initiate ? outbounds : inbounds).emplace_back(m_fanout_hasher(wtxid.ToUint256(), uint32_t(id)), id);
+            }
+
+            std::vector<NodeId> destinations;
+            const auto pick{[&destinations](std::vector<std::pair<uint64_t, NodeId>>& peers, size_t count) {
+                count = std::min(count, peers.size());
+                std::partial_sort(peers.begin(), peers.begin() + count, peers.end());
+                for (size_t i = 0; i < count; ++i) destinations.push_back(peers[i].second);
+            }};
+            pick(outbounds, OUTBOUND_FANOUT_DESTINATIONS);
+            pick(inbounds, size_t(std::ceil(inbounds.size() * INBOUND_FANOUT_DESTINATIONS_FRACTION)));
+            it = m_fanout_cache.emplace(wtxid, std::move(destinations)).first;
+        }
+        return std::ranges::find(it->second, peer_id) != it->second.end();
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_we_initiate || state->m_round_in_progress) return std::nullopt;
+        if (state->m_next_request > now) return std::nullopt;
+
+        state->m_next_request = now + RECON_REQUEST_INTERVAL;
+        state->TakeSnapshot();
+        state->m_round_in_progress = true;
+        state->m_round_started = now;
+        m_stats.bytes_sent += 2 * sizeof(uint16_t);
+        LogDebug(BCLog::TXRECONCILIATION, "Initiate reconciliation with peer=%d (set size=%d)\n", peer_id, state->m_snapshot.size());
+        return std::make_pair(uint16_t(state->m_snapshot.size()), uint16_t(RECON_Q * Q_PRECISION));
+    }
+
+    util::Expected<std::vector<uint8_t>, ReconciliationRequestError> HandleReconciliationRequest(
+        NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || state->m_we_initiate || state->m_round_in_progress) return util::Unexpected{ReconciliationRequestError::PROTOCOL_VIOLATION};
+        // Every request costs us a snapshot and a sketch, so don't let a peer ask more often than it should.
+        if (state->m_next_request > now) return util::Unexpected{ReconciliationRequestError::RATE_LIMITED};
+
+        state->m_next_request = now + RECON_REQUEST_MIN_INTERVAL;
+        state->TakeSnapshot();
+        state->m_round_in_progress = true;
+        state->m_round_started = now;
+
+        // An empty sketch tells the initiator that neither side has anything to reconcile.
+        std::vector<uint8_t> skdata;
+        if (!state->m_snapshot.empty() || peer_recon_set_size > 0) {
+            // The peer's set can't be larger than ours may be, so a larger claim only inflates the sketch.
+            const size_t remote_set_size{std::min<size_t>(peer_recon_set_size, MAX_RECONSET_SIZE)};
+            const double q{double(peer_q) / Q_PRECISION};
+            skdata = state->MakeSketch(EstimateSketchCapacity(state->m_snapshot.size(), remote_set_size, q)).Serialize();
+        }
+        m_stats.bytes_sent += GetSizeOfCompactSize(skdata.size()) + skdata.size();
+        return skdata;
+    }
+
+    std::optional<ReconciliationSketchResult> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_we_initiate || !state->m_round_in_progress) return std::nullopt;
+        if (skdata.size() % sizeof(uint32_t) != 0 || skdata.size() / sizeof(uint32_t) > MAX_SKETCH_CAPACITY) return std::nullopt;
+        state->m_round_in_progress = false;
+
+        ReconciliationSketchResult result;
+        if (skdata.empty()) {
+            // The peer has nothing; whatever we have, it is missing.
+            result.success = true;
+            result.txs_to_announce = state->TakeWholeSnapshot();
+        } else {
+            const size_t capacity{skdata.size() / sizeof(uint32_t)};
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(skdata);
+            remote_sketch.Merge(state->MakeSketch(capacity));
+            if (const auto differences{remote_sketch.DecodeFP(RECON_FALSE_POSITIVE_COEF)}) {
+                result.success = true;
+                for (const uint64_t short_id : *differences) {
+                    const auto it{state->m_snapshot.find(uint32_t(short_id))};
+                    if (it != state->m_snapshot.end()) {
+                        result.txs_to_announce.push_back(it->second);
+                    } else {
+                        result.txs_to_request.push_back(uint32_t(short_id));
+                    }
+                }
+                state->m_snapshot.clear();
+            } else {
+                result.txs_to_announce = state->TakeWholeSnapshot();
+            }
+        }
+
+        ++(result.success ? m_stats.rounds_succeeded : m_stats.rounds_failed);
+        m_stats.txs_announced += result.txs_to_announce.size();
+        m_stats.bytes_sent += sizeof(uint8_t) + GetSizeOfCompactSize(result.txs_to_request.size()) + result.txs_to_request.size() * sizeof(uint32_t);
+        LogDebug(BCLog::TXRECONCILIATION, "Reconciliation with peer=%d %s: announcing %d, requesting %d\n",
+                 peer_id, result.success ? "succeeded" : "failed", result.txs_to_announce.size(), result.txs_to_request.size());
+        return result;
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || state->m_we_initiate || !state->m_round_in_progress) return std::nullopt;
+        state->m_round_in_progress = false;
+
+        std::vector<Wtxid> result;
+        if (success) {
+            for (const uint32_t short_id : ask_shortids) {
+                const auto it{state->m_snapshot.find(short_id)};
+                if (it == state->m_snapshot.end()) continue;
+                result.push_back(it->second);
+                state->m_snapshot.erase(it);
+            }
+            state->m_snapshot.clear();
+        } else {
+            result = state->TakeWholeSnapshot();
+        }
+
+        ++(success ? m_stats.rounds_succeeded : m_stats.rounds_failed);
+        m_stats.txs_announced += result.size();
+        return result;
+    }
+
+    std::optional<std::vector<Wtxid>> ExpireReconciliationRound(NodeId peer_id, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* state{GetRegisteredState(peer_id)};
+        if (!state || !state->m_round_in_progress || state->m_round_started + RECON_ROUND_TIMEOUT > now) return std::nullopt;
+        state->m_round_in_progress = false;
+
+        // Like a failed round: whatever the peer is missing, it will learn about by inv.
+        auto result{state->TakeWholeSnapshot()};
+        ++m_stats.rounds_failed;
+        m_stats.txs_announced += result.size();
+        LogDebug(BCLog::TXRECONCILIATION, "Reconciliation with peer=%d timed out: announcing %d\n", peer_id, result.size());
+        return result;
+    }
+
+    TxReconciliationStats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        return m_stats;
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +455,49 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id)
+{
+    return m_impl->ShouldFanoutTo(wtxid, peer_id);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+util::Expected<std::vector<uint8_t>, ReconciliationRequestError> TxReconciliationTracker::HandleReconciliationRequest(
+    NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q, std::chrono::microseconds now)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_recon_set_size, peer_q, now);
+}
+
+std::optional<ReconciliationSketchResult> TxReconciliationTracker::HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids)
+{
+    return m_impl->HandleReconciliationDifference(peer_id, success, ask_shortids);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::ExpireReconciliationRound(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->ExpireReconciliationRound(peer_id, now);
+}
+
+TxReconciliationStats TxReconciliationTracker::GetStats() const
+{
+    return m_impl->GetStats();
+}
@@ -6,14 +6,93 @@
 #define BITCOIN_NODE_TXRECONCILIATION_H
 
 #include <net.h>
+#include <primitives/transaction_identifier.h>
 #include <sync.h>
+#include <util/expected.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <tuple>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
 
+/** Interval between reconciliation requests we send to each peer we initiate reconciliations with. */
+static constexpr auto RECON_REQUEST_INTERVAL{8s};
+/**
+ * Reconciliation requests a peer sends sooner than this after its previous one are ignored.
+ * Shorter than RECON_REQUEST_INTERVAL, as varying network latency can bring two requests closer.
+ */
+static constexpr auto RECON_REQUEST_MIN_INTERVAL{RECON_REQUEST_INTERVAL / 2};
+/**
+ * A round the peer does not complete within this time is given up as failed, and our snapshot
+ * is announced by inv.
+ */
+static constexpr auto RECON_ROUND_TIMEOUT{3 * RECON_REQUEST_INTERVAL};
+/**
+ * Maximum number of transactions waiting in a peer's reconciliation set. Once the set is full,
+ * further transactions are announced to that peer by inv instead.
+ */
+static constexpr size_t MAX_RECONSET_SIZE{3000};
+/** Maximum sketch capacity (in elements) we send or accept. */
+static constexpr size_t MAX_SKETCH_CAPACITY{2 << 12};
+/**
+ * Coefficient estimating the set difference from the smaller of the two sets, see BIP-330.
+ * It is sent in REQRECON scaled by Q_PRECISION.
+ */
+static constexpr double RECON_Q{0.25};
+static constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/**
+ * Bits of protection against a sketch decoding to a wrong set difference. Sketches carry a
+ * little more capacity than the estimated difference, so that a too large difference fails
+ * to decode instead.
+ */
+static constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+/** Number of outbound reconciling peers a transaction is still flooded to. */
+static constexpr size_t OUTBOUND_FANOUT_DESTINATIONS{1};
+/** Fraction of inbound reconciling peers a transaction is still flooded to. */
+static constexpr double INBOUND_FANOUT_DESTINATIONS_FRACTION{0.1};
+
+/** Aggregate txreconciliation counters, used to estimate the bandwidth saved over plain inv relay. */
+struct TxReconciliationStats {
+    /** Rounds in which the set difference was decoded. */
+    uint64_t rounds_succeeded{0};
+    /** Rounds which fell back to announcing the full sets. */
+    uint64_t rounds_failed{0};
+    /** Announcements deferred to a reconciliation set instead of being sent as inv. */
+    uint64_t txs_added{0};
+    /** Deferred announcements that were sent as inv after all (set difference or fallback). */
+    uint64_t txs_announced{0};
+    /** Payload bytes of the reqrecon, sketch and reconcildiff messages we sent. */
+    uint64_t bytes_sent{0};
+
+    /** Inv bytes avoided minus reconciliation overhead (one inv entry is 36 bytes). */
+    int64_t EstimatedBytesSaved() const
+    {
+        return int64_t(txs_added - txs_announced) * 36 - int64_t(bytes_sent);
+    }
+};
+
+/** Outcome of processing a sketch as the reconciliation initiator. */
+struct ReconciliationSketchResult {
+    /** Whether the set difference was decoded. Sent back to the peer in RECONCILDIFF. */
+    bool success{false};
+    /** Short IDs of transactions the peer has and we are missing. Sent back in RECONCILDIFF. */
+    std::vector<uint32_t> txs_to_request;
+    /** Transactions from our set the peer is missing, to be announced by inv. */
+    std::vector<Wtxid> txs_to_announce;
+};
+
+enum class ReconciliationRequestError {
+    /** The request came sooner than RECON_REQUEST_MIN_INTERVAL after the previous one. */
+    RATE_LIMITED,
+    PROTOCOL_VIOLATION,
+};
+
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
     SUCCESS,
@@ -32,10 +111,9 @@ enum class ReconciliationRegisterResult {
  * 3.  Once the initiator received a sketch from the peer, the initiator computes a local sketch,
  *     and combines the two sketches to attempt finding the difference in *sets*.
  * 4a. If the difference was not larger than estimated, see SUCCESS below.
- * 4b. If the difference was larger than estimated, initial txreconciliation fails. The initiator
- *     requests a larger sketch via an extension round (allowed only once).
- *     - If extension succeeds (a larger sketch is sufficient), see SUCCESS below.
- *     - If extension fails (a larger sketch is insufficient), see FAILURE below.
+ * 4b. If the difference was larger than estimated, initial txreconciliation fails. BIP-330 lets
+ *     the initiator request a larger sketch via an extension round (allowed only once); this
+ *     implementation does not do extensions yet and goes straight to FAILURE below.
  *
  * SUCCESS. The initiator knows full symmetrical difference and can request what the initiator is
  *          missing and announce to the peer what the peer is missing.
@@ -84,6 +162,62 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a transaction to the set we will reconcile with the peer instead of announcing
+     * it by inv. Returns false if the peer is not registered or its set is full, in which case
+     * the transaction should be announced by inv.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the peer's reconciliation set, e.g. because the peer announced it
+     * to us. Returns whether it was there.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Whether a transaction should still be flooded (announced by inv right away) to a registered
+     * peer rather than added to its set. Per transaction, a deterministic random subset of
+     * OUTBOUND_FANOUT_DESTINATIONS outbound and INBOUND_FANOUT_DESTINATIONS_FRACTION of the
+     * inbound reconciling peers is chosen. Always true for peers which are not registered.
+     */
+    bool ShouldFanoutTo(const Wtxid& wtxid, NodeId peer_id);
+
+    /**
+     * Step 2. If we initiate reconciliations with the peer and it is time to do so, snapshot our
+     * set and return the REQRECON parameters (set size, q).
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. As the responder, snapshot our set and return the serialized sketch for a REQRECON.
+     * Fails if the request violates the protocol, or came too soon after the previous one, in
+     * which case it should be ignored.
+     */
+    util::Expected<std::vector<uint8_t>, ReconciliationRequestError> HandleReconciliationRequest(
+        NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q, std::chrono::microseconds now);
+
+    /**
+     * Steps 3-4. As the initiator, decode the set difference from the peer's sketch.
+     * Returns std::nullopt if the sketch was unexpected or malformed.
+     */
+    std::optional<ReconciliationSketchResult> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata);
+
+    /**
+     * Final step for the responder: return the transactions to announce given the initiator's
+     * RECONCILDIFF (the requested ones on success, the whole snapshot on failure).
+     * Returns std::nullopt if the message was unexpected.
+     */
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids);
+
+    /**
+     * If a round with the peer has been in progress for RECON_ROUND_TIMEOUT, give it up as failed
+     * and return our snapshot, to be announced by inv. Otherwise return std::nullopt.
+     */
+    std::optional<std::vector<Wtxid>> ExpireReconciliationRound(NodeId peer_id, std::chrono::microseconds now);
+
+    TxReconciliationStats GetStats() const;
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
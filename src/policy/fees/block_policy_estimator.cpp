@@ -533,6 +533,9 @@ bool CBlockPolicyEstimator::_removeTx(const Txid& hash, bool inBlock)
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
+        // Transactions that entered the mempool at the current height are not counted by any
+        // estimate yet, so removing them leaves all estimates unchanged.
+        if (pos->second.blockHeight < nBestSeenHeight) InvalidateSmartFeeCache();
         mapMemPoolTxs.erase(hash);
         return true;
     } else {
@@ -558,6 +561,11 @@ CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath
     shortStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
     longStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
 
+    {
+        LOCK(m_cs_smart_fee_cache);
+        for (auto& cache : m_smart_fee_cache) cache.resize(MAX_CACHED_TARGET + 1);
+    }
+
     AutoFile est_file{fsbridge::fopen(m_estimation_filepath, "rb")};
 
     if (est_file.IsNull()) {
@@ -707,6 +715,8 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
     }
 
 
+    InvalidateSmartFeeCache();
+
     LogDebug(BCLog::ESTIMATEFEE, "Blockpolicy estimates updated by %u of %u block txs, since last block %u of %u tracked, mempool map size %u, max target %u from %s\n",
              countedTxs, txs_removed_for_block.size(), trackedTxs, trackedTxs + untrackedTxs, mapMemPoolTxs.size(),
              MaxUsableEstimate(), HistoricalBlockSpan() > BlockSpan() ? "historical" : "current");
@@ -861,6 +871,14 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
     return estimate;
 }
 
+// Start a new cache epoch, so estimateSmartFee recomputes every target.
+void CBlockPolicyEstimator::InvalidateSmartFeeCache()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    LOCK(m_cs_smart_fee_cache);
+    ++m_smart_fee_cache_epoch;
+}
+
 /** estimateSmartFee returns the max of the feerates calculated with a 60%
  * threshold required at target / 2, an 85% threshold required at target and a
  * 95% threshold required at 2 * target.  Each calculation is performed at the
@@ -870,7 +888,30 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
+    const bool cacheable{confTarget > 0 && (unsigned int)confTarget <= MAX_CACHED_TARGET};
+    if (cacheable) {
+        LOCK(m_cs_smart_fee_cache);
+        const auto& cached{m_smart_fee_cache[conservative][confTarget]};
+        if (cached && cached->epoch == m_smart_fee_cache_epoch) {
+            if (feeCalc) *feeCalc = cached->calc;
+            return cached->feerate;
+        }
+    }
+
     LOCK(m_cs_fee_estimator);
+    FeeCalculation calc;
+    const CFeeRate feerate{CalculateSmartFee(confTarget, &calc, conservative)};
+    if (cacheable) {
+        LOCK(m_cs_smart_fee_cache);
+        m_smart_fee_cache[conservative][confTarget] = CachedSmartFee{m_smart_fee_cache_epoch, feerate, calc};
+    }
+    if (feeCalc) *feeCalc = calc;
+    return feerate;
+}
+
+CFeeRate CBlockPolicyEstimator::CalculateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -1052,6 +1093,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            InvalidateSmartFeeCache();
         }
     }
     catch (const std::exception& e) {
@@ -17,6 +17,7 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -156,6 +157,8 @@ private:
     /** Track confirm delays up to 1008 blocks for long horizon */
     static constexpr unsigned int LONG_BLOCK_PERIODS = 42;
     static constexpr unsigned int LONG_SCALE = 24;
+    /** Highest target answered from the estimateSmartFee cache: the longest tracked horizon */
+    static constexpr unsigned int MAX_CACHED_TARGET = LONG_BLOCK_PERIODS * LONG_SCALE;
     /** Historical estimates that are older than this aren't valid */
     static const unsigned int OLDEST_ESTIMATE_HISTORY = 6 * 1008;
 
@@ -206,7 +209,7 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Process a transaction accepted to the mempool*/
     void processTransaction(const NewMempoolTransactionInfo& tx)
@@ -214,7 +217,7 @@ public:
 
     /** Remove a transaction from the mempool tracking stats for non BLOCK removal reasons*/
     bool removeTx(Txid hash)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** DEPRECATED. Return a feerate estimate */
     CFeeRate estimateFee(int confTarget) const
@@ -226,7 +229,7 @@ public:
      *  valid over longer time horizons also.
      */
     virtual CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -242,11 +245,11 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Calculation of highest target that estimates are tracked for */
     virtual unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
@@ -254,7 +257,7 @@ public:
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -268,9 +271,9 @@ protected:
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
 private:
     mutable Mutex m_cs_fee_estimator;
@@ -302,7 +305,7 @@ private:
     std::map<double, unsigned int> bucketMap GUARDED_BY(m_cs_fee_estimator); // Map of bucket upper-bound to index into all vectors by bucket
 
     /** Process a transaction confirmed in a block*/
-    bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
 
     /** Helper for estimateSmartFee */
     double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
@@ -317,7 +320,38 @@ private:
 
     /** A non-thread-safe helper for the removeTx function */
     bool _removeTx(const Txid& hash, bool inBlock)
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
+
+    /** Compute the estimateSmartFee answer from the current stats, bypassing the cache */
+    CFeeRate CalculateSmartFee(int confTarget, FeeCalculation* feeCalc, bool conservative) const
         EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
+    /** Drop all cached estimateSmartFee answers. Must be called whenever the stats change in a way
+     *  that may change an estimate. */
+    void InvalidateSmartFeeCache()
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_smart_fee_cache);
+
+    struct CachedSmartFee {
+        uint64_t epoch;
+        CFeeRate feerate;
+        FeeCalculation calc;
+    };
+
+    /**
+     * Answers to estimateSmartFee, indexed by target and by whether the estimate is conservative.
+     *
+     * Estimates only change when a block is processed, or when a transaction that has been
+     * unconfirmed for at least one block stops being tracked. Transactions entering the mempool
+     * never affect estimates. Between such changes, repeated calls for the same target are
+     * answered from this table without taking m_cs_fee_estimator or walking the buckets.
+     *
+     * Lock order is m_cs_fee_estimator before m_cs_smart_fee_cache. Entries are only written and
+     * invalidated while holding both, so a computed answer can never be stored for stale stats.
+     */
+    mutable Mutex m_cs_smart_fee_cache ACQUIRED_AFTER(m_cs_fee_estimator);
+    mutable std::array<std::vector<std::optional<CachedSmartFee>>, 2> m_smart_fee_cache GUARDED_BY(m_cs_smart_fee_cache);
+    //! Cache entries from an older epoch are stale. Bumped by InvalidateSmartFeeCache().
+    uint64_t m_smart_fee_cache_epoch GUARDED_BY(m_cs_smart_fee_cache){0};
 };
 
 class FeeFilterRounder
@@ -0,0 +1,37 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/fees/mempool_fee_estimator.h>
+
+#include <consensus/consensus.h>
+#include <sync.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+std::optional<CFeeRate> EstimateFeeFromDiagram(std::span<const FeePerWeight> diagram, unsigned int conf_target, int32_t block_weight)
+{
+    Assume(conf_target > 0 && block_weight > 0);
+    if (diagram.empty()) return std::nullopt;
+    const int64_t capacity{int64_t{block_weight} * std::min(conf_target, MAX_MEMPOOL_FEE_TARGET)};
+    if (diagram.back().size <= capacity) return std::nullopt;
+
+    // First diagram point beyond the capacity; the chunk ending there is the
+    // highest feerate chunk which does not fully make it into the target.
+    const auto it{std::upper_bound(diagram.begin(), diagram.end(), capacity,
+                                   [](int64_t weight, const FeePerWeight& point) { return weight < point.size; })};
+    Assume(it != diagram.begin());
+    const FeeFrac chunk{*it - *std::prev(it)};
+    // Convert sat/WU to sat/vB without rounding the chunk weight.
+    return CFeeRate{chunk.fee * WITNESS_SCALE_FACTOR, chunk.size};
+}
+
+std::optional<CFeeRate> EstimateMempoolFee(const CTxMemPool& mempool, unsigned int conf_target)
+{
+    const std::vector<FeePerWeight> diagram{WITH_LOCK(mempool.cs, return mempool.GetFeerateDiagram())};
+    return EstimateFeeFromDiagram(diagram, conf_target);
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POLICY_FEES_MEMPOOL_FEE_ESTIMATOR_H
+#define BITCOIN_POLICY_FEES_MEMPOOL_FEE_ESTIMATOR_H
+
+#include <policy/feerate.h>
+#include <policy/policy.h>
+#include <util/feefrac.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+class CTxMemPool;
+
+/** Largest confirmation target the mempool based estimator answers for. */
+static constexpr unsigned int MAX_MEMPOOL_FEE_TARGET{1008};
+
+/** Weight available to mempool transactions in each simulated block. */
+static constexpr int32_t MEMPOOL_FEE_BLOCK_WEIGHT{DEFAULT_BLOCK_MAX_WEIGHT - DEFAULT_BLOCK_RESERVED_WEIGHT};
+
+/**
+ * Estimate the feerate a transaction needs to be included in one of the next
+ * conf_target blocks, if those blocks were filled from a mempool with the given
+ * feerate diagram and nothing else arrived in the meantime.
+ *
+ * The diagram is the cumulative (fee, weight) curve in block building order, as
+ * returned by CTxMemPool::GetFeerateDiagram(). The estimate is the feerate of the
+ * chunk straddling the end of the conf_target'th block.
+ *
+ * @returns std::nullopt if the whole diagram fits in conf_target blocks, i.e. the
+ *          mempool does not constrain inclusion within the target.
+ */
+std::optional<CFeeRate> EstimateFeeFromDiagram(std::span<const FeePerWeight> diagram, unsigned int conf_target,
+                                               int32_t block_weight = MEMPOOL_FEE_BLOCK_WEIGHT);
+
+/** EstimateFeeFromDiagram() applied to the current contents of the mempool. */
+std::optional<CFeeRate> EstimateMempoolFee(const CTxMemPool& mempool, unsigned int conf_target);
+
+#endif // BITCOIN_POLICY_FEES_MEMPOOL_FEE_ESTIMATOR_H
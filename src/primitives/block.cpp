@@ -5,9 +5,12 @@
 
 #include <primitives/block.h>
 
+#include <crypto/sha256.h>
 #include <hash.h>
+#include <streams.h>
 #include <tinyformat.h>
 
+#include <cassert>
 #include <memory>
 #include <sstream>
 
@@ -16,6 +19,20 @@ uint256 CBlockHeader::GetHash() const
     return (HashWriter{} << *this).GetHash();
 }
 
+std::vector<uint256> GetBlockHeaderHashes(std::span<const CBlockHeader> headers)
+{
+    // Serialize the headers back to back, so that they can be hashed side by side.
+    std::vector<unsigned char> serialized;
+    serialized.reserve(headers.size() * 80);
+    VectorWriter writer{serialized, 0};
+    for (const CBlockHeader& header : headers) writer << header;
+    assert(serialized.size() == headers.size() * 80);
+
+    std::vector<uint256> hashes(headers.size());
+    if (!headers.empty()) SHA256D80(hashes[0].begin(), serialized.data(), headers.size());
+    return hashes;
+}
+
 std::string CBlock::ToString() const
 {
     std::stringstream s;
@@ -12,6 +12,7 @@
 #include <util/time.h>
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -69,6 +70,9 @@ public:
     }
 };
 
+/** Compute the hashes of a batch of block headers, several at a time where the CPU allows. */
+std::vector<uint256> GetBlockHeaderHashes(std::span<const CBlockHeader> headers);
+
 
 class CBlock : public CBlockHeader
 {
@@ -264,6 +264,22 @@ inline constexpr const char* WTXIDRELAY{"wtxidrelay"};
  * txreconciliation, as described by BIP 330.
  */
 inline constexpr const char* SENDTXRCNCL{"sendtxrcncl"};
+/**
+ * Requests a sketch of the peer's reconciliation set. Contains the size of
+ * the sender's set and the q coefficient, as described by BIP 330.
+ */
+inline constexpr const char* REQRECON{"reqrecon"};
+/**
+ * Contains a sketch of the sender's reconciliation set, in reply to
+ * reqrecon, as described by BIP 330.
+ */
+inline constexpr const char* SKETCH{"sketch"};
+/**
+ * Concludes a reconciliation round: whether the set difference was decoded,
+ * and the short IDs of the transactions the sender is missing, as described
+ * by BIP 330.
+ */
+inline constexpr const char* RECONCILDIFF{"reconcildiff"};
 /**
  * BIP 434 Peer feature negotiation
  */
@@ -307,6 +323,9 @@ inline const std::array ALL_NET_MESSAGE_TYPES{std::to_array<std::string>({
     NetMsgType::CFCHECKPT,
     NetMsgType::WTXIDRELAY,
     NetMsgType::SENDTXRCNCL,
+    NetMsgType::REQRECON,
+    NetMsgType::SKETCH,
+    NetMsgType::RECONCILDIFF,
     NetMsgType::FEATURE,
 })};
 
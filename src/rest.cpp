@@ -10,6 +10,7 @@
 #include <chainparams.h>
 #include <core_io.h>
 #include <flatfile.h>
+#include <hash.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
@@ -22,17 +23,23 @@
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
+#include <script/solver.h>
 #include <streams.h>
 #include <sync.h>
+#include <txdb.h>
 #include <txmempool.h>
 #include <undo.h>
 #include <util/any.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <any>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include <univalue.h>
@@ -711,6 +718,181 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
     }
 }
 
+/** What a /rest/range/ request streams for each block in the range. */
+enum class RangeKind {
+    HEADERS,
+    BLOCKS,
+    FILTERS,
+    FILTER_HEADERS,
+};
+
+/** Number of headers, filters or filter headers produced at once while streaming a range. Blocks are produced one by one. */
+static constexpr size_t REST_RANGE_BATCH_SIZE{1000};
+
+static bool rest_range(const std::any& context, HTTPRequest* req, const std::string& uri_part, RangeKind kind, std::string_view uri_format)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+
+    // request is sent over URI scheme /rest/range/<kind>/[<filtertype>/]<start_height>/<count>
+    const std::vector<std::string> uri_parts = SplitString(param, '/');
+    const bool has_filter_type{kind == RangeKind::FILTERS || kind == RangeKind::FILTER_HEADERS};
+    if (uri_parts.size() != (has_filter_type ? 3 : 2)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Invalid URI format. Expected %s", uri_format));
+    }
+
+    BlockFilterIndex* index{nullptr};
+    if (has_filter_type) {
+        BlockFilterType filtertype;
+        if (!BlockFilterTypeByName(uri_parts[0], filtertype)) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Unknown filtertype " + uri_parts[0]);
+        }
+        index = GetBlockFilterIndex(filtertype);
+        if (!index) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled for filtertype " + uri_parts[0]);
+        }
+    }
+
+    const std::string& raw_start{uri_parts[uri_parts.size() - 2]};
+    const std::string& raw_count{uri_parts.back()};
+    const auto start_height{ToIntegral<int32_t>(raw_start)};
+    if (!start_height || *start_height < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + raw_start);
+    }
+    const auto count{ToIntegral<int32_t>(raw_count)};
+    if (!count || *count < 1) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid count: " + raw_count);
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX:
+        break;
+    case RESTResponseFormat::JSON:
+        return RESTERR(req, HTTP_BAD_REQUEST, "JSON output is not supported for this request type");
+    default:
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, hex)");
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+
+    // Take the range of the active chain once, so that it is streamed consistently
+    // even if the chain reorganizes in the meantime. Only blocks are looked up again
+    // later, as their data may be pruned.
+    std::vector<const CBlockIndex*> range;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain{chainman.ActiveChain()};
+        if (*start_height > active_chain.Height()) {
+            return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+        }
+        const int end_height{int(std::min<int64_t>(int64_t{*start_height} + *count - 1, active_chain.Height()))};
+        range.reserve(end_height - *start_height + 1);
+        for (int height{*start_height}; height <= end_height; ++height) {
+            const CBlockIndex* pindex{active_chain[height]};
+            if (kind == RangeKind::BLOCKS && !(pindex->nStatus & BLOCK_HAVE_DATA)) {
+                if (chainman.m_blockman.IsBlockPruned(*pindex)) {
+                    return RESTERR(req, HTTP_NOT_FOUND, strprintf("Block at height %d not available (pruned data)", height));
+                }
+                return RESTERR(req, HTTP_NOT_FOUND, strprintf("Block at height %d not available (not fully downloaded)", height));
+            }
+            range.push_back(pindex);
+        }
+    }
+
+    uint256 filter_header;
+    if (index) {
+        if (!index->BlockUntilSyncedToCurrentChain()) {
+            return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Block filters are still in the process of being indexed.");
+        }
+        if (kind == RangeKind::FILTER_HEADERS && range.front()->pprev &&
+            !index->LookupFilterHeader(range.front()->pprev, filter_header)) {
+            return RESTERR(req, HTTP_NOT_FOUND, "Filter header not found.");
+        }
+    }
+
+    size_t next{0};
+    const auto next_piece{[&](std::vector<std::byte>& piece) {
+        if (chainman.m_interrupt) return http_bitcoin::StreamStatus::FAILED;
+
+        const size_t end{std::min(range.size(), next + REST_RANGE_BATCH_SIZE)};
+        DataStream stream{};
+        switch (kind) {
+        case RangeKind::HEADERS: {
+            for (; next < end; ++next) {
+                stream << range[next]->GetBlockHeader();
+            }
+            break;
+        }
+        case RangeKind::BLOCKS: {
+            const FlatFilePos pos{WITH_LOCK(cs_main, return range[next]->nStatus & BLOCK_HAVE_DATA ? range[next]->GetBlockPos() : FlatFilePos{})};
+            if (pos.IsNull()) return http_bitcoin::StreamStatus::FAILED;
+            auto block_data{chainman.m_blockman.ReadRawBlock(pos)};
+            if (!block_data) return http_bitcoin::StreamStatus::FAILED;
+            stream.write(*block_data);
+            ++next;
+            break;
+        }
+        case RangeKind::FILTERS: {
+            std::vector<BlockFilter> filters;
+            if (!index->LookupFilterRange(range[next]->nHeight, range[end - 1], filters)) return http_bitcoin::StreamStatus::FAILED;
+            for (const BlockFilter& filter : filters) {
+                stream << filter;
+            }
+            next = end;
+            break;
+        }
+        case RangeKind::FILTER_HEADERS: {
+            std::vector<uint256> filter_hashes;
+            if (!index->LookupFilterHashRange(range[next]->nHeight, range[end - 1], filter_hashes)) return http_bitcoin::StreamStatus::FAILED;
+            for (const uint256& filter_hash : filter_hashes) {
+                filter_header = Hash(filter_hash, filter_header);
+                stream << filter_header;
+            }
+            next = end;
+            break;
+        }
+        } // no default case, so the compiler can warn about missing cases
+
+        const bool done{next == range.size()};
+        if (rf == RESTResponseFormat::HEX) {
+            const std::string hex{HexStr(stream) + (done ? "\n" : "")};
+            piece.assign(std::as_bytes(std::span{hex}).begin(), std::as_bytes(std::span{hex}).end());
+        } else {
+            piece.assign(stream.begin(), stream.end());
+        }
+        return done ? http_bitcoin::StreamStatus::DONE : http_bitcoin::StreamStatus::MORE;
+    }};
+
+    req->WriteHeader("Content-Type", rf == RESTResponseFormat::HEX ? "text/plain" : "application/octet-stream");
+    req->WriteReplyStream(HTTP_OK, next_piece);
+    return true;
+}
+
+static bool rest_range_headers(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_range(context, req, uri_part, RangeKind::HEADERS, "/rest/range/headers/<start_height>/<count>.<bin|hex>");
+}
+
+static bool rest_range_blocks(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_range(context, req, uri_part, RangeKind::BLOCKS, "/rest/range/block/<start_height>/<count>.<bin|hex>");
+}
+
+static bool rest_range_filters(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_range(context, req, uri_part, RangeKind::FILTERS, "/rest/range/blockfilter/<filtertype>/<start_height>/<count>.<bin|hex>");
+}
+
+static bool rest_range_filter_headers(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_range(context, req, uri_part, RangeKind::FILTER_HEADERS, "/rest/range/blockfilterheaders/<filtertype>/<start_height>/<count>.<bin|hex>");
+}
+
 // A bit of a hack - dependency on a function defined in rpc/blockchain.cpp
 RPCMethod getblockchaininfo();
 
@@ -1089,6 +1271,117 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
     }
 }
 
+/** Number of coins looked at in one go while streaming the UTXO set. */
+static constexpr size_t REST_UTXOSET_BATCH_SIZE{10000};
+
+static bool rest_utxoset(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+    if (!param.empty()) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/utxoset.<bin|hex>?scripttype=<type>,...&cursor=<txid>-<n>");
+    }
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX:
+        break;
+    case RESTResponseFormat::JSON:
+        return RESTERR(req, HTTP_BAD_REQUEST, "JSON output is not supported for this request type");
+    default:
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, hex)");
+    }
+
+    std::string raw_script_types;
+    std::string raw_cursor;
+    try {
+        raw_script_types = req->GetQueryParameter("scripttype").value_or("");
+        raw_cursor = req->GetQueryParameter("cursor").value_or("");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
+    // Bitmap of the TxoutType values to include, empty to include all coins.
+    std::vector<bool> script_types;
+    for (const auto& name : SplitString(raw_script_types, ',')) {
+        if (name.empty()) continue;
+        script_types.resize(size_t(TxoutType::WITNESS_UNKNOWN) + 1);
+        bool found{false};
+        for (size_t type{0}; type < script_types.size(); ++type) {
+            if (GetTxnOutputType(TxoutType(type)) == name) {
+                script_types[type] = true;
+                found = true;
+            }
+        }
+        if (!found) return RESTERR(req, HTTP_BAD_REQUEST, "Unknown scripttype " + name);
+    }
+
+    std::optional<COutPoint> cursor;
+    if (!raw_cursor.empty()) {
+        const auto txid_out{util::Split<std::string_view>(raw_cursor, '-')};
+        const auto txid{txid_out.size() == 2 ? Txid::FromHex(txid_out[0]) : std::nullopt};
+        const auto output{txid_out.size() == 2 ? ToIntegral<uint32_t>(txid_out[1]) : std::nullopt};
+        if (!txid || !output) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid cursor: " + raw_cursor);
+        }
+        cursor.emplace(*txid, *output);
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+
+    // Iterate over the coins database rather than the coins cache on top of it, so that
+    // nothing needs to be locked or flushed while the export runs. LevelDB iterators read
+    // from an implicit snapshot, and the database is only written to while holding
+    // cs_main, so it is consistent with its best block here.
+    std::unique_ptr<CCoinsViewCursor> pcursor;
+    int height;
+    {
+        LOCK(cs_main);
+        CCoinsViewDB& coins_db{chainman.ActiveChainstate().CoinsDB()};
+        pcursor = cursor ? coins_db.Cursor(*cursor) : coins_db.Cursor();
+        const CBlockIndex* pindex{chainman.m_blockman.LookupBlockIndex(pcursor->GetBestBlock())};
+        if (!pindex) return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "UTXO set is not available");
+        height = pindex->nHeight;
+    }
+    // The cursor is the last coin the client received, so resume after it.
+    COutPoint key;
+    if (cursor && pcursor->Valid() && pcursor->GetKey(key) && key == *cursor) pcursor->Next();
+
+    bool started{false};
+    const auto next_piece{[&](std::vector<std::byte>& piece) {
+        if (chainman.m_interrupt) return http_bitcoin::StreamStatus::FAILED;
+
+        DataStream stream{};
+        if (!started) {
+            stream << pcursor->GetBestBlock() << height;
+            started = true;
+        }
+        Coin coin;
+        std::vector<std::vector<unsigned char>> solutions;
+        for (size_t i{0}; i < REST_UTXOSET_BATCH_SIZE && pcursor->Valid(); ++i, pcursor->Next()) {
+            if (!pcursor->GetKey(key) || !pcursor->GetValue(coin)) return http_bitcoin::StreamStatus::FAILED;
+            if (!script_types.empty() && !script_types[size_t(Solver(coin.out.scriptPubKey, solutions))]) continue;
+            stream << key << uint32_t{coin.nHeight} << coin.IsCoinBase() << coin.out;
+        }
+
+        const bool done{!pcursor->Valid()};
+        if (rf == RESTResponseFormat::HEX) {
+            const std::string hex{HexStr(stream) + (done ? "\n" : "")};
+            piece.assign(std::as_bytes(std::span{hex}).begin(), std::as_bytes(std::span{hex}).end());
+        } else {
+            piece.assign(stream.begin(), stream.end());
+        }
+        return done ? http_bitcoin::StreamStatus::DONE : http_bitcoin::StreamStatus::MORE;
+    }};
+
+    req->WriteHeader("Content-Type", rf == RESTResponseFormat::HEX ? "text/plain" : "application/octet-stream");
+    req->WriteReplyStream(HTTP_OK, next_piece);
+    return true;
+}
+
 static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
                        const std::string& str_uri_part)
 {
@@ -1153,10 +1446,15 @@ static const struct {
     {"/rest/mempool/", rest_mempool},
     {"/rest/headers/", rest_headers},
     {"/rest/getutxos", rest_getutxos},
+    {"/rest/utxoset", rest_utxoset},
     {"/rest/deploymentinfo/", rest_deploymentinfo},
     {"/rest/deploymentinfo", rest_deploymentinfo},
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
     {"/rest/spenttxouts/", rest_spent_txouts},
+    {"/rest/range/headers/", rest_range_headers},
+    {"/rest/range/block/", rest_range_blocks},
+    {"/rest/range/blockfilter/", rest_range_filters},
+    {"/rest/range/blockfilterheaders/", rest_range_filter_headers},
 };
 
 void StartREST(const std::any& context)
@@ -0,0 +1,129 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cbor.h>
+
+#include <crypto/common.h>
+#include <univalue.h>
+#include <util/strencodings.h>
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace {
+enum MajorType : uint8_t {
+    UNSIGNED_INT = 0,
+    NEGATIVE_INT = 1,
+    BYTE_STRING = 2,
+    TEXT_STRING = 3,
+    ARRAY = 4,
+    MAP = 5,
+    TAG = 6,
+    SIMPLE = 7,
+};
+
+constexpr uint64_t TAG_EXPECTED_BASE16{23};
+constexpr std::byte SIMPLE_FALSE{0xf4}, SIMPLE_TRUE{0xf5}, SIMPLE_NULL{0xf6}, FLOAT64{0xfb};
+
+void WriteHead(std::vector<std::byte>& out, MajorType major, uint64_t arg)
+{
+    const auto initial{[&](uint8_t info) { out.push_back(std::byte(major << 5 | info)); }};
+    std::byte buf[8];
+    if (arg < 24) {
+        initial(arg);
+    } else if (arg <= 0xff) {
+        initial(24);
+        out.push_back(std::byte(arg));
+    } else if (arg <= 0xffff) {
+        initial(25);
+        WriteBE16(buf, arg);
+        out.insert(out.end(), buf, buf + 2);
+    } else if (arg <= 0xffffffff) {
+        initial(26);
+        WriteBE32(buf, arg);
+        out.insert(out.end(), buf, buf + 4);
+    } else {
+        initial(27);
+        WriteBE64(buf, arg);
+        out.insert(out.end(), buf, buf + 8);
+    }
+}
+
+bool IsLowerHex(const std::string& str)
+{
+    return str.size() >= CBOR_MIN_HEX_STRING_SIZE && str.size() % 2 == 0 &&
+           str.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+void WriteNumber(std::vector<std::byte>& out, const UniValue& value)
+{
+    const std::string& str{value.getValStr()};
+    if (const auto i{ToIntegral<int64_t>(str)}) {
+        if (*i >= 0) {
+            WriteHead(out, UNSIGNED_INT, *i);
+        } else {
+            WriteHead(out, NEGATIVE_INT, uint64_t(-1 - *i));
+        }
+    } else if (const auto u{ToIntegral<uint64_t>(str)}) {
+        WriteHead(out, UNSIGNED_INT, *u);
+    } else {
+        std::byte buf[8];
+        WriteBE64(buf, std::bit_cast<uint64_t>(value.get_real()));
+        out.push_back(FLOAT64);
+        out.insert(out.end(), buf, buf + 8);
+    }
+}
+
+void Write(std::vector<std::byte>& out, const UniValue& value)
+{
+    switch (value.getType()) {
+    case UniValue::VNULL:
+        out.push_back(SIMPLE_NULL);
+        return;
+    case UniValue::VBOOL:
+        out.push_back(value.get_bool() ? SIMPLE_TRUE : SIMPLE_FALSE);
+        return;
+    case UniValue::VNUM:
+        WriteNumber(out, value);
+        return;
+    case UniValue::VSTR: {
+        const std::string& str{value.get_str()};
+        if (IsLowerHex(str)) {
+            WriteHead(out, TAG, TAG_EXPECTED_BASE16);
+            const auto bytes{ParseHex<std::byte>(str)};
+            WriteHead(out, BYTE_STRING, bytes.size());
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        } else {
+            WriteHead(out, TEXT_STRING, str.size());
+            const auto bytes{std::as_bytes(std::span{str})};
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+        return;
+    }
+    case UniValue::VARR:
+        WriteHead(out, ARRAY, value.size());
+        for (const auto& item : value.getValues()) Write(out, item);
+        return;
+    case UniValue::VOBJ:
+        WriteHead(out, MAP, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            const std::string& key{value.getKeys()[i]};
+            WriteHead(out, TEXT_STRING, key.size());
+            const auto bytes{std::as_bytes(std::span{key})};
+            out.insert(out.end(), bytes.begin(), bytes.end());
+            Write(out, value.getValues()[i]);
+        }
+        return;
+    }
+}
+} // namespace
+
+std::vector<std::byte> EncodeCBOR(const UniValue& value)
+{
+    std::vector<std::byte> out;
+    Write(out, value);
+    return out;
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_CBOR_H
+#define BITCOIN_RPC_CBOR_H
+
+#include <cstddef>
+#include <vector>
+
+class UniValue;
+
+/** Media type of RPC replies encoded with EncodeCBOR(). */
+inline constexpr const char* CBOR_CONTENT_TYPE{"application/cbor"};
+
+/** Hex strings shorter than this many characters are encoded as text. */
+static constexpr size_t CBOR_MIN_HEX_STRING_SIZE{32};
+
+/**
+ * Encode a JSON value as CBOR (RFC 8949), a compact binary alternative for RPC clients.
+ *
+ * Numbers are encoded as integers when they are integral and fit in 64 bits, and as
+ * double precision floats otherwise. Lowercase hex strings of at least
+ * CBOR_MIN_HEX_STRING_SIZE characters (raw transactions, blocks, scripts, hashes) are
+ * encoded as the byte strings they represent, tagged 23 ("expected conversion to
+ * base16"), so that converting the result back to JSON yields the original strings.
+ */
+std::vector<std::byte> EncodeCBOR(const UniValue& value);
+
+#endif // BITCOIN_RPC_CBOR_H
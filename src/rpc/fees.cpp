@@ -8,6 +8,7 @@
 #include <node/context.h>
 #include <policy/feerate.h>
 #include <policy/fees/block_policy_estimator.h>
+#include <policy/fees/mempool_fee_estimator.h>
 #include <rpc/protocol.h>
 #include <rpc/request.h>
 #include <rpc/server.h>
@@ -21,6 +22,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -94,6 +96,49 @@ static RPCMethod estimatesmartfee()
     };
 }
 
+static RPCMethod estimatemempoolfee()
+{
+    return RPCMethod{
+        "estimatemempoolfee",
+        "Estimates the fee per kilobyte needed for a transaction to be included within\n"
+        "conf_target blocks, by filling that many blocks from the current mempool in\n"
+        "block building order. Unlike estimatesmartfee this needs no history, but it\n"
+        "does not anticipate transactions arriving after the call.\n"
+        "Uses virtual transaction size as defined in BIP 141 (witness data is discounted).\n",
+        {
+            {"conf_target", RPCArg::Type::NUM, RPCArg::Optional::NO, strprintf("Confirmation target in blocks (1 - %d)", MAX_MEMPOOL_FEE_TARGET)},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "feerate", "estimate fee rate in " + CURRENCY_UNIT + "/kvB"},
+                {RPCResult::Type::BOOL, "mempoolbound", "whether the mempool holds more than conf_target blocks worth of transactions; "
+                                                        "if false, feerate is the minimum needed for relay"},
+                {RPCResult::Type::NUM, "blocks", "the confirmation target the estimate is for"},
+            }},
+        RPCExamples{
+            HelpExampleCli("estimatemempoolfee", "2") +
+            HelpExampleRpc("estimatemempoolfee", "2")
+        },
+        [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+        {
+            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+            const unsigned int conf_target{ParseConfirmTarget(request.params[0], MAX_MEMPOOL_FEE_TARGET)};
+
+            const std::optional<CFeeRate> estimate{EstimateMempoolFee(mempool, conf_target)};
+            CFeeRate min_mempool_feerate{mempool.GetMinFee()};
+            CFeeRate min_relay_feerate{mempool.m_opts.min_relay_feerate};
+            CFeeRate feerate{std::max({estimate.value_or(CFeeRate{0}), min_mempool_feerate, min_relay_feerate})};
+
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("feerate", ValueFromAmount(feerate.GetFeePerK()));
+            result.pushKV("mempoolbound", estimate.has_value());
+            result.pushKV("blocks", conf_target);
+            return result;
+        },
+    };
+}
+
 static std::vector<RPCResult> FeeRateBucketDoc(bool elide = false)
 {
     auto fields = std::vector<RPCResult>{
@@ -223,6 +268,7 @@ void RegisterFeeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"util", &estimatesmartfee},
+        {"util", &estimatemempoolfee},
         {"hidden", &estimaterawfee},
     };
     for (const auto& c : commands) {
@@ -1207,14 +1207,16 @@ static RPCMethod savemempool()
 {
     const ArgsManager& args{EnsureAnyArgsman(request.context)};
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
 
     if (!mempool.GetLoadTried()) {
         throw JSONRPCError(RPC_MISC_ERROR, "The mempool was not loaded yet");
     }
 
     const fs::path& dump_path = MempoolPath(args);
+    const uint256 chain_tip{WITH_LOCK(cs_main, return chainman.ActiveTip() ? chainman.ActiveTip()->GetBlockHash() : uint256{})};
 
-    if (!DumpMempool(mempool, dump_path)) {
+    if (!DumpMempool(mempool, dump_path, chain_tip)) {
         throw JSONRPCError(RPC_MISC_ERROR, "Unable to dump mempool to disk");
     }
 
@@ -156,6 +156,7 @@ static RPCMethod getpeerinfo()
                     {RPCResult::Type::NUM_TIME, "last_transaction", "The " + UNIX_EPOCH_TIME + " of the last valid transaction received from this peer"},
                     {RPCResult::Type::NUM_TIME, "last_block", "The " + UNIX_EPOCH_TIME + " of the last block received from this peer"},
                     {RPCResult::Type::NUM, "bytessent", "The total bytes sent"},
+                    {RPCResult::Type::NUM, "sendcalls", "The number of send system calls made to the socket"},
                     {RPCResult::Type::NUM, "bytesrecv", "The total bytes received"},
                     {RPCResult::Type::NUM_TIME, "conntime", "The " + UNIX_EPOCH_TIME + " of the connection"},
                     {RPCResult::Type::NUM, "timeoffset", "The time offset in seconds"},
@@ -174,6 +175,10 @@ static RPCMethod getpeerinfo()
                     {
                         {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                     }},
+                    {RPCResult::Type::NUM, "inflight_limit", "The number of blocks we are willing to have in flight from this peer, based on how quickly it delivers them"},
+                    {RPCResult::Type::NUM, "blocks_received", "The number of requested blocks this peer has delivered"},
+                    {RPCResult::Type::NUM, "block_latency", /*optional=*/true, "The average duration in seconds from requesting a block from this peer to receiving it"},
+                    {RPCResult::Type::NUM, "block_transfer_time", /*optional=*/true, "The average duration in seconds this peer takes to send one block, excluding time spent on earlier requests"},
                     {RPCResult::Type::BOOL, "addr_relay_enabled", "Whether we participate in address relay with this peer"},
                     {RPCResult::Type::NUM, "addr_processed", "The total number of addresses processed, excluding those dropped due to rate limiting"},
                     {RPCResult::Type::NUM, "addr_rate_limited", "The total number of addresses dropped due to rate limiting"},
@@ -253,6 +258,7 @@ static RPCMethod getpeerinfo()
         obj.pushKV("last_transaction", count_seconds(stats.m_last_tx_time));
         obj.pushKV("last_block", count_seconds(stats.m_last_block_time));
         obj.pushKV("bytessent", stats.nSendBytes);
+        obj.pushKV("sendcalls", stats.m_send_calls);
         obj.pushKV("bytesrecv", stats.nRecvBytes);
         obj.pushKV("conntime", TicksSinceEpoch<std::chrono::seconds>(stats.m_connected));
         obj.pushKV("timeoffset", Ticks<std::chrono::seconds>(statestats.time_offset));
@@ -281,6 +287,14 @@ static RPCMethod getpeerinfo()
             heights.push_back(height);
         }
         obj.pushKV("inflight", std::move(heights));
+        obj.pushKV("inflight_limit", statestats.m_max_blocks_in_flight);
+        obj.pushKV("blocks_received", statestats.m_blocks_received);
+        if (statestats.m_block_latency) {
+            obj.pushKV("block_latency", Ticks<SecondsDouble>(*statestats.m_block_latency));
+        }
+        if (statestats.m_block_transfer_time) {
+            obj.pushKV("block_transfer_time", Ticks<SecondsDouble>(*statestats.m_block_transfer_time));
+        }
         obj.pushKV("addr_relay_enabled", statestats.m_addr_relay_enabled);
         obj.pushKV("addr_processed", statestats.m_addr_processed);
         obj.pushKV("addr_rate_limited", statestats.m_addr_rate_limited);
@@ -676,6 +690,15 @@ static RPCMethod getnetworkinfo()
                         }},
                         {RPCResult::Type::NUM, "relayfee", "minimum relay fee rate for transactions in " + CURRENCY_UNIT + "/kvB"},
                         {RPCResult::Type::NUM, "incrementalfee", "minimum fee rate increment for mempool limiting or replacement in " + CURRENCY_UNIT + "/kvB"},
+                        {RPCResult::Type::OBJ, "txreconciliation", /*optional=*/true, "transaction reconciliation (BIP 330) statistics, only present if enabled",
+                        {
+                            {RPCResult::Type::NUM, "rounds_succeeded", "reconciliation rounds in which the set difference was decoded"},
+                            {RPCResult::Type::NUM, "rounds_failed", "reconciliation rounds which fell back to announcing the full sets"},
+                            {RPCResult::Type::NUM, "txs_reconciled", "transaction announcements deferred to reconciliation instead of being sent as inv"},
+                            {RPCResult::Type::NUM, "txs_announced", "deferred announcements that were sent as inv after reconciliation"},
+                            {RPCResult::Type::NUM, "bytes_sent", "payload bytes of reconciliation messages sent"},
+                            {RPCResult::Type::NUM, "bytes_saved", "estimated inv bytes saved, net of reconciliation overhead (may be negative)"},
+                        }},
                         {RPCResult::Type::ARR, "localaddresses", "list of local addresses",
                         {
                             {RPCResult::Type::OBJ, "", "",
@@ -729,6 +752,18 @@ static RPCMethod getnetworkinfo()
         obj.pushKV("relayfee", ValueFromAmount(node.mempool->m_opts.min_relay_feerate.GetFeePerK()));
         obj.pushKV("incrementalfee", ValueFromAmount(node.mempool->m_opts.incremental_relay_feerate.GetFeePerK()));
     }
+    if (node.peerman) {
+        if (const auto recon_stats{node.peerman->GetInfo().txreconciliation}) {
+            UniValue recon(UniValue::VOBJ);
+            recon.pushKV("rounds_succeeded", recon_stats->rounds_succeeded);
+            recon.pushKV("rounds_failed", recon_stats->rounds_failed);
+            recon.pushKV("txs_reconciled", recon_stats->txs_added);
+            recon.pushKV("txs_announced", recon_stats->txs_announced);
+            recon.pushKV("bytes_sent", recon_stats->bytes_sent);
+            recon.pushKV("bytes_saved", recon_stats->EstimatedBytesSaved());
+            obj.pushKV("txreconciliation", std::move(recon));
+        }
+    }
     UniValue localAddresses(UniValue::VARR);
     {
         LOCK(g_maplocalhost_mutex);
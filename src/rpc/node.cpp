@@ -27,6 +27,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validationinterface.h>
 
 #include <cstdint>
 #include <limits>
@@ -269,6 +270,43 @@ static RPCMethod logging()
     };
 }
 
+static RPCMethod getvalidationqueueinfo()
+{
+    return RPCMethod{
+        "getvalidationqueueinfo",
+        "Returns the state of the queues that deliver validation notifications (new blocks, mempool transactions, ...)\n"
+        "to their subscribers, such as indexes, wallets and ZMQ.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ_DYN, "", "", {
+                {
+                    RPCResult::Type::OBJ, "name", "The name of the queue",
+                    {
+                        {RPCResult::Type::NUM, "subscribers", "The number of subscribers receiving notifications through the queue"},
+                        {RPCResult::Type::NUM, "pending", "The number of notifications not yet delivered to them"},
+                    }
+                },
+            },
+        },
+        RPCExamples{
+            HelpExampleCli("getvalidationqueueinfo", "")
+          + HelpExampleRpc("getvalidationqueueinfo", "")
+        },
+        [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node{EnsureAnyNodeContext(request.context)};
+    UniValue result(UniValue::VOBJ);
+    for (const auto& queue : CHECK_NONFATAL(node.validation_signals)->GetQueueInfo()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("subscribers", queue.subscribers);
+        entry.pushKV("pending", queue.pending);
+        result.pushKV(queue.name, std::move(entry));
+    }
+    return result;
+},
+    };
+}
+
 static RPCMethod echo(const std::string& name)
 {
     return RPCMethod{
@@ -411,6 +449,7 @@ void RegisterNodeRPCCommands(CRPCTable& t)
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
+        {"control", &getvalidationqueueinfo},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
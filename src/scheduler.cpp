@@ -5,10 +5,12 @@
 #include <scheduler.h>
 
 #include <sync.h>
+#include <util/thread.h>
 #include <util/time.h>
 
 #include <cassert>
 #include <functional>
+#include <string>
 #include <utility>
 
 CScheduler::CScheduler() = default;
@@ -198,3 +200,19 @@ size_t SerialTaskRunner::size()
     LOCK(m_callbacks_mutex);
     return m_callbacks_pending.size();
 }
+
+ThreadedSerialTaskRunner::ThreadedSerialTaskRunner(const std::string& thread_name)
+{
+    m_scheduler.m_service_thread = std::thread(util::TraceThread, thread_name, [this] { m_scheduler.serviceQueue(); });
+}
+
+ThreadedSerialTaskRunner::~ThreadedSerialTaskRunner()
+{
+    m_scheduler.stop();
+}
+
+void ThreadedSerialTaskRunner::flush()
+{
+    m_scheduler.stop();
+    m_runner.flush();
+}
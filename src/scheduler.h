@@ -15,6 +15,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -157,4 +158,29 @@ public:
     size_t size() override EXCLUSIVE_LOCKS_REQUIRED(!m_callbacks_mutex);
 };
 
+/**
+ * SerialTaskRunner with a CScheduler and service thread of its own, so that its
+ * callbacks never wait behind those of other task runners.
+ */
+class ThreadedSerialTaskRunner : public util::TaskRunnerInterface
+{
+private:
+    CScheduler m_scheduler;
+    SerialTaskRunner m_runner{m_scheduler};
+
+public:
+    explicit ThreadedSerialTaskRunner(const std::string& thread_name);
+    ~ThreadedSerialTaskRunner() override;
+
+    void insert(std::function<void()> func) override { m_runner.insert(std::move(func)); }
+
+    /**
+     * Stops the service thread, then processes all remaining queue members on the
+     * calling thread. Callbacks inserted afterwards are only run by another flush().
+     */
+    void flush() override;
+
+    size_t size() override { return m_runner.size(); }
+};
+
 #endif // BITCOIN_SCHEDULER_H
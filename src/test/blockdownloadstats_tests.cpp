@@ -0,0 +1,82 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockdownloadstats.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+using node::BlockDownloadStats;
+
+BOOST_FIXTURE_TEST_SUITE(blockdownloadstats_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(no_samples)
+{
+    BlockDownloadStats stats;
+    BOOST_CHECK_EQUAL(stats.BlocksReceived(), 0U);
+    BOOST_CHECK(!stats.Latency());
+    BOOST_CHECK(!stats.TransferTime());
+    BOOST_CHECK_EQUAL(stats.MaxBlocksInFlight(100ms), node::DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER);
+    // Without measurements only the minimum timeout applies.
+    BOOST_CHECK(!stats.IsStuck(node::BLOCK_STUCK_TIMEOUT_MIN - 1us));
+    BOOST_CHECK(stats.IsStuck(node::BLOCK_STUCK_TIMEOUT_MIN));
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_transfer_time)
+{
+    BlockDownloadStats stats;
+    // Request four blocks at once; they arrive 100ms apart after a 50ms round trip.
+    const auto requested{10s};
+    for (int i = 1; i <= 4; ++i) {
+        stats.BlockReceived(requested, requested + 50ms + i * 100ms);
+    }
+    BOOST_CHECK_EQUAL(stats.BlocksReceived(), 4U);
+    // The first sample includes the round trip, later ones only the time spent on each block.
+    const auto transfer_time{*stats.TransferTime()};
+    BOOST_CHECK(transfer_time > 100ms && transfer_time < 150ms);
+    // Latency grows with the position in the queue.
+    const auto latency{*stats.Latency()};
+    BOOST_CHECK(latency > 150ms && latency < 450ms);
+}
+
+BOOST_AUTO_TEST_CASE(max_blocks_in_flight)
+{
+    // A fast peer is allowed many blocks in flight, up to the cap.
+    BlockDownloadStats fast;
+    fast.BlockReceived(0s, 10ms);
+    BOOST_CHECK_EQUAL(fast.MaxBlocksInFlight(0us), node::MAX_BLOCKS_IN_TRANSIT_PER_PEER_ADAPTIVE);
+
+    // Enough to cover a round trip plus the queue time at the peer's throughput.
+    BlockDownloadStats medium;
+    medium.BlockReceived(0s, 200ms);
+    BOOST_CHECK_EQUAL(medium.MaxBlocksInFlight(0us), 6);
+    BOOST_CHECK_EQUAL(medium.MaxBlocksInFlight(400ms), 8);
+
+    // A slow peer only gets the minimum, so it cannot hold many blocks of the window.
+    BlockDownloadStats slow;
+    slow.BlockReceived(0s, 5s);
+    BOOST_CHECK_EQUAL(slow.MaxBlocksInFlight(100ms), node::MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+}
+
+BOOST_AUTO_TEST_CASE(stuck)
+{
+    BlockDownloadStats stats;
+    stats.BlockReceived(0s, 1s);
+    BOOST_CHECK_EQUAL(stats.Latency()->count(), std::chrono::microseconds{1s}.count());
+    // Never stuck before the minimum timeout, and only once far beyond the usual latency.
+    BOOST_CHECK(!stats.IsStuck(node::BLOCK_STUCK_TIMEOUT_MIN));
+    BOOST_CHECK(!stats.IsStuck(node::BLOCK_STUCK_LATENCY_FACTOR * 1s));
+    BOOST_CHECK(stats.IsStuck(node::BLOCK_STUCK_LATENCY_FACTOR * 1s + 1us));
+
+    // A peer that usually answers quickly is stuck after the minimum timeout.
+    BlockDownloadStats quick;
+    quick.BlockReceived(0s, 10ms);
+    BOOST_CHECK(!quick.IsStuck(node::BLOCK_STUCK_TIMEOUT_MIN - 1us));
+    BOOST_CHECK(quick.IsStuck(node::BLOCK_STUCK_TIMEOUT_MIN));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -355,6 +355,73 @@ BOOST_AUTO_TEST_CASE(ReceiveWithExtraTransactions) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(ShortIDDistributionTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    auto rand_ctx(FastRandomContext(uint256{42}));
+    CBlock block(BuildBlockTestCase(rand_ctx));
+
+    const auto init_data = [&](const TestHeaderAndShortIDs& shortIDs) {
+        DataStream stream{};
+        stream << shortIDs;
+        CBlockHeaderAndShortTxIDs cmpctblock;
+        stream >> cmpctblock;
+        PartiallyDownloadedBlock partial_block(&pool);
+        return partial_block.InitData(cmpctblock, empty_extra_txn);
+    };
+
+    TestHeaderAndShortIDs shortIDs(block, rand_ctx);
+    BOOST_CHECK(init_data(shortIDs) == READ_STATUS_OK);
+
+    // Duplicate short IDs.
+    shortIDs.shorttxids[1] = shortIDs.shorttxids[0];
+    BOOST_CHECK(init_data(shortIDs) == READ_STATUS_FAILED);
+
+    // 100 random short IDs are spread fine.
+    shortIDs.shorttxids.clear();
+    for (int i = 0; i < 100; ++i) shortIDs.shorttxids.push_back(rand_ctx.randbits(48));
+    BOOST_CHECK(init_data(shortIDs) == READ_STATUS_OK);
+
+    // The table is salted, so short IDs picked to share a slot under the unsalted hash are spread too.
+    shortIDs.shorttxids.clear();
+    while (shortIDs.shorttxids.size() < 100) {
+        const uint64_t shortid{rand_ctx.randbits(48)};
+        if ((shortid * 0x9E3779B97F4A7C15ULL) >> (64 - 9) == 0) shortIDs.shorttxids.push_back(shortid);
+    }
+    BOOST_CHECK(init_data(shortIDs) == READ_STATUS_OK);
+}
+
+BOOST_AUTO_TEST_CASE(ShortTxIDTableProbeLimitTest)
+{
+    // With k0 = 0 and k1 = 1 the home slot of a short ID is its top bits, so tests can place them.
+    ShortTxIDTable table(100, /*k0=*/0, /*k1=*/1);
+    BOOST_REQUIRE_EQUAL(table.Size(), 512U);
+    const auto at_slot{[](uint64_t slot, uint64_t low = 0) { return (slot << (64 - 9)) | low; }};
+
+    // Short IDs sharing a home slot fill the following slots, up to MAX_PROBES of them.
+    for (uint64_t i = 0; i < ShortTxIDTable::MAX_PROBES; ++i) {
+        BOOST_CHECK(table.Insert(at_slot(0, i), i) == ShortTxIDTable::InsertResult::OK);
+    }
+    BOOST_CHECK(table.Insert(at_slot(0, 0), 0) == ShortTxIDTable::InsertResult::DUPLICATE);
+    BOOST_CHECK(table.Insert(at_slot(0, ShortTxIDTable::MAX_PROBES), 0) == ShortTxIDTable::InsertResult::OVERLOADED);
+    BOOST_CHECK_EQUAL(table.Find(at_slot(0, ShortTxIDTable::MAX_PROBES - 1)).value(), ShortTxIDTable::MAX_PROBES - 1);
+    BOOST_CHECK(!table.Find(at_slot(0, ShortTxIDTable::MAX_PROBES)));
+
+    // Short IDs with consecutive home slots extend the run of occupied slots past MAX_PROBES,
+    // while each of them is still placed within MAX_PROBES slots of its home slot.
+    for (uint64_t i = 0; i < 30; ++i) {
+        BOOST_CHECK(table.Insert(at_slot(ShortTxIDTable::MAX_PROBES + i), 100 + i) == ShortTxIDTable::InsertResult::OK);
+    }
+    BOOST_CHECK_EQUAL(table.Find(at_slot(ShortTxIDTable::MAX_PROBES + 29)).value(), 129);
+    // Lookups and insertions starting at the front of the run stop after MAX_PROBES slots.
+    BOOST_CHECK(!table.Find(at_slot(0, 1000)));
+    BOOST_CHECK(table.Insert(at_slot(0, 1000), 0) == ShortTxIDTable::InsertResult::OVERLOADED);
+    BOOST_CHECK(table.Insert(at_slot(20, 1000), 0) == ShortTxIDTable::InsertResult::OVERLOADED);
+    // Short IDs whose home slot is free are unaffected.
+    BOOST_CHECK(table.Insert(at_slot(200), 7) == ShortTxIDTable::InsertResult::OK);
+    BOOST_CHECK_EQUAL(table.Find(at_slot(200)).value(), 7);
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = m_rng.rand256();
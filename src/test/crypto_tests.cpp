@@ -849,6 +849,35 @@ BOOST_AUTO_TEST_CASE(chacha20_midblock)
     BOOST_CHECK(std::ranges::equal(std::span{block}.last(52), b3));
 }
 
+BOOST_AUTO_TEST_CASE(chacha20_implementations)
+{
+    // Every multi-block implementation must match the scalar code, including across the 32-bit
+    // block counter overflow and for sizes that leave a partial group of blocks.
+    const auto key{m_rng.randbytes<std::byte>(ChaCha20::KEYLEN)};
+    for (int i = 0; i < 50; ++i) {
+        const auto input{m_rng.randbytes<std::byte>(m_rng.randrange(40 * ChaCha20Aligned::BLOCKLEN))};
+        const ChaCha20::Nonce96 nonce{m_rng.rand32(), m_rng.rand64()};
+        const uint32_t seek{i % 2 ? m_rng.rand32() : 0xffffffff - m_rng.randrange<uint32_t>(40)};
+
+        std::vector<std::byte> expected(input.size());
+        ChaCha20AutoDetect(chacha20_implementation::STANDARD);
+        ChaCha20 scalar{key};
+        scalar.Seek(nonce, seek);
+        scalar.Crypt(input, expected);
+
+        using namespace chacha20_implementation;
+        for (const auto use_implementation : {USE_SSE2, USE_AVX2, USE_AVX512, USE_ALL}) {
+            ChaCha20AutoDetect(use_implementation);
+            std::vector<std::byte> out(input.size());
+            ChaCha20 vec{key};
+            vec.Seek(nonce, seek);
+            vec.Crypt(input, out);
+            BOOST_CHECK(out == expected);
+        }
+    }
+    ChaCha20AutoDetect();
+}
+
 BOOST_AUTO_TEST_CASE(poly1305_testvector)
 {
     // RFC 7539, section 2.5.2.
@@ -1087,6 +1116,22 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d80)
+{
+    for (int i = 0; i <= 32; ++i) {
+        unsigned char in[80 * 32];
+        unsigned char out1[32 * 32], out2[32 * 32];
+        for (int j = 0; j < 80 * i; ++j) {
+            in[j] = m_rng.randbits(8);
+        }
+        for (int j = 0; j < i; ++j) {
+            CHash256().Write({in + 80 * j, 80}).Finalize({out1 + 32 * j, 32});
+        }
+        SHA256D80(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+    }
+}
+
 void CryptoTest::TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
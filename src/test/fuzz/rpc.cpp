@@ -109,6 +109,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "disconnectnode",
     "echo",
     "echojson",
+    "estimatemempoolfee",
     "estimaterawfee",
     "estimatesmartfee",
     "finalizepsbt",
@@ -158,6 +159,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "gettxout",
     "gettxoutsetinfo",
     "gettxspendingprevout",
+    "getvalidationqueueinfo",
     "help",
     "invalidateblock",
     "joinpsbts",
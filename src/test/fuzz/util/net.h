@@ -156,6 +156,8 @@ public:
 
     virtual bool SendMessages(CNode&) override { return m_fdp.ConsumeBool(); }
 
+    virtual bool SendMessagesDue(const CNode&) override { return m_fdp.ConsumeBool(); }
+
 private:
     FuzzedDataProvider& m_fdp;
 };
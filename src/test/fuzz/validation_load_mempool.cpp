@@ -59,5 +59,6 @@ FUZZ_TARGET(validation_load_mempool, .init = initialize_validation_load_mempool)
                           .mockable_fopen_function = fuzzed_fopen,
                       });
     pool.SetLoadTried(true);
-    (void)DumpMempool(pool, MempoolPath(g_setup->m_args), fuzzed_fopen, true);
+    const uint256 chain_tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip() ? chainstate.m_chain.Tip()->GetBlockHash() : uint256{})};
+    (void)DumpMempool(pool, MempoolPath(g_setup->m_args), chain_tip, fuzzed_fopen, true);
 }
@@ -148,6 +148,20 @@ BOOST_AUTO_TEST_CASE(siphash)
         sip288.Write(nb);
         BOOST_CHECK_EQUAL(PresaltedSipHasher(k0, k1)(x, n), sip288.Finalize());
     }
+
+    // Check consistency between single and batch PresaltedSipHasher.
+    PresaltedSipHasher presalted(ctx.rand64(), ctx.rand64());
+    std::array<uint256, PresaltedSipHasher::BATCH> vals;
+    std::array<const uint256*, PresaltedSipHasher::BATCH> val_ptrs;
+    std::array<uint64_t, PresaltedSipHasher::BATCH> hashes;
+    for (size_t i = 0; i < vals.size(); ++i) {
+        vals[i] = m_rng.rand256();
+        val_ptrs[i] = &vals[i];
+    }
+    presalted(val_ptrs, hashes);
+    for (size_t i = 0; i < vals.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], presalted(vals[i]));
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -198,6 +198,30 @@ BOOST_AUTO_TEST_CASE(http_response_tests)
         "\r\n");
 }
 
+BOOST_AUTO_TEST_CASE(http_content_encoding_tests)
+{
+    using http_bitcoin::ContentEncoding;
+    using http_bitcoin::NegotiateContentEncoding;
+
+    BOOST_CHECK(NegotiateContentEncoding("") == ContentEncoding::IDENTITY);
+    BOOST_CHECK(NegotiateContentEncoding("identity") == ContentEncoding::IDENTITY);
+    BOOST_CHECK(NegotiateContentEncoding("br, zstd") == ContentEncoding::IDENTITY);
+    BOOST_CHECK(NegotiateContentEncoding("gzip") == ContentEncoding::GZIP);
+    BOOST_CHECK(NegotiateContentEncoding("x-gzip") == ContentEncoding::GZIP);
+    BOOST_CHECK(NegotiateContentEncoding("DEFLATE") == ContentEncoding::DEFLATE);
+    // gzip is preferred regardless of order or weight
+    BOOST_CHECK(NegotiateContentEncoding("deflate, gzip") == ContentEncoding::GZIP);
+    BOOST_CHECK(NegotiateContentEncoding("deflate;q=1.0, gzip;q=0.5") == ContentEncoding::GZIP);
+    // ...unless it is not acceptable
+    BOOST_CHECK(NegotiateContentEncoding("gzip;q=0, deflate") == ContentEncoding::DEFLATE);
+    BOOST_CHECK(NegotiateContentEncoding("gzip ; Q=0.000, deflate;q=0.001") == ContentEncoding::DEFLATE);
+    BOOST_CHECK(NegotiateContentEncoding("gzip;q=0, deflate;q=0.") == ContentEncoding::IDENTITY);
+    // Wildcard
+    BOOST_CHECK(NegotiateContentEncoding("*") == ContentEncoding::GZIP);
+    BOOST_CHECK(NegotiateContentEncoding("gzip;q=0, *") == ContentEncoding::DEFLATE);
+    BOOST_CHECK(NegotiateContentEncoding("deflate, *;q=0") == ContentEncoding::DEFLATE);
+}
+
 BOOST_AUTO_TEST_CASE(http_request_tests)
 {
     {
@@ -786,4 +810,117 @@ BOOST_AUTO_TEST_CASE(http_socket_error_tests)
     server.StopListening();
 }
 
+BOOST_AUTO_TEST_CASE(http_pipelining_tests)
+{
+    ThreadPool workers("http");
+    workers.Start(2);
+
+    // The reply to the first request is only written after the reply to the second one,
+    // which must still be sent after it.
+    std::promise<void> second_replied;
+    std::shared_future<void> second_replied_future{second_replied.get_future()};
+    HTTPServer server{[&](std::shared_ptr<HTTPRequest> req) {
+        auto item = [req, &second_replied, second_replied_future]() {
+            if (req->m_seq == 0) second_replied_future.wait();
+            req->WriteReply(HTTP_OK, strprintf("reply: %d\n", req->m_seq));
+            if (req->m_seq == 1) second_replied.set_value();
+        };
+        // Can't call BOOST_REQUIRE from worker thread
+        Assert(workers.Submit(std::move(item)));
+    }};
+
+    CService addr_bind{Lookup("0.0.0.0", /*portDefault=*/0, /*fAllowLookup=*/false).value()};
+    BOOST_REQUIRE(server.BindAndStartListening(addr_bind));
+    server.StartSocketsThreads();
+
+    std::string keepalive_request{full_request};
+    keepalive_request.replace(keepalive_request.find("Connection: close"), 17, "Connection: keep-alive");
+    const std::string all_requests{keepalive_request + keepalive_request};
+    std::shared_ptr<DynSock::Pipes> mock_client_socket_pipes{ConnectClient(std::as_bytes(std::span(all_requests)))};
+
+    // Wait up to one minute for both replies
+    std::string actual;
+    char buf[0x10000] = {};
+    int attempts = 6000;
+    while (actual.find("reply: 1") == std::string::npos) {
+        ssize_t bytes_read = mock_client_socket_pipes->send.GetBytes(buf, sizeof(buf), 0);
+        if (bytes_read > 0) actual.append(buf, bytes_read);
+        std::this_thread::sleep_for(10ms);
+        BOOST_REQUIRE(--attempts > 0);
+    }
+    const auto first{actual.find("reply: 0")};
+    BOOST_REQUIRE(first != std::string::npos);
+    BOOST_CHECK(first < actual.find("reply: 1"));
+
+    server.DisconnectAllClients();
+
+    workers.Stop();
+
+    server.InterruptNet();
+    server.JoinSocketsThreads();
+    server.StopListening();
+}
+
+BOOST_AUTO_TEST_CASE(http_streaming_tests)
+{
+    ThreadPool workers("http");
+    workers.Start(2);
+
+    // The first request gets a streamed reply, which the reply to the second request is
+    // written in the middle of. It must still be sent after the end of the stream.
+    std::promise<void> second_replied;
+    std::shared_future<void> second_replied_future{second_replied.get_future()};
+    HTTPServer server{[&](std::shared_ptr<HTTPRequest> req) {
+        auto item = [req, &second_replied, second_replied_future]() {
+            if (req->m_seq == 0) {
+                const std::vector<std::string> pieces{"ab", "", "cde"};
+                size_t next{0};
+                req->WriteReplyStream(HTTP_OK, [&](std::vector<std::byte>& piece) {
+                    if (next == 1) second_replied_future.wait();
+                    piece.assign(std::as_bytes(std::span{pieces[next]}).begin(), std::as_bytes(std::span{pieces[next]}).end());
+                    return ++next == pieces.size() ? http_bitcoin::StreamStatus::DONE : http_bitcoin::StreamStatus::MORE;
+                });
+            } else {
+                req->WriteReply(HTTP_OK, strprintf("reply: %d\n", req->m_seq));
+                second_replied.set_value();
+            }
+        };
+        // Can't call BOOST_REQUIRE from worker thread
+        Assert(workers.Submit(std::move(item)));
+    }};
+
+    CService addr_bind{Lookup("0.0.0.0", /*portDefault=*/0, /*fAllowLookup=*/false).value()};
+    BOOST_REQUIRE(server.BindAndStartListening(addr_bind));
+    server.StartSocketsThreads();
+
+    std::string keepalive_request{full_request};
+    keepalive_request.replace(keepalive_request.find("Connection: close"), 17, "Connection: keep-alive");
+    const std::string all_requests{keepalive_request + keepalive_request};
+    std::shared_ptr<DynSock::Pipes> mock_client_socket_pipes{ConnectClient(std::as_bytes(std::span(all_requests)))};
+
+    // Wait up to one minute for both replies
+    std::string actual;
+    char buf[0x10000] = {};
+    int attempts = 6000;
+    while (actual.find("reply: 1") == std::string::npos) {
+        ssize_t bytes_read = mock_client_socket_pipes->send.GetBytes(buf, sizeof(buf), 0);
+        if (bytes_read > 0) actual.append(buf, bytes_read);
+        std::this_thread::sleep_for(10ms);
+        BOOST_REQUIRE(--attempts > 0);
+    }
+    BOOST_CHECK(actual.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+    BOOST_CHECK(actual.find("Content-Length") == actual.rfind("Content-Length"));
+    const auto body{actual.find("\r\n\r\n2\r\nab\r\n3\r\ncde\r\n0\r\n\r\nHTTP/1.1 200 OK\r\n")};
+    BOOST_CHECK(body != std::string::npos);
+    BOOST_CHECK(body < actual.find("reply: 1"));
+
+    server.DisconnectAllClients();
+
+    workers.Stop();
+
+    server.InterruptNet();
+    server.JoinSocketsThreads();
+    server.StopListening();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <common/system.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <test/util/time.h>
 #include <test/util/txmempool.h>
@@ -142,6 +143,39 @@ BOOST_AUTO_TEST_CASE(MempoolRemoveTest)
     BOOST_CHECK_EQUAL(testPool.size(), 0U);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolEntryPoolTest)
+{
+    // mapTx and mapNextTx nodes are allocated from the mempool's pool resource, and nodes freed by
+    // removed entries are reused by new ones.
+    TestMemPoolEntryHelper entry;
+    std::vector<CMutableTransaction> txs(50);
+    for (size_t i{0}; i < txs.size(); ++i) {
+        txs[i].vin.resize(1);
+        txs[i].vin[0].scriptSig = CScript() << OP_11;
+        txs[i].vin[0].prevout = COutPoint{Txid::FromUint256(uint256{static_cast<uint8_t>(i + 1)}), 0};
+        txs[i].vout.resize(1);
+        txs[i].vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txs[i].vout[0].nValue = 10000LL;
+    }
+
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    const size_t empty_usage{pool.DynamicMemoryUsage()};
+    for (const auto& tx : txs) TryAddToMempool(pool, entry.FromTx(tx));
+    BOOST_CHECK_EQUAL(pool.size(), txs.size());
+    const size_t full_chunks{pool.m_entry_resource.NumAllocatedChunks()};
+    const size_t full_usage{pool.DynamicMemoryUsage()};
+    BOOST_CHECK_GT(full_usage, empty_usage);
+
+    for (const auto& tx : txs) pool.removeRecursive(CTransaction(tx), REMOVAL_REASON_DUMMY);
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+    BOOST_CHECK_LT(pool.DynamicMemoryUsage(), full_usage);
+
+    for (const auto& tx : txs) TryAddToMempool(pool, entry.FromTx(tx));
+    BOOST_CHECK_EQUAL(pool.size(), txs.size());
+    BOOST_CHECK_EQUAL(pool.m_entry_resource.NumAllocatedChunks(), full_chunks);
+}
+
 BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
 {
     auto& pool = static_cast<MemPoolTest&>(*Assert(m_node.mempool));
@@ -168,7 +202,9 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     BOOST_CHECK(pool.exists(tx1.GetHash()));
     BOOST_CHECK(pool.exists(tx2.GetHash()));
 
-    pool.TrimToSize(pool.DynamicMemoryUsage() * 3 / 4); // should remove the lower-feerate transaction
+    // The entry pool keeps its chunks when entries are evicted, so trim relative to the rest of the usage.
+    const size_t pool_usage{memusage::DynamicUsage(pool.m_entry_resource)};
+    pool.TrimToSize(pool_usage + (pool.DynamicMemoryUsage() - pool_usage) * 3 / 4); // should remove the lower-feerate transaction
     BOOST_CHECK(pool.exists(tx1.GetHash()));
     BOOST_CHECK(!pool.exists(tx2.GetHash()));
 
@@ -182,7 +218,8 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     tx3.vout[0].nValue = 10 * COIN;
     TryAddToMempool(pool, entry.Fee(2000LL).FromTx(tx3));
 
-    pool.TrimToSize(pool.DynamicMemoryUsage() * 3 / 4); // tx3 should pay for tx2 (CPFP)
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(pool.m_entry_resource), pool_usage);
+    pool.TrimToSize(pool_usage + (pool.DynamicMemoryUsage() - pool_usage) * 3 / 4); // tx3 should pay for tx2 (CPFP)
     BOOST_CHECK(!pool.exists(tx1.GetHash()));
     BOOST_CHECK(pool.exists(tx2.GetHash()));
     BOOST_CHECK(pool.exists(tx3.GetHash()));
@@ -57,6 +57,22 @@ using node::BlockAssembler;
 using node::BlockCreateOptions;
 
 namespace miner_tests {
+//! Apply a diff to the transactions of the previous template, skipping the coinbase transaction.
+static std::vector<CTransactionRef> ApplyTemplateDiff(std::vector<CTransactionRef> vtx, const node::BlockTemplateDiff& diff)
+{
+    for (auto it{diff.removed.rbegin()}; it != diff.removed.rend(); ++it) vtx.erase(vtx.begin() + *it);
+    for (const auto& added : diff.added) vtx.insert(vtx.begin() + added.index, added.tx);
+    return vtx;
+}
+
+//! Witness txids of the non-coinbase transactions
+static std::vector<Wtxid> HashesOf(const std::vector<CTransactionRef>& vtx)
+{
+    std::vector<Wtxid> hashes;
+    for (size_t i{1}; i < vtx.size(); ++i) hashes.push_back(vtx[i]->GetWitnessHash());
+    return hashes;
+}
+
 struct MinerTestingSetup : public TestingSetup {
     void TestPackageSelection(const CScript& scriptPubKey, const std::vector<CTransactionRef>& txFirst) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     void TestBasicMining(const CScript& scriptPubKey, const std::vector<CTransactionRef>& txFirst, int baseheight) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
@@ -143,6 +159,8 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     // Block template should only have a coinbase when there's nothing in the mempool
     std::unique_ptr<BlockTemplate> block_template = mining->createNewBlock(options, /*cooldown=*/false);
     BOOST_REQUIRE(block_template);
+    // There is no previous template to diff against
+    BOOST_CHECK(!block_template->getDiff());
     CBlock block{block_template->getBlock()};
     BOOST_REQUIRE_EQUAL(block.vtx.size(), 1U);
 
@@ -272,6 +290,14 @@ void MinerTestingSetup::TestPackageSelection(const CScript& scriptPubKey, const
     // waitNext() should return if fees for the new template are at least 1 sat up
     block_template = block_template->waitNext({.fee_threshold = 1});
     BOOST_REQUIRE(block_template);
+    {
+        // Its diff turns the previous template's transactions into its own
+        const auto diff{block_template->getDiff()};
+        BOOST_REQUIRE(diff);
+        const CBlock next{block_template->getBlock()};
+        BOOST_CHECK(diff->header.GetHash() == next.GetHash());
+        BOOST_CHECK(HashesOf(ApplyTemplateDiff(block.vtx, *diff)) == HashesOf(next.vtx));
+    }
     block = block_template->getBlock();
     BOOST_REQUIRE_EQUAL(block.vtx.size(), 6U);
     BOOST_CHECK(block.vtx[4]->GetHash() == hashFreeTx);
@@ -790,6 +816,48 @@ void MinerTestingSetup::TestPrioritisedMining(const CScript& scriptPubKey, const
 }
 
 // NOTE: These tests rely on CreateNewBlock doing its own self-validation!
+BOOST_AUTO_TEST_CASE(block_template_diff)
+{
+    // Distinct transactions, told apart by their lock time. The first one
+    // stands in for the coinbase transaction.
+    std::vector<CTransactionRef> txs;
+    for (uint32_t i{0}; i < 6; ++i) {
+        CMutableTransaction mtx;
+        mtx.nLockTime = i;
+        txs.push_back(MakeTransactionRef(mtx));
+    }
+    const auto make_template{[&](const std::vector<size_t>& positions) {
+        node::CBlockTemplate block_template;
+        block_template.block.vtx.push_back(txs[0]);
+        for (const size_t i : positions) {
+            block_template.block.vtx.push_back(txs[i]);
+            block_template.vTxFees.push_back(i * 100);
+            block_template.vTxSigOpsCost.push_back(i);
+        }
+        return block_template;
+    }};
+
+    const auto previous{make_template({1, 2, 3, 4})};
+    const auto next{make_template({1, 5, 3, 2})};
+    const auto diff{node::GetBlockTemplateDiff(previous.block.vtx, next)};
+
+    // 4 was dropped, 5 is new and 2 moved behind 3, so it is removed and added again
+    BOOST_CHECK(diff.removed == (std::vector<uint32_t>{2, 4}));
+    BOOST_REQUIRE_EQUAL(diff.added.size(), 2U);
+    BOOST_CHECK_EQUAL(diff.added[0].index, 2U);
+    BOOST_CHECK(diff.added[0].tx == txs[5]);
+    BOOST_CHECK_EQUAL(diff.added[0].fee, 500);
+    BOOST_CHECK_EQUAL(diff.added[0].sigops, 5);
+    BOOST_CHECK_EQUAL(diff.added[1].index, 4U);
+    BOOST_CHECK(diff.added[1].tx == txs[2]);
+    BOOST_CHECK(HashesOf(ApplyTemplateDiff(previous.block.vtx, diff)) == HashesOf(next.block.vtx));
+
+    // A template against itself has no changes
+    const auto same{node::GetBlockTemplateDiff(next.block.vtx, next)};
+    BOOST_CHECK(same.removed.empty());
+    BOOST_CHECK(same.added.empty());
+}
+
 BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
 {
     auto mining{MakeMining()};
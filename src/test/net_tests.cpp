@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <ios>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -1626,4 +1627,156 @@ BOOST_AUTO_TEST_CASE(private_broadcast_version_does_not_update_addrman_services)
     m_node.peerman->FinalizeNode(node);
 }
 
+/** A mocked socket that accepts at most m_max_send bytes per Send(). */
+class PartialSendSock : public DynSock
+{
+public:
+    explicit PartialSendSock(std::shared_ptr<Pipes> pipes) : DynSock{std::move(pipes)} {}
+    DynSock& operator=(Sock&&) override { assert(false); return *this; }
+
+    ssize_t Send(const void* buf, size_t len, int flags) const override
+    {
+        return DynSock::Send(buf, std::min(len, m_max_send), flags);
+    }
+
+    size_t m_max_send{std::numeric_limits<size_t>::max()};
+};
+
+BOOST_AUTO_TEST_CASE(socket_send_data_coalescing)
+{
+    auto connman{std::make_unique<ConnmanTestMsg>(0x1337, 0x1337, *m_node.addrman, *m_node.netgroupman, Params())};
+    const auto pipes{std::make_shared<DynSock::Pipes>()};
+    const auto sock{std::make_shared<PartialSendSock>(pipes)};
+    const CAddress addr{Lookup("1.2.3.4", 8333, /*fAllowLookup=*/false).value(), NODE_NONE};
+    CNode node{/*id=*/0,
+               /*sock=*/sock,
+               /*addrIn=*/addr,
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               /*addrBindIn=*/CService{},
+               /*addrNameIn=*/"",
+               /*conn_type_in=*/ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/0};
+
+    const auto queue{[&](CSerializedNetMsg&& msg) {
+        LOCK(node.cs_vSend);
+        node.m_send_memusage += msg.GetMemoryUsage();
+        node.vSendMsg.push_back(std::move(msg));
+    }};
+    const auto send{[&] { return WITH_LOCK(node.cs_vSend, return connman->SocketSendDataPublic(node)); }};
+    const auto stats{[&] {
+        CNodeStats node_stats;
+        node.CopyStats(node_stats);
+        return node_stats;
+    }};
+    constexpr size_t PING_BYTES{CMessageHeader::HEADER_SIZE + sizeof(uint64_t)};
+
+    // Nothing is staged before a message header's worth of bytes has been sent.
+    queue(NetMsg::Make(NetMsgType::PING, uint64_t{0}));
+    BOOST_CHECK_EQUAL(send().first, PING_BYTES);
+    BOOST_CHECK_EQUAL(stats().m_send_calls, 2U);
+
+    // Small messages then go out with a single send call.
+    for (uint64_t nonce{1}; nonce <= 3; ++nonce) queue(NetMsg::Make(NetMsgType::PING, nonce));
+    const auto [sent, data_left]{send()};
+    BOOST_CHECK_EQUAL(sent, 3 * PING_BYTES);
+    BOOST_CHECK(!data_left);
+    BOOST_CHECK_EQUAL(stats().m_send_calls, 3U);
+    BOOST_CHECK_EQUAL(stats().nSendBytes, 4 * PING_BYTES);
+    BOOST_CHECK_EQUAL(stats().mapSendBytesPerMsgType.at(NetMsgType::PING), 4 * PING_BYTES);
+
+    // A payload larger than SEND_COALESCE_BYTES is sent on its own, after what was staged before it.
+    queue(NetMsg::Make(NetMsgType::PING, uint64_t{4}));
+    queue(NetMsg::Make(NetMsgType::BLOCK, std::vector<uint8_t>(SEND_COALESCE_BYTES)));
+    BOOST_CHECK(!send().second);
+    BOOST_CHECK_EQUAL(stats().m_send_calls, 5U);
+    for (size_t i{0}; i < 5; ++i) BOOST_CHECK_EQUAL(pipes->send.GetNetMsg()->m_type, NetMsgType::PING);
+    BOOST_CHECK_EQUAL(pipes->send.GetNetMsg()->m_type, NetMsgType::BLOCK);
+
+    // Staged bytes are only accounted for once the socket accepted them.
+    sock->m_max_send = 10;
+    queue(NetMsg::Make(NetMsgType::PING, uint64_t{5}));
+    BOOST_CHECK(send().second);
+    BOOST_CHECK_EQUAL(stats().mapSendBytesPerMsgType.at(NetMsgType::PING), 5 * PING_BYTES + 10);
+    sock->m_max_send = std::numeric_limits<size_t>::max();
+    BOOST_CHECK(!send().second);
+    BOOST_CHECK_EQUAL(stats().mapSendBytesPerMsgType.at(NetMsgType::PING), 6 * PING_BYTES);
+    BOOST_CHECK_EQUAL(stats().m_send_calls, 7U);
+}
+
+BOOST_AUTO_TEST_CASE(socket_send_data_v2_partial)
+{
+    auto connman{std::make_unique<ConnmanTestMsg>(0x1337, 0x1337, *m_node.addrman, *m_node.netgroupman, Params())};
+    const auto sock{std::make_shared<PartialSendSock>(std::make_shared<DynSock::Pipes>())};
+    const CAddress addr{Lookup("1.2.3.4", 8333, /*fAllowLookup=*/false).value(), NODE_NONE};
+    CNode node{/*id=*/0,
+               /*sock=*/sock,
+               /*addrIn=*/addr,
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               /*addrBindIn=*/CService{},
+               /*addrNameIn=*/"",
+               /*conn_type_in=*/ConnectionType::OUTBOUND_FULL_RELAY,
+               /*inbound_onion=*/false,
+               /*network_key=*/0,
+               CNodeOptions{.use_v2transport = true}};
+
+    // The v2 transport only learns about bytes the socket accepted, so it does not consider a v1
+    // message header's worth sent before it actually was.
+    sock->m_max_send = 10;
+    BOOST_CHECK(WITH_LOCK(node.cs_vSend, return connman->SocketSendDataPublic(node).second));
+    BOOST_CHECK_EQUAL(WITH_LOCK(node.cs_vSend, return node.nSendBytes), 10U);
+    BOOST_CHECK(!node.m_transport->ShouldReconnectV1());
+
+    sock->m_max_send = std::numeric_limits<size_t>::max();
+    BOOST_CHECK(!WITH_LOCK(node.cs_vSend, return connman->SocketSendDataPublic(node).second));
+    BOOST_CHECK(node.m_transport->ShouldReconnectV1());
+}
+
+#ifdef USE_EPOLL
+BOOST_AUTO_TEST_CASE(socket_handler_epoll)
+{
+    auto connman{std::make_unique<ConnmanTestMsg>(0x1337, 0x1337, *m_node.addrman, *m_node.netgroupman, Params())};
+    CConnman::Options options;
+    options.socket_events_mode = SocketEventsMode::EPOLL;
+    connman->Init(options);
+    BOOST_REQUIRE_EQUAL(connman->NumEpollRegistered().value(), 0U);
+
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    const auto sock{std::make_shared<Sock>(fds[0])};
+    auto remote{std::make_unique<Sock>(fds[1])};
+    const CAddress addr{Lookup("1.2.3.4", 8333, /*fAllowLookup=*/false).value(), NODE_NONE};
+    connman->AddTestNode(*new CNode{/*id=*/0,
+                                    /*sock=*/sock,
+                                    /*addrIn=*/addr,
+                                    /*nKeyedNetGroupIn=*/0,
+                                    /*nLocalHostNonceIn=*/0,
+                                    /*addrBindIn=*/CService{},
+                                    /*addrNameIn=*/"",
+                                    /*conn_type_in=*/ConnectionType::INBOUND,
+                                    /*inbound_onion=*/false,
+                                    /*network_key=*/0});
+
+    // A real socket is waited for through epoll, not the WaitMany() fallback.
+    connman->SocketHandlerPublic();
+    BOOST_CHECK_EQUAL(connman->NumEpollRegistered().value(), 1U);
+
+    // The remote end closing disconnects the node...
+    remote.reset();
+    connman->SocketHandlerPublic();
+    CNode& node{*connman->TestNodes().at(0)};
+    BOOST_CHECK(node.fDisconnect);
+    BOOST_CHECK(WITH_LOCK(node.m_sock_mutex, return !node.m_sock));
+
+    // ... and the next round, with no sockets left to wait for, releases its socket.
+    connman->SocketHandlerPublic();
+    BOOST_CHECK_EQUAL(connman->NumEpollRegistered().value(), 0U);
+    BOOST_CHECK_EQUAL(sock.use_count(), 1);
+
+    connman->ClearTestNodes();
+}
+#endif // USE_EPOLL
+
 BOOST_AUTO_TEST_SUITE_END()
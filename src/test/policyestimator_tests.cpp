@@ -4,6 +4,7 @@
 
 #include <policy/fees/block_policy_estimator.h>
 #include <policy/fees/block_policy_estimator_args.h>
+#include <policy/fees/mempool_fee_estimator.h>
 #include <policy/policy.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
@@ -138,6 +139,18 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
         origFeeEst.push_back(feeEst.estimateFee(i).GetFeePerK());
     }
 
+    // Repeated smart fee estimates are answered from the cache and must match the first answer
+    FeeCalculation origSmartFeeCalc;
+    const CFeeRate origSmartFee{feeEst.estimateSmartFee(4, &origSmartFeeCalc, /*conservative=*/false)};
+    BOOST_CHECK(origSmartFee > CFeeRate(0));
+    for (int i = 0; i < 3; i++) {
+        FeeCalculation feeCalc;
+        BOOST_CHECK(feeEst.estimateSmartFee(4, &feeCalc, /*conservative=*/false) == origSmartFee);
+        BOOST_CHECK_EQUAL(feeCalc.returnedTarget, origSmartFeeCalc.returnedTarget);
+        BOOST_CHECK_EQUAL(feeCalc.best_height, origSmartFeeCalc.best_height);
+        BOOST_CHECK(feeCalc.reason == origSmartFeeCalc.reason);
+    }
+
     // Mine 50 more blocks with no transactions happening, estimates shouldn't change
     // We haven't decayed the moving average enough so we still have enough data points in every bucket
     while (blocknum < 250) {
@@ -260,6 +273,60 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     for (int i = 2; i < 9; i++) { // At 9, the original estimate was already at the bottom (b/c scale = 2)
         BOOST_CHECK(feeEst.estimateFee(i).GetFeePerK() < origFeeEst[i-1] - deltaFee);
     }
+    // Cached smart fee estimates must have been refreshed by the new blocks
+    FeeCalculation feeCalc;
+    BOOST_CHECK(feeEst.estimateSmartFee(4, &feeCalc, /*conservative=*/false) < origSmartFee);
+    BOOST_CHECK(feeCalc.best_height > origSmartFeeCalc.best_height);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolDiagramEstimates)
+{
+    // Three chunks of 1000 WU each, at 10, 5 and 2 sat/vB.
+    const std::vector<FeePerWeight> diagram{{0, 0}, {2500, 1000}, {3750, 2000}, {4250, 3000}};
+    BOOST_CHECK(EstimateFeeFromDiagram(diagram, /*conf_target=*/1, /*block_weight=*/500) == CFeeRate(10000));
+    // When the blocks end exactly at a chunk boundary, the next chunk is the first one left out.
+    BOOST_CHECK(EstimateFeeFromDiagram(diagram, /*conf_target=*/2, /*block_weight=*/500) == CFeeRate(5000));
+    BOOST_CHECK(EstimateFeeFromDiagram(diagram, /*conf_target=*/3, /*block_weight=*/500) == CFeeRate(5000));
+    BOOST_CHECK(EstimateFeeFromDiagram(diagram, /*conf_target=*/1, /*block_weight=*/2500) == CFeeRate(2000));
+    BOOST_CHECK(!EstimateFeeFromDiagram(diagram, /*conf_target=*/2, /*block_weight=*/1500));
+    BOOST_CHECK(!EstimateFeeFromDiagram(std::vector<FeePerWeight>{{0, 0}}, /*conf_target=*/1));
+
+    CTxMemPool& mpool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = COIN;
+    const CTransactionRef ptx{MakeTransactionRef(tx)};
+    {
+        LOCK2(cs_main, mpool.cs);
+        TryAddToMempool(mpool, entry.Fee(1000).FromTx(ptx));
+        // A single small transaction never fills a block.
+        BOOST_CHECK(!EstimateMempoolFee(mpool, /*conf_target=*/1));
+        const auto diagram{mpool.GetFeerateDiagram()};
+        BOOST_CHECK_EQUAL(diagram.size(), 2U);
+        BOOST_CHECK_EQUAL(diagram.back().fee, 1000);
+    }
+    // The cached diagram must follow fee deltas.
+    mpool.PrioritiseTransaction(ptx->GetHash(), 500);
+    BOOST_CHECK_EQUAL(WITH_LOCK(mpool.cs, return mpool.GetFeerateDiagram()).back().fee, 1500);
+
+    // ... and dependencies found after a reorg, which merge the chunks of a parent returned from a
+    // disconnected block with its child that stayed in the mempool.
+    CMutableTransaction parent{tx};
+    parent.vin[0].scriptSig = CScript() << OP_2;
+    CMutableTransaction child{tx};
+    child.vin[0].prevout = COutPoint{parent.GetHash(), 0};
+    {
+        LOCK2(cs_main, mpool.cs);
+        TryAddToMempool(mpool, entry.Fee(5000).FromTx(child));
+        TryAddToMempool(mpool, entry.Fee(100).FromTx(parent));
+        BOOST_CHECK_EQUAL(mpool.GetFeerateDiagram().size(), 4U);
+        mpool.UpdateTransactionsFromBlock({parent.GetHash()});
+        BOOST_CHECK_EQUAL(mpool.GetFeerateDiagram().size(), 3U);
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
+#include <rpc/cbor.h>
 #include <rpc/client.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
@@ -13,6 +14,7 @@
 #include <test/util/setup_common.h>
 #include <test/util/time.h>
 #include <univalue.h>
+#include <util/strencodings.h>
 #include <util/time.h>
 
 #include <any>
@@ -643,4 +645,45 @@ BOOST_AUTO_TEST_CASE(rpc_arg_helper)
     CheckRpc(params, UniValue{JSON(R"([5, "hello", 4, "test", true, 1.23, "world"])")}, check_positional);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_cbor)
+{
+    const auto cbor_hex{[](const std::string& json) {
+        UniValue value;
+        BOOST_REQUIRE(value.read(json));
+        return HexStr(EncodeCBOR(value));
+    }};
+    // Examples from RFC 8949 Appendix A
+    BOOST_CHECK_EQUAL(cbor_hex("0"), "00");
+    BOOST_CHECK_EQUAL(cbor_hex("23"), "17");
+    BOOST_CHECK_EQUAL(cbor_hex("24"), "1818");
+    BOOST_CHECK_EQUAL(cbor_hex("1000"), "1903e8");
+    BOOST_CHECK_EQUAL(cbor_hex("1000000"), "1a000f4240");
+    BOOST_CHECK_EQUAL(cbor_hex("1000000000000"), "1b000000e8d4a51000");
+    BOOST_CHECK_EQUAL(cbor_hex("18446744073709551615"), "1bffffffffffffffff");
+    BOOST_CHECK_EQUAL(cbor_hex("-1"), "20");
+    BOOST_CHECK_EQUAL(cbor_hex("-1000"), "3903e7");
+    BOOST_CHECK_EQUAL(cbor_hex("-9223372036854775808"), "3b7fffffffffffffff");
+    BOOST_CHECK_EQUAL(cbor_hex("1.1"), "fb3ff199999999999a");
+    BOOST_CHECK_EQUAL(cbor_hex("-4.1"), "fbc010666666666666");
+    BOOST_CHECK_EQUAL(cbor_hex("false"), "f4");
+    BOOST_CHECK_EQUAL(cbor_hex("true"), "f5");
+    BOOST_CHECK_EQUAL(cbor_hex("null"), "f6");
+    BOOST_CHECK_EQUAL(cbor_hex(R"("")"), "60");
+    BOOST_CHECK_EQUAL(cbor_hex(R"("IETF")"), "6449455446");
+    BOOST_CHECK_EQUAL(cbor_hex("[]"), "80");
+    BOOST_CHECK_EQUAL(cbor_hex("[1,[2,3],[4,5]]"), "8301820203820405");
+    BOOST_CHECK_EQUAL(cbor_hex(R"({"a":1,"b":[2,3]})"), "a26161016162820203");
+    // Amounts are not integral
+    BOOST_CHECK_EQUAL(HexStr(EncodeCBOR(ValueFromAmount(1))), "fb3e45798ee2308c3a");
+
+    // Long lowercase hex strings are tagged byte strings, everything else stays text
+    const std::string hash{"00000000000000000000000000000000000000000000000000000000000000ff"};
+    BOOST_CHECK_EQUAL(cbor_hex("\"" + hash + "\""), "d75820" + hash);
+    BOOST_CHECK_EQUAL(cbor_hex(R"("deadbeef")"), "686465616462656566");
+    const std::string odd{hash.substr(1)};
+    BOOST_CHECK_EQUAL(cbor_hex("\"" + odd + "\""), "783f" + HexStr(odd));
+    const std::string upper{ToUpper(hash)};
+    BOOST_CHECK_EQUAL(cbor_hex("\"" + upper + "\""), "7840" + HexStr(upper));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
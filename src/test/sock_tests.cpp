@@ -6,6 +6,7 @@
 #include <compat/compat.h>
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
+#include <util/eventloop.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
 
@@ -181,4 +182,48 @@ BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
     receiver.join();
 }
 
+BOOST_AUTO_TEST_CASE(socket_events_mode_strings)
+{
+    BOOST_CHECK(SocketEventsModeFromString("waitmany") == SocketEventsMode::WAIT_MANY);
+    BOOST_CHECK(!SocketEventsModeFromString("select"));
+    BOOST_CHECK_EQUAL(SocketEventsModeToString(SocketEventsMode::WAIT_MANY), "waitmany");
+#ifdef USE_EPOLL
+    BOOST_CHECK(SocketEventsModeFromString("epoll") == SocketEventsMode::EPOLL);
+    BOOST_CHECK_EQUAL(SocketEventsModeToString(SocketEventsMode::EPOLL), "epoll");
+#endif
+}
+
+#ifdef USE_EPOLL
+BOOST_AUTO_TEST_CASE(epoll_event_loop)
+{
+    TcpSocketPair socks{};
+    // Non-owning, the pair closes the sockets.
+    const std::shared_ptr<const Sock> sender{std::shared_ptr<const Sock>{}, &socks.sender};
+    const std::shared_ptr<const Sock> receiver{std::shared_ptr<const Sock>{}, &socks.receiver};
+    EpollEventLoop loop;
+
+    Sock::EventsPerSock events{{receiver, Sock::Events{Sock::RecvEvent}}};
+    BOOST_REQUIRE(loop.Wait(0ms, events));
+    BOOST_CHECK_EQUAL(events.at(receiver).occurred, 0);
+    BOOST_CHECK_EQUAL(loop.NumRegistered(), 1U);
+
+    BOOST_REQUIRE_EQUAL(socks.sender.Send("a", 1, 0), 1);
+    BOOST_REQUIRE(loop.Wait(1min, events));
+    BOOST_CHECK_EQUAL(events.at(receiver).occurred, Sock::RecvEvent);
+
+    // Changing the interest of a registered socket takes effect.
+    events.at(receiver).requested = Sock::SendEvent;
+    BOOST_REQUIRE(loop.Wait(1min, events));
+    BOOST_CHECK_EQUAL(events.at(receiver).occurred, Sock::SendEvent);
+    BOOST_CHECK_EQUAL(loop.NumRegistered(), 1U);
+
+    // Sockets left out of the set are unregistered.
+    events.clear();
+    events.emplace(sender, Sock::Events{Sock::RecvEvent});
+    BOOST_REQUIRE(loop.Wait(0ms, events));
+    BOOST_CHECK_EQUAL(events.at(sender).occurred, 0);
+    BOOST_CHECK_EQUAL(loop.NumRegistered(), 1U);
+}
+#endif // USE_EPOLL
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -46,6 +46,7 @@ struct ThreadPoolFixture {
 // 12) Ensure queued tasks complete after Interrupt().
 // 13) Ensure the Stop() calling thread helps drain the queue.
 // 14) Submit range of tasks in one lock acquisition.
+// 15) ParallelFor visits every index once, also from a worker while the others are busy.
 BOOST_FIXTURE_TEST_SUITE(threadpool_tests, ThreadPoolFixture)
 
 #define WAIT_FOR(futures)                                                         \
@@ -496,4 +497,38 @@ BOOST_AUTO_TEST_CASE(submit_range_of_tasks_complete_successfully)
     BOOST_CHECK_EQUAL(threadPool.WorkQueueSize(), 0);
 }
 
+// Test 15, ParallelFor visits every index once, on the calling thread if needed
+BOOST_AUTO_TEST_CASE(parallel_for_visits_every_index)
+{
+    constexpr size_t num_items{100};
+    const auto visits_each_once{[](ThreadPool& pool, size_t max_parallel) {
+        std::array<std::atomic_int, num_items> visits{};
+        pool.ParallelFor(num_items, max_parallel, [&](size_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+        return std::ranges::all_of(visits, [](const auto& v) { return v.load() == 1; });
+    }};
+
+    // Not started: everything runs on the calling thread.
+    ThreadPool threadPool(POOL_NAME);
+    BOOST_CHECK(visits_each_once(threadPool, 4));
+    bool called{false};
+    threadPool.ParallelFor(0, 4, [&](size_t) { called = true; });
+    BOOST_CHECK(!called);
+
+    threadPool.Start(NUM_WORKERS_DEFAULT);
+    BOOST_CHECK(visits_each_once(threadPool, 1));
+    BOOST_CHECK(visits_each_once(threadPool, NUM_WORKERS_DEFAULT + 1));
+
+    // From within a task while all other workers are blocked: the caller does all the work and
+    // the helper tasks it queued return without touching the finished range.
+    std::counting_semaphore<> blocker(0);
+    const auto& blocking_tasks = BlockWorkers(threadPool, blocker, NUM_WORKERS_DEFAULT - 1);
+    auto nested{Submit(threadPool, [&] { return visits_each_once(threadPool, 4); })};
+    BOOST_REQUIRE(nested.wait_for(TEST_WAIT_TIMEOUT) == std::future_status::ready);
+    BOOST_CHECK(nested.get());
+    blocker.release(NUM_WORKERS_DEFAULT - 1);
+    WAIT_FOR(blocking_tasks);
+    threadPool.Stop();
+    BOOST_CHECK_EQUAL(threadPool.WorkQueueSize(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
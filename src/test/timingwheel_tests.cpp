@@ -0,0 +1,108 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <util/timingwheel.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(timingwheel_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(timingwheel_basic)
+{
+    TimingWheel<int> wheel{1ms};
+    BOOST_CHECK(wheel.empty());
+    BOOST_CHECK(!wheel.NextDeadline());
+
+    wheel.Schedule(1, 10ms);
+    wheel.Schedule(2, 5s);
+    wheel.Schedule(3, 2h);
+    BOOST_CHECK_EQUAL(wheel.size(), 3U);
+    BOOST_CHECK(*wheel.NextDeadline() <= 10ms);
+
+    BOOST_CHECK(wheel.Advance(9ms).empty());
+    BOOST_CHECK(wheel.Advance(10ms) == std::vector<int>{1});
+    BOOST_CHECK(!wheel.contains(1));
+
+    // Rescheduling replaces the deadline.
+    wheel.Schedule(2, 20ms);
+    BOOST_CHECK_EQUAL(wheel.size(), 2U);
+    BOOST_CHECK(wheel.Advance(1s) == std::vector<int>{2});
+
+    // Cancelled keys never expire.
+    BOOST_CHECK(wheel.Cancel(3));
+    BOOST_CHECK(!wheel.Cancel(3));
+    BOOST_CHECK(wheel.Advance(3h).empty());
+    BOOST_CHECK(wheel.empty());
+
+    // Deadlines in the past expire on the next Advance().
+    wheel.Schedule(4, 1h);
+    BOOST_CHECK(wheel.Advance(3h) == std::vector<int>{4});
+
+    // Deadlines are rounded up to the resolution, never early.
+    TimingWheel<int> coarse{100ms};
+    coarse.Schedule(5, 150ms);
+    BOOST_CHECK(coarse.Advance(199ms).empty());
+    BOOST_CHECK(coarse.Advance(200ms) == std::vector<int>{5});
+}
+
+BOOST_AUTO_TEST_CASE(timingwheel_backwards)
+{
+    TimingWheel<int> wheel{1ms};
+    wheel.Schedule(1, 10s);
+    BOOST_CHECK(wheel.Advance(5s).empty());
+    // Time going backwards does not expire anything.
+    BOOST_CHECK(wheel.Advance(1s).empty());
+    BOOST_CHECK(wheel.Advance(10s) == std::vector<int>{1});
+}
+
+BOOST_AUTO_TEST_CASE(timingwheel_random)
+{
+    // Compare against a plain map, with deadlines and time steps spanning many levels.
+    TimingWheel<int> wheel{1ms};
+    std::map<int, std::chrono::milliseconds> model;
+    std::chrono::milliseconds now{0};
+    for (int i = 0; i < 20000; ++i) {
+        const int key{int(m_rng.randrange(500))};
+        switch (m_rng.randrange(4)) {
+        case 0:
+        case 1: {
+            const std::chrono::milliseconds deadline{now + std::chrono::milliseconds{m_rng.randrange(uint64_t{1} << m_rng.randrange(32))}};
+            wheel.Schedule(key, deadline);
+            model[key] = deadline;
+            break;
+        }
+        case 2:
+            BOOST_CHECK_EQUAL(wheel.Cancel(key), model.erase(key) > 0);
+            break;
+        case 3: {
+            now += std::chrono::milliseconds{m_rng.randrange(uint64_t{1} << m_rng.randrange(24))};
+            auto expired{wheel.Advance(now)};
+            std::vector<int> expected;
+            for (auto it = model.begin(); it != model.end();) {
+                if (it->second <= now) {
+                    expected.push_back(it->first);
+                    it = model.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            std::ranges::sort(expired);
+            BOOST_CHECK(expired == expected);
+            if (const auto next{wheel.NextDeadline()}) {
+                for (const auto& [_, deadline] : model) BOOST_CHECK(*next <= deadline);
+            }
+            break;
+        }
+        }
+        BOOST_CHECK_EQUAL(wheel.size(), model.size());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,9 @@
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
 
+#include <algorithm>
+#include <limits>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
@@ -82,4 +85,199 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(ReconciliationRoundTest)
+{
+    // Two nodes, each tracking the other as peer 0: we initiate (the peer is outbound) and they respond.
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(0, /*is_peer_inbound=*/false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(0, /*is_peer_inbound=*/true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+
+    // Transactions only the initiator has, only the responder has, and both have.
+    std::vector<Wtxid> initiator_only, responder_only;
+    for (int i = 0; i < 10; ++i) initiator_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+    for (int i = 0; i < 5; ++i) responder_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+    for (const auto& wtxid : initiator_only) BOOST_CHECK(initiator.AddToSet(0, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_CHECK(responder.AddToSet(0, wtxid));
+    for (int i = 0; i < 10; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_CHECK(initiator.AddToSet(0, wtxid));
+        BOOST_CHECK(responder.AddToSet(0, wtxid));
+    }
+
+    // Only the initiator requests, and only once per round.
+    BOOST_CHECK(!responder.InitiateReconciliationRequest(0, 0s));
+    const auto request{initiator.InitiateReconciliationRequest(0, 0s)};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK_EQUAL(request->first, 20);
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, 100s));
+
+    // Messages in the wrong role or order are protocol violations.
+    BOOST_CHECK(initiator.HandleReconciliationRequest(0, request->first, request->second, 0s).error() == ReconciliationRequestError::PROTOCOL_VIOLATION);
+    BOOST_CHECK(!responder.HandleReconciliationDifference(0, true, {}));
+
+    BOOST_CHECK_EQUAL(request->second, uint16_t(RECON_Q * Q_PRECISION));
+    // Use q=1 so that the sketch fits the difference (15 transactions) between sets of 20 and 15.
+    const auto skdata{responder.HandleReconciliationRequest(0, request->first, Q_PRECISION, 0s)};
+    BOOST_REQUIRE(skdata);
+    BOOST_CHECK(!skdata->empty());
+    BOOST_CHECK(!responder.HandleSketch(0, *skdata));
+
+    const auto result{initiator.HandleSketch(0, *skdata)};
+    BOOST_REQUIRE(result);
+    BOOST_CHECK(result->success);
+    BOOST_CHECK_EQUAL(result->txs_to_request.size(), responder_only.size());
+    auto announced{result->txs_to_announce};
+    std::ranges::sort(announced);
+    std::ranges::sort(initiator_only);
+    BOOST_CHECK(announced == initiator_only);
+
+    auto responder_announced{*Assert(responder.HandleReconciliationDifference(0, true, result->txs_to_request))};
+    std::ranges::sort(responder_announced);
+    std::ranges::sort(responder_only);
+    BOOST_CHECK(responder_announced == responder_only);
+
+    // Each side deferred 20 announcements and sent only its part of the difference.
+    const auto initiator_stats{initiator.GetStats()};
+    BOOST_CHECK_EQUAL(initiator_stats.rounds_succeeded, 1U);
+    BOOST_CHECK_EQUAL(initiator_stats.txs_added, 20U);
+    BOOST_CHECK_EQUAL(initiator_stats.txs_announced, 10U);
+    BOOST_CHECK_EQUAL(responder.GetStats().txs_announced, 5U);
+    BOOST_CHECK_GT(responder.GetStats().EstimatedBytesSaved(), 0);
+
+    // Next round only after RECON_REQUEST_INTERVAL.
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, RECON_REQUEST_INTERVAL - 1s));
+    BOOST_CHECK(initiator.InitiateReconciliationRequest(0, RECON_REQUEST_INTERVAL));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationFallbackTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(0, false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(0, true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+
+    // Disjoint sets of equal size: with q=0 the sketch can't hold the difference.
+    for (int i = 0; i < 20; ++i) {
+        BOOST_CHECK(initiator.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+        BOOST_CHECK(responder.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    const auto request{*Assert(initiator.InitiateReconciliationRequest(0, 0s))};
+    const auto skdata{responder.HandleReconciliationRequest(0, request.first, /*peer_q=*/0, 0s).value()};
+
+    // Malformed sketches are rejected without ending the round.
+    BOOST_CHECK(!initiator.HandleSketch(0, std::vector<uint8_t>(3)));
+    BOOST_CHECK(!initiator.HandleSketch(0, std::vector<uint8_t>((MAX_SKETCH_CAPACITY + 1) * 4)));
+
+    const auto result{*Assert(initiator.HandleSketch(0, skdata))};
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(result.txs_to_request.empty());
+    BOOST_CHECK_EQUAL(result.txs_to_announce.size(), 20U);
+    BOOST_CHECK_EQUAL(Assert(responder.HandleReconciliationDifference(0, false, {}))->size(), 20U);
+    BOOST_CHECK_EQUAL(initiator.GetStats().rounds_failed, 1U);
+    BOOST_CHECK_EQUAL(responder.GetStats().rounds_failed, 1U);
+
+    // Both sets empty: an empty sketch, and nothing to announce.
+    const auto empty_request{*Assert(initiator.InitiateReconciliationRequest(0, RECON_REQUEST_INTERVAL))};
+    BOOST_CHECK_EQUAL(empty_request.first, 0);
+    const auto empty_sketch{responder.HandleReconciliationRequest(0, empty_request.first, empty_request.second, RECON_REQUEST_INTERVAL).value()};
+    BOOST_CHECK(empty_sketch.empty());
+    const auto empty_result{*Assert(initiator.HandleSketch(0, empty_sketch))};
+    BOOST_CHECK(empty_result.success);
+    BOOST_CHECK(empty_result.txs_to_announce.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationLimitsTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(0, false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(0, true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK(initiator.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+        BOOST_CHECK(responder.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+
+    // The claimed set size of the peer is capped at MAX_RECONSET_SIZE when sizing the sketch.
+    const auto skdata{responder.HandleReconciliationRequest(0, std::numeric_limits<uint16_t>::max(), Q_PRECISION, 0s).value()};
+    BOOST_CHECK_GE(skdata.size(), 4 * MAX_RECONSET_SIZE);
+    BOOST_CHECK_LE(skdata.size(), 4 * (MAX_RECONSET_SIZE + RECON_FALSE_POSITIVE_COEF));
+    BOOST_CHECK(responder.HandleReconciliationDifference(0, false, {}));
+
+    // Requests sooner than RECON_REQUEST_MIN_INTERVAL after the previous one are ignored.
+    BOOST_CHECK(responder.HandleReconciliationRequest(0, 0, 0, RECON_REQUEST_MIN_INTERVAL - 1s).error() == ReconciliationRequestError::RATE_LIMITED);
+    BOOST_CHECK(responder.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    BOOST_CHECK(responder.HandleReconciliationRequest(0, 0, 0, RECON_REQUEST_MIN_INTERVAL));
+
+    // A round the initiator does not complete is given up after RECON_ROUND_TIMEOUT, and the
+    // transactions snapshotted for it are announced instead.
+    BOOST_CHECK(!responder.ExpireReconciliationRound(0, RECON_REQUEST_MIN_INTERVAL + RECON_ROUND_TIMEOUT - 1s));
+    const auto responder_expired{responder.ExpireReconciliationRound(0, RECON_REQUEST_MIN_INTERVAL + RECON_ROUND_TIMEOUT)};
+    BOOST_REQUIRE(responder_expired);
+    BOOST_CHECK_EQUAL(responder_expired->size(), 1U);
+    BOOST_CHECK(!responder.ExpireReconciliationRound(0, 1000s));
+    BOOST_CHECK(!responder.HandleReconciliationDifference(0, true, {}));
+    BOOST_CHECK_EQUAL(responder.GetStats().rounds_failed, 2U);
+
+    // Same for a responder that never sends its sketch, after which the initiator can start over.
+    BOOST_REQUIRE(initiator.InitiateReconciliationRequest(0, 0s));
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, RECON_ROUND_TIMEOUT));
+    BOOST_CHECK(!initiator.ExpireReconciliationRound(0, RECON_ROUND_TIMEOUT - 1s));
+    BOOST_CHECK_EQUAL(Assert(initiator.ExpireReconciliationRound(0, RECON_ROUND_TIMEOUT))->size(), 5U);
+    BOOST_CHECK(!initiator.HandleSketch(0, {}));
+    BOOST_CHECK(initiator.InitiateReconciliationRequest(0, RECON_ROUND_TIMEOUT));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Not registered.
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(0, wtxid));
+
+    // Full sets reject further transactions, which then have to be announced by inv.
+    for (size_t i = 0; i < MAX_RECONSET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    BOOST_CHECK_EQUAL(tracker.GetStats().txs_added, MAX_RECONSET_SIZE + 1);
+}
+
+BOOST_AUTO_TEST_CASE(ShouldFanoutToTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+
+    // Peers 0-19 are inbound, 20-23 outbound; peer 100 does not reconcile.
+    for (NodeId peer_id = 0; peer_id < 24; ++peer_id) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/peer_id < 20, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_CHECK(tracker.ShouldFanoutTo(wtxid, 100));
+        size_t inbound_destinations{0}, outbound_destinations{0};
+        for (NodeId peer_id = 0; peer_id < 24; ++peer_id) {
+            const bool fanout{tracker.ShouldFanoutTo(wtxid, peer_id)};
+            // The choice is stable for a given transaction.
+            BOOST_CHECK_EQUAL(fanout, tracker.ShouldFanoutTo(wtxid, peer_id));
+            if (fanout) ++(peer_id < 20 ? inbound_destinations : outbound_destinations);
+        }
+        BOOST_CHECK_EQUAL(inbound_destinations, 2U);
+        BOOST_CHECK_EQUAL(outbound_destinations, OUTBOUND_FANOUT_DESTINATIONS);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
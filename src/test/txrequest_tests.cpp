@@ -756,4 +756,25 @@ BOOST_AUTO_TEST_CASE(TxRequestTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(NextTimePointTest)
+{
+    TxRequestTracker txrequest(/*deterministic=*/true);
+    BOOST_CHECK(!txrequest.NextTimePoint());
+
+    const auto txid1{Txid::FromUint256(m_rng.rand256())}, txid2{Txid::FromUint256(m_rng.rand256())};
+    txrequest.ReceivedInv(/*peer=*/0, txid1, /*preferred=*/true, /*reqtime=*/10s);
+    txrequest.ReceivedInv(/*peer=*/1, txid2, /*preferred=*/true, /*reqtime=*/5s);
+    BOOST_CHECK(txrequest.NextTimePoint() == 5s);
+
+    // Requestable announcements have no future event; requested ones expire.
+    BOOST_CHECK_EQUAL(txrequest.GetRequestable(1, 6s).size(), 1U);
+    BOOST_CHECK(txrequest.NextTimePoint() == 10s);
+    txrequest.RequestedTx(1, txid2.ToUint256(), /*expiry=*/8s);
+    BOOST_CHECK(txrequest.NextTimePoint() == 8s);
+    txrequest.ReceivedResponse(1, txid2.ToUint256());
+    BOOST_CHECK(txrequest.NextTimePoint() == 10s);
+    BOOST_CHECK_EQUAL(txrequest.GetRequestable(0, 10s).size(), 1U);
+    BOOST_CHECK(!txrequest.NextTimePoint());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -54,6 +54,54 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_reject_coinbase, TestChain100Setup)
     BOOST_CHECK(result.m_state.GetResult() == TxValidationResult::TX_CONSENSUS);
 }
 
+/**
+ * Ensure that a batch of transactions, including chains and invalid transactions, gets the same
+ * results as submitting each transaction individually.
+ */
+BOOST_FIXTURE_TEST_CASE(tx_mempool_accept_batch, TestChain100Setup)
+{
+    // Mine blocks to mature coinbases.
+    mineBlocks(4);
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const int tip_height{WITH_LOCK(cs_main, return m_node.chainman->ActiveHeight())};
+    const int64_t accept_time{GetTime()};
+
+    std::vector<std::pair<CTransactionRef, int64_t>> batch;
+    std::vector<CTransactionRef> parents;
+    for (size_t i{0}; i < 4; ++i) {
+        parents.push_back(MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[i], /*input_vout=*/0, tip_height, coinbaseKey,
+                                                                           script_pub_key, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)));
+    }
+    const auto child{MakeTransactionRef(CreateValidMempoolTransaction(parents[0], /*input_vout=*/0, tip_height, coinbaseKey,
+                                                                      script_pub_key, /*output_amount=*/CAmount(48 * COIN), /*submit=*/false))};
+    auto mtx_bad_sig{CreateValidMempoolTransaction(m_coinbase_txns[4], /*input_vout=*/0, tip_height, coinbaseKey,
+                                                   script_pub_key, /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    mtx_bad_sig.vin[0].scriptSig = CScript() << std::vector<unsigned char>(71, 0x30);
+    const auto bad_sig{MakeTransactionRef(mtx_bad_sig)};
+
+    batch.emplace_back(parents[0], accept_time);
+    batch.emplace_back(child, accept_time);
+    batch.emplace_back(bad_sig, accept_time);
+    for (size_t i{1}; i < parents.size(); ++i) batch.emplace_back(parents[i], accept_time);
+
+    const auto results{AcceptToMemoryPoolBatch(m_node.chainman->ActiveChainstate(), batch, /*bypass_limits=*/false)};
+    BOOST_REQUIRE_EQUAL(results.size(), batch.size());
+    for (size_t i{0}; i < batch.size(); ++i) {
+        const bool expect_valid{batch[i].first != bad_sig};
+        BOOST_CHECK_EQUAL(results[i].m_result_type == MempoolAcceptResult::ResultType::VALID, expect_valid);
+        BOOST_CHECK_EQUAL(m_node.mempool->exists(batch[i].first->GetHash()), expect_valid);
+    }
+    BOOST_CHECK(results[2].m_state.GetResult() == TxValidationResult::TX_NOT_STANDARD);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), parents.size() + 1);
+
+    // Resubmitting the same batch accepts nothing new.
+    const auto results_again{AcceptToMemoryPoolBatch(m_node.chainman->ActiveChainstate(), batch, /*bypass_limits=*/false)};
+    for (const auto& result : results_again) {
+        BOOST_CHECK(result.m_result_type != MempoolAcceptResult::ResultType::VALID);
+    }
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), parents.size() + 1);
+}
+
 // Generate a number of random, nonexistent outpoints.
 static inline std::vector<COutPoint> random_outpoints(size_t num_outpoints) {
     std::vector<COutPoint> outpoints;
@@ -16,6 +16,7 @@
 #include <node/eviction.h>
 #include <span.h>
 #include <sync.h>
+#include <util/eventloop.h>
 #include <util/sock.h>
 
 #include <algorithm>
@@ -94,6 +95,21 @@ struct ConnmanTestMsg : public CConnman {
         SocketHandler();
     }
 
+    std::pair<size_t, bool> SocketSendDataPublic(CNode& node) const EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend)
+    {
+        return SocketSendData(node);
+    }
+
+#ifdef USE_EPOLL
+    /** Number of sockets registered with the epoll event loop, if that is in use. */
+    std::optional<size_t> NumEpollRegistered() const
+    {
+        const auto* loop{dynamic_cast<const EpollEventLoop*>(m_event_loop.get())};
+        if (!loop) return std::nullopt;
+        return loop->NumRegistered();
+    }
+#endif
+
     void Handshake(CNode& node,
                    bool successfully_connected,
                    ServiceFlags remote_services,
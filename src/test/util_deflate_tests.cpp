@@ -0,0 +1,63 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/common.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <util/deflate.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string_view>
+#include <vector>
+
+using util::Adler32;
+using util::CRC32;
+using util::DeflateCompress;
+using util::GzipCompress;
+using util::ZlibCompress;
+
+BOOST_FIXTURE_TEST_SUITE(util_deflate_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(checksums)
+{
+    const auto check{std::as_bytes(std::span{std::string_view{"123456789"}})};
+    BOOST_CHECK_EQUAL(CRC32({}), 0U);
+    BOOST_CHECK_EQUAL(CRC32(check), 0xCBF43926U);
+    BOOST_CHECK_EQUAL(CRC32(check.subspan(4), CRC32(check.first(4))), 0xCBF43926U);
+
+    const auto wikipedia{std::as_bytes(std::span{std::string_view{"Wikipedia"}})};
+    BOOST_CHECK_EQUAL(Adler32({}), 1U);
+    BOOST_CHECK_EQUAL(Adler32(wikipedia), 0x11E60398U);
+    BOOST_CHECK_EQUAL(Adler32(wikipedia.subspan(3), Adler32(wikipedia.first(3))), 0x11E60398U);
+    // Sums are reduced often enough not to overflow
+    const std::vector<std::byte> ones(100000, std::byte{0xff});
+    BOOST_CHECK_EQUAL(Adler32(ones), 0x149A302CU);
+}
+
+BOOST_AUTO_TEST_CASE(compress)
+{
+    // An empty input is a single empty stored block
+    BOOST_CHECK(DeflateCompress({}) == (std::vector<std::byte>{std::byte{0x01}, std::byte{0x00}, std::byte{0x00}, std::byte{0xff}, std::byte{0xff}}));
+
+    // Repetitive data shrinks, random data barely grows
+    const std::vector<std::byte> zeros(100000);
+    BOOST_CHECK_LT(DeflateCompress(zeros).size(), 1000U);
+    const std::vector<std::byte> random{m_rng.randbytes<std::byte>(100000)};
+    BOOST_CHECK_LE(DeflateCompress(random).size(), random.size() + 5 * (random.size() / 65535 + 1));
+
+    // Framing
+    const auto gzip{GzipCompress(random)};
+    BOOST_REQUIRE_GE(gzip.size(), 18U);
+    BOOST_CHECK(gzip[0] == std::byte{0x1f} && gzip[1] == std::byte{0x8b} && gzip[2] == std::byte{8});
+    BOOST_CHECK_EQUAL(ReadLE32(gzip.data() + gzip.size() - 8), CRC32(random));
+    BOOST_CHECK_EQUAL(ReadLE32(gzip.data() + gzip.size() - 4), random.size());
+
+    const auto zlib{ZlibCompress(zeros)};
+    BOOST_REQUIRE_GE(zlib.size(), 6U);
+    BOOST_CHECK_EQUAL((uint8_t(zlib[0]) * 256 + uint8_t(zlib[1])) % 31, 0);
+    BOOST_CHECK_EQUAL(ReadBE32(zlib.data() + zlib.size() - 4), Adler32(zeros));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
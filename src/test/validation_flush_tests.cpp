@@ -7,10 +7,13 @@
 #include <test/util/random.h>
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
+#include <txmempool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 BOOST_FIXTURE_TEST_SUITE(validation_flush_tests, TestingSetup)
 
 //! Verify that Chainstate::GetCoinsCacheSizeState() switches from OK→LARGE→CRITICAL
@@ -32,7 +35,9 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
 
     // Run the same growth-path twice: first with 0 head-room, then with extra head-room
     for (size_t max_mempool_size_bytes : {size_t{0}, MAX_MEMPOOL_BYTES}) {
-        const int64_t full_cap{int64_t(MAX_COINS_BYTES + max_mempool_size_bytes)};
+        // Even an empty mempool uses the first chunk of its entry pool, which takes from the head-room.
+        const int64_t mempool_usage{int64_t(m_node.mempool->DynamicMemoryUsage())};
+        const int64_t full_cap{int64_t(MAX_COINS_BYTES) + std::max<int64_t>(int64_t(max_mempool_size_bytes) - mempool_usage, 0)};
         const int64_t large_cap{LargeCoinsCacheThreshold(full_cap)};
 
         // OK → LARGE
@@ -4,14 +4,19 @@
 
 #include <boost/test/unit_test.hpp>
 #include <consensus/validation.h>
+#include <kernel/mempool_removal_reason.h>
 #include <primitives/block.h>
+#include <primitives/transaction.h>
 #include <scheduler.h>
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <validationinterface.h>
 
 #include <atomic>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
 
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, ChainTestingSetup)
 
@@ -99,4 +104,68 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+struct TestQueueSubscriber final : public CValidationInterface {
+    explicit TestQueueSubscriber(std::function<void(uint64_t)> on_call = nullptr) : m_on_call{std::move(on_call)} {}
+    void TransactionRemovedFromMempool(const CTransactionRef&, MemPoolRemovalReason, uint64_t mempool_sequence) override
+    {
+        if (m_on_call) m_on_call(mempool_sequence);
+        ++m_calls;
+    }
+    std::function<void(uint64_t)> m_on_call;
+    std::atomic<int> m_calls{0};
+};
+
+BOOST_AUTO_TEST_CASE(separate_queues)
+{
+    ValidationSignals signals{
+        std::make_unique<ThreadedSerialTaskRunner>("valq.default"),
+        [](const std::string& name) { return std::make_unique<ThreadedSerialTaskRunner>(name); }};
+
+    std::promise<void> release;
+    const std::shared_future<void> released{release.get_future()};
+    std::promise<void> slow_started, fast_done;
+    auto slow{std::make_shared<TestQueueSubscriber>([&](uint64_t sequence) {
+        if (sequence == 0) slow_started.set_value();
+        released.wait();
+    })};
+    auto grouped{std::make_shared<TestQueueSubscriber>()};
+    auto fast{std::make_shared<TestQueueSubscriber>([&](uint64_t sequence) { if (sequence == 2) fast_done.set_value(); })};
+    signals.RegisterSharedValidationInterface(slow, "slow");
+    signals.RegisterSharedValidationInterface(grouped, "slow");
+    signals.RegisterSharedValidationInterface(fast);
+
+    const auto tx{MakeTransactionRef(CMutableTransaction{})};
+    for (uint64_t sequence{0}; sequence < 3; ++sequence) {
+        signals.TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, sequence);
+    }
+
+    // The subscriber on the default queue gets all events while the slow one is
+    // stuck on the first, holding up the other subscriber on its queue.
+    slow_started.get_future().wait();
+    fast_done.get_future().wait();
+    BOOST_CHECK_EQUAL(slow->m_calls, 0);
+    BOOST_CHECK_EQUAL(grouped->m_calls, 0);
+
+    const auto info{signals.GetQueueInfo()};
+    BOOST_REQUIRE_EQUAL(info.size(), 2U);
+    BOOST_CHECK_EQUAL(info[0].name, DEFAULT_VALIDATION_QUEUE);
+    BOOST_CHECK_EQUAL(info[0].subscribers, 1U);
+    BOOST_CHECK_EQUAL(info[0].pending, 0U);
+    BOOST_CHECK_EQUAL(info[1].name, "slow");
+    BOOST_CHECK_EQUAL(info[1].subscribers, 2U);
+    BOOST_CHECK_EQUAL(info[1].pending, 2U);
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 2U);
+
+    // Syncing waits for all queues.
+    release.set_value();
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(slow->m_calls, 3);
+    BOOST_CHECK_EQUAL(grouped->m_calls, 3);
+    BOOST_CHECK_EQUAL(fast->m_calls, 3);
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 0U);
+
+    signals.UnregisterAllValidationInterfaces();
+    signals.FlushBackgroundCallbacks();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -234,6 +234,9 @@ private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
+    //! Cache the key of the record pcursor points at, e.g. after seeking it.
+    void CacheKey();
+
     friend class CCoinsViewDB;
 };
 
@@ -245,17 +248,31 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        only need read operations on it, use a const-cast to get around
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
-    // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
-    } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
-    }
+    i->CacheKey();
+    return i;
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor(const COutPoint& start) const
+{
+    auto i = std::make_unique<CCoinsViewDBCursor>(
+        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
+    i->pcursor->Seek(CoinEntry(&start));
+    i->CacheKey();
     return i;
 }
 
+void CCoinsViewDBCursor::CacheKey()
+{
+    if (pcursor->Valid()) {
+        CoinEntry entry(&keyTmp.second);
+        if (pcursor->GetKey(entry)) {
+            keyTmp.first = entry.key;
+            return;
+        }
+    }
+    keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
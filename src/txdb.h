@@ -53,6 +53,8 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    //! Cursor starting at the first coin whose outpoint is start, or comes after it in the database's order.
+    std::unique_ptr<CCoinsViewCursor> Cursor(const COutPoint& start) const;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -91,6 +91,7 @@ std::vector<CTxMemPoolEntry::CTxMemPoolEntryRef> CTxMemPool::GetParents(const CT
 void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<Txid>& vHashesToUpdate)
 {
     AssertLockHeld(cs);
+    m_feerate_diagram_cache.reset();
 
     // Iterate in reverse, so that whenever we are looking at a transaction
     // we are sure that all in-mempool descendants have already been processed.
@@ -207,6 +208,7 @@ void CTxMemPool::Apply(ChangeSet* changeset)
 {
     AssertLockHeld(cs);
     m_txgraph->CommitStaging();
+    m_feerate_diagram_cache.reset();
 
     RemoveStaged(changeset->m_to_remove, MemPoolRemovalReason::REPLACED);
 
@@ -303,6 +305,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     cachedInnerUsage -= it->DynamicMemoryUsage();
     mapTx.erase(it);
     nTransactionsUpdated++;
+    m_feerate_diagram_cache.reset();
 }
 
 // Calculates descendants of given entry and adds to setDescendants.
@@ -380,6 +383,7 @@ void CTxMemPool::removeForReorg(CChain& chain, std::function<bool(txiter)> check
     for (indexed_transaction_set::const_iterator it = mapTx.begin(); it != mapTx.end(); it++) {
         assert(TestLockPointValidity(chain, it->GetLockPoints()));
     }
+    m_feerate_diagram_cache.reset();
     if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
         LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after reorg.");
     }
@@ -425,6 +429,7 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     }
     lastRollingFeeUpdate = GetTime();
     blockSinceLastRollingFeeBump = true;
+    m_feerate_diagram_cache.reset();
     if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
         LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after block.");
     }
@@ -649,6 +654,7 @@ void CTxMemPool::PrioritiseTransaction(const Txid& hash, const CAmount& nFeeDelt
             it->UpdateModifiedFee(nFeeDelta);
             m_txgraph->SetTransactionFee(*it, it->GetModifiedFee());
             ++nTransactionsUpdated;
+            m_feerate_diagram_cache.reset();
         }
         if (delta == 0) {
             mapDeltas.erase(hash);
@@ -786,8 +792,10 @@ void CCoinsViewMemPool::Reset()
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 9 pointers (3 pointers per index) + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 9 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
+    // The nodes of mapTx and mapNextTx are allocated from m_entry_resource, which is counted whole,
+    // as it keeps the memory of removed entries. The bucket arrays of the hashed indexes of mapTx
+    // are estimated at 2 pointers per entry.
+    return memusage::DynamicUsage(m_entry_resource) + 2 * sizeof(void*) * mapTx.size() + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const Txid& txid, const bool unchecked) {
@@ -1090,6 +1098,9 @@ bool CTxMemPool::ChangeSet::CheckMemPoolPolicyLimits()
 
 std::vector<FeePerWeight> CTxMemPool::GetFeerateDiagram() const
 {
+    AssertLockHeld(cs);
+    if (m_feerate_diagram_cache) return *m_feerate_diagram_cache;
+
     FeePerWeight zero{};
     std::vector<FeePerWeight> ret;
 
@@ -1107,5 +1118,6 @@ std::vector<FeePerWeight> CTxMemPool::GetFeerateDiagram() const
         last_selection = GetBlockBuilderChunk(dummy);
     }
     StopBlockBuilding();
+    m_feerate_diagram_cache = ret;
     return ret;
 }
@@ -18,6 +18,7 @@
 #include <policy/packages.h>
 #include <primitives/transaction.h>
 #include <primitives/transaction_identifier.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <txgraph.h>
 #include <util/feefrac.h>
@@ -201,6 +202,10 @@ protected:
     // is added or removed from the mempool for any reason.
     mutable uint64_t m_sequence_number GUARDED_BY(cs){1};
 
+    //! Feerate diagram computed by the last GetFeerateDiagram() call. Reset
+    //! whenever the main graph in m_txgraph changes.
+    mutable std::optional<std::vector<FeePerWeight>> m_feerate_diagram_cache GUARDED_BY(cs);
+
     void trackPackageRemoved(const CFeeRate& rate) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     bool m_load_tried GUARDED_BY(cs){false};
@@ -211,26 +216,48 @@ public:
 
     static const int ROLLING_FEE_HALFLIFE = 60 * 60 * 12; // public only for testing
 
+    using indexed_transaction_set_indices = boost::multi_index::indexed_by<
+        // sorted by txid
+        boost::multi_index::hashed_unique<mempoolentry_txid, SaltedTxidHasher>,
+        // sorted by wtxid
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<index_by_wtxid>,
+            mempoolentry_wtxid,
+            SaltedWtxidHasher
+        >,
+        // sorted by entry time
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<entry_time>,
+            boost::multi_index::identity<CTxMemPoolEntry>,
+            CompareTxMemPoolEntryByEntryTime
+        >
+    >;
+
+    /** Size of a mapTx node: the entry itself plus the links of all its indexes. */
+    static constexpr size_t ENTRY_NODE_BYTES{sizeof(boost::multi_index_container<CTxMemPoolEntry, indexed_transaction_set_indices>::final_node_type)};
+
+    /**
+     * The nodes of mapTx and mapNextTx are allocated from a pool owned by the mempool rather than
+     * from the general purpose allocator. This avoids the per-allocation malloc overhead for every
+     * entry and every spent outpoint. As nodes are fixed size, freed nodes are reused for new
+     * entries, so the pool does not grow beyond the peak number of entries.
+     */
+    using EntryResource = PoolResource<ENTRY_NODE_BYTES, alignof(CTxMemPoolEntry)>;
+
+    /**
+     * Chunk size of the entry pool. The pool is counted whole in DynamicMemoryUsage(), including the
+     * unused part of its last chunk, so chunks are kept small compared to even a tiny -maxmempool.
+     */
+    static constexpr size_t ENTRY_CHUNK_BYTES{16 * 1024};
+
     using indexed_transaction_set = boost::multi_index_container<
         CTxMemPoolEntry,
-        boost::multi_index::indexed_by<
-            // sorted by txid
-            boost::multi_index::hashed_unique<mempoolentry_txid, SaltedTxidHasher>,
-            // sorted by wtxid
-            boost::multi_index::hashed_unique<
-                boost::multi_index::tag<index_by_wtxid>,
-                mempoolentry_wtxid,
-                SaltedWtxidHasher
-            >,
-            // sorted by entry time
-            boost::multi_index::ordered_non_unique<
-                boost::multi_index::tag<entry_time>,
-                boost::multi_index::identity<CTxMemPoolEntry>,
-                CompareTxMemPoolEntryByEntryTime
-            >
-        >
+        indexed_transaction_set_indices,
+        PoolAllocator<CTxMemPoolEntry, ENTRY_NODE_BYTES, alignof(CTxMemPoolEntry)>
     >;
 
+    static_assert(sizeof(indexed_transaction_set::final_node_type) == ENTRY_NODE_BYTES);
+
     /**
      * This mutex needs to be locked when accessing `mapTx` or other members
      * that are guarded by it.
@@ -258,7 +285,9 @@ public:
     mutable RecursiveMutex cs ACQUIRED_AFTER(::cs_main);
     std::unique_ptr<TxGraph> m_txgraph GUARDED_BY(cs);
     mutable std::unique_ptr<TxGraph::BlockBuilder> m_builder GUARDED_BY(cs);
-    indexed_transaction_set mapTx GUARDED_BY(cs);
+    //! Backing memory for the nodes of mapTx, mapNextTx and ChangeSet additions. Must outlive them.
+    EntryResource m_entry_resource GUARDED_BY(cs){ENTRY_CHUNK_BYTES};
+    indexed_transaction_set mapTx GUARDED_BY(cs){indexed_transaction_set::allocator_type{&m_entry_resource}};
 
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<std::pair<Wtxid, txiter>> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx with their wtxids, in arbitrary order
@@ -293,7 +322,8 @@ private:
     void removeConflicts(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
 public:
-    indirectmap<COutPoint, txiter> mapNextTx GUARDED_BY(cs);
+    using NextTxMap = indirectmap<COutPoint, txiter, PoolAllocator<std::pair<const COutPoint* const, txiter>, ENTRY_NODE_BYTES, alignof(CTxMemPoolEntry)>>;
+    NextTxMap mapNextTx GUARDED_BY(cs){NextTxMap::allocator_type{&m_entry_resource}};
     std::map<Txid, CAmount> mapDeltas GUARDED_BY(cs);
 
     using Options = kernel::MemPoolOptions;
@@ -391,6 +421,8 @@ public:
      */
     void UpdateTransactionsFromBlock(const std::vector<Txid>& vHashesToUpdate) EXCLUSIVE_LOCKS_REQUIRED(cs, cs_main);
 
+    /** Cumulative (fee, weight) diagram of the mempool in block building order,
+     *  starting at (0, 0). Reused across calls until the mempool changes. */
     std::vector<FeePerWeight> GetFeerateDiagram() const EXCLUSIVE_LOCKS_REQUIRED(cs);
     FeePerWeight GetMainChunkFeerate(const CTxMemPoolEntry& tx) const EXCLUSIVE_LOCKS_REQUIRED(cs) {
         return m_txgraph->GetMainChunkFeerate(tx);
@@ -631,7 +663,11 @@ public:
      */
     class ChangeSet {
     public:
-        explicit ChangeSet(CTxMemPool* pool) : m_pool(pool) { m_pool->m_txgraph->StartStaging(); }
+        explicit ChangeSet(CTxMemPool* pool)
+            : m_pool(pool), m_to_add{indexed_transaction_set::allocator_type{&pool->m_entry_resource}}
+        {
+            m_pool->m_txgraph->StartStaging();
+        }
         ~ChangeSet() EXCLUSIVE_LOCKS_REQUIRED(m_pool->cs) {
             AssertLockHeld(m_pool->cs);
             if (m_pool->m_txgraph->HaveStaging()) {
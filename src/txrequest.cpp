@@ -700,6 +700,15 @@ public:
     //! Count how many announcements are being tracked in total across all peers and transactions.
     size_t Size() const { return m_index.size(); }
 
+    std::optional<std::chrono::microseconds> NextTimePoint() const
+    {
+        // The ByTime index starts with the FUTURE_EVENT announcements, earliest first.
+        if (m_index.empty()) return std::nullopt;
+        const Announcement& ann{*m_index.get<ByTime>().begin()};
+        if (GetWaitState(ann) != WaitState::FUTURE_EVENT) return std::nullopt;
+        return ann.m_time;
+    }
+
     uint64_t ComputePriority(const uint256& txhash, NodeId peer, bool preferred) const
     {
         // Return Priority as a uint64_t as Priority is internal.
@@ -719,6 +728,7 @@ size_t TxRequestTracker::CountInFlight(NodeId peer) const { return m_impl->Count
 size_t TxRequestTracker::CountCandidates(NodeId peer) const { return m_impl->CountCandidates(peer); }
 size_t TxRequestTracker::Count(NodeId peer) const { return m_impl->Count(peer); }
 size_t TxRequestTracker::Size() const { return m_impl->Size(); }
+std::optional<std::chrono::microseconds> TxRequestTracker::NextTimePoint() const { return m_impl->NextTimePoint(); }
 void TxRequestTracker::GetCandidatePeers(const uint256& txhash, std::vector<NodeId>& result_peers) const { return m_impl->GetCandidatePeers(txhash, result_peers); }
 void TxRequestTracker::SanityCheck() const { m_impl->SanityCheck(); }
 
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 /** Data structure to keep track of, and schedule, transaction downloads from peers.
@@ -198,6 +199,10 @@ public:
     /** Count how many announcements are being tracked in total across all peers and transaction hashes. */
     size_t Size() const;
 
+    /** The earliest time at which GetRequestable's result can change without any other call in between: the
+     *  first reqtime of a CANDIDATE_DELAYED or expiry of a REQUESTED announcement. std::nullopt if there is none. */
+    std::optional<std::chrono::microseconds> NextTimePoint() const;
+
     /** For some txhash (txid or wtxid), finds all peers with non-COMPLETED announcements and appends them to
      * result_peers. Does not try to ensure that result_peers contains no duplicates. */
     void GetCandidatePeers(const uint256& txhash, std::vector<NodeId>& result_peers) const;
@@ -5,6 +5,7 @@
 
 #include <univalue.h>
 
+#include <charconv>
 #include <iomanip>
 #include <map>
 #include <sstream>
@@ -56,20 +57,23 @@ void UniValue::setNumStr(std::string str)
 
 void UniValue::setInt(uint64_t val_)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    // Always a valid JSON number, so skip setNumStr()'s validation.
+    char buf[24];
+    const auto res{std::to_chars(buf, buf + sizeof(buf), val_)};
 
-    return setNumStr(oss.str());
+    clear();
+    typ = VNUM;
+    val.assign(buf, res.ptr);
 }
 
 void UniValue::setInt(int64_t val_)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    char buf[24];
+    const auto res{std::to_chars(buf, buf + sizeof(buf), val_)};
 
-    return setNumStr(oss.str());
+    clear();
+    typ = VNUM;
+    val.assign(buf, res.ptr);
 }
 
 void UniValue::setFloat(double val_)
@@ -5,34 +5,59 @@
 #include <univalue.h>
 #include <univalue_escapes.h>
 
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 
-static std::string json_escape(const std::string& inS)
+/** Whether any of the 8 bytes at p is one that escapes[] has an entry for:
+ *  a control character, '"', '\\' or DEL. Checks all of them at once, see
+ *  https://graphics.stanford.edu/~seander/bithacks.html#ValueInWord */
+static bool needs_escape8(const char* p)
 {
-    std::string outS;
-    outS.reserve(inS.size() * 2);
-
-    for (unsigned int i = 0; i < inS.size(); i++) {
-        unsigned char ch = static_cast<unsigned char>(inS[i]);
-        const char *escStr = escapes[ch];
+    constexpr uint64_t ONES{~uint64_t{0} / 255};
+    constexpr uint64_t HIGHS{ONES * 0x80};
+    uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    const auto has_zero{[&](uint64_t v) { return (v - ONES) & ~v & HIGHS; }};
+    const uint64_t has_control{(x - ONES * 0x20) & ~x & HIGHS};
+    return (has_control | has_zero(x ^ (ONES * '"')) | has_zero(x ^ (ONES * '\\')) | has_zero(x ^ (ONES * 0x7f))) != 0;
+}
 
-        if (escStr)
-            outS += escStr;
-        else
-            outS += static_cast<char>(ch);
+/** Append inS to s with JSON escaping, copying runs that need no escaping at once. */
+static void json_escape(std::string_view inS, std::string& s)
+{
+    size_t run_start = 0;
+    size_t i = 0;
+    while (i < inS.size()) {
+        if (i + 8 <= inS.size() && !needs_escape8(inS.data() + i)) {
+            i += 8;
+            continue;
+        }
+        const char* escStr = escapes[static_cast<unsigned char>(inS[i])];
+        if (escStr) {
+            s.append(inS.data() + run_start, i - run_start);
+            s += escStr;
+            run_start = i + 1;
+        }
+        ++i;
     }
-
-    return outS;
+    s.append(inS.data() + run_start, inS.size() - run_start);
 }
 
-// NOLINTNEXTLINE(misc-no-recursion)
 std::string UniValue::write(unsigned int prettyIndent,
                             unsigned int indentLevel) const
 {
     std::string s;
     s.reserve(1024);
+    writeValue(prettyIndent, indentLevel, s);
+    return s;
+}
 
+// NOLINTNEXTLINE(misc-no-recursion)
+void UniValue::writeValue(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const
+{
     unsigned int modIndent = indentLevel;
     if (modIndent == 0)
         modIndent = 1;
@@ -48,7 +73,9 @@ std::string UniValue::write(unsigned int prettyIndent,
         writeArray(prettyIndent, modIndent, s);
         break;
     case VSTR:
-        s += "\"" + json_escape(val) + "\"";
+        s += '"';
+        json_escape(val, s);
+        s += '"';
         break;
     case VNUM:
         s += val;
@@ -57,8 +84,6 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += (val == "1" ? "true" : "false");
         break;
     }
-
-    return s;
 }
 
 static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::string& s)
@@ -76,7 +101,7 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
     for (unsigned int i = 0; i < values.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += values[i].write(prettyIndent, indentLevel + 1);
+        values[i].writeValue(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1)) {
             s += ",";
         }
@@ -99,10 +124,12 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     for (unsigned int i = 0; i < keys.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += "\"" + json_escape(keys[i]) + "\":";
+        s += '"';
+        json_escape(keys[i], s);
+        s += "\":";
         if (prettyIndent)
             s += " ";
-        s += values.at(i).write(prettyIndent, indentLevel + 1);
+        values.at(i).writeValue(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1))
             s += ",";
         if (prettyIndent)
@@ -113,4 +140,3 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
         indentStr(prettyIndent, indentLevel - 1, s);
     s += "}";
 }
-
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -454,6 +455,29 @@ void univalue_readwrite()
     BOOST_CHECK(!v.read("{} 42"));
 }
 
+void univalue_write_escapes()
+{
+    // Strings long enough to be scanned in 8-byte blocks, with every escaped
+    // character placed in every position of a block.
+    const std::string special{"\x01\x1f\"\\\x7f"};
+    const std::string escaped[]{"\\u0001", "\\u001f", "\\\"", "\\\\", "\\u007f"};
+    for (size_t i = 0; i < special.size(); ++i) {
+        for (size_t pos = 0; pos < 17; ++pos) {
+            std::string str(17, 'x');
+            str[pos] = special[i];
+            std::string expected{"\"" + std::string(pos, 'x') + escaped[i] + std::string(16 - pos, 'x') + "\""};
+            BOOST_CHECK_EQUAL(UniValue{str}.write(), expected);
+        }
+    }
+    // Bytes above 0x7f and characters just above the control range pass through.
+    BOOST_CHECK_EQUAL(UniValue{"\xe2\x82\xac !#[]~ \xe2\x82\xac"}.write(), "\"\xe2\x82\xac !#[]~ \xe2\x82\xac\"");
+
+    UniValue obj{UniValue::VOBJ};
+    obj.pushKV("key\twith tab", std::numeric_limits<int64_t>::min());
+    obj.pushKV("max", std::numeric_limits<uint64_t>::max());
+    BOOST_CHECK_EQUAL(obj.write(), "{\"key\\twith tab\":-9223372036854775808,\"max\":18446744073709551615}");
+}
+
 int main(int argc, char* argv[])
 {
     univalue_constructor();
@@ -463,5 +487,6 @@ int main(int argc, char* argv[])
     univalue_array();
     univalue_object();
     univalue_readwrite();
+    univalue_write_escapes();
     return 0;
 }
@@ -0,0 +1,426 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/deflate.h>
+
+#include <crypto/common.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace util {
+namespace {
+constexpr std::array<uint32_t, 256> CRC32_TABLE{[] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i{0}; i < table.size(); ++i) {
+        uint32_t crc{i};
+        for (int bit{0}; bit < 8; ++bit) crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+        table[i] = crc;
+    }
+    return table;
+}()};
+
+/** LZ77 parameters. Matches may refer back up to WINDOW_SIZE bytes. */
+constexpr size_t WINDOW_SIZE{32768};
+constexpr size_t MIN_MATCH{3};
+constexpr size_t MAX_MATCH{258};
+constexpr int HASH_BITS{15};
+/** Candidate positions tried per match search, and the match length that ends the search early. */
+constexpr int MAX_CHAIN{32};
+constexpr size_t NICE_MATCH{128};
+/** Symbols (literals and matches) per Huffman block. */
+constexpr size_t BLOCK_SYMBOLS{1 << 15};
+/** Largest payload of a stored block. */
+constexpr size_t MAX_STORED_BLOCK{65535};
+
+constexpr size_t NUM_LITLEN_CODES{286};
+constexpr size_t NUM_DIST_CODES{30};
+constexpr size_t NUM_CODELEN_CODES{19};
+constexpr uint16_t END_OF_BLOCK{256};
+constexpr unsigned MAX_CODE_BITS{15};
+constexpr unsigned MAX_CODELEN_BITS{7};
+
+constexpr std::array<uint16_t, 29> LENGTH_BASE{3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> DIST_BASE{1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> DIST_EXTRA{0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+/** Order in which the code length code lengths are sent. */
+constexpr std::array<uint8_t, NUM_CODELEN_CODES> CODELEN_ORDER{16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+template <size_t N>
+size_t CodeIndex(const std::array<uint16_t, N>& base, size_t value)
+{
+    return std::upper_bound(base.begin(), base.end(), value) - base.begin() - 1;
+}
+
+/** A literal byte (length == 0) or a back reference of length bytes at distance value. */
+struct Symbol {
+    uint16_t length;
+    uint16_t value;
+};
+
+/** Appends bits least significant first, as DEFLATE packs them. */
+class BitWriter
+{
+    std::vector<std::byte>& m_out;
+    uint64_t m_bits{0};
+    unsigned m_count{0};
+
+public:
+    explicit BitWriter(std::vector<std::byte>& out) : m_out{out} {}
+
+    void Write(uint32_t value, unsigned num_bits)
+    {
+        m_bits |= uint64_t{value} << m_count;
+        m_count += num_bits;
+        while (m_count >= 8) {
+            m_out.push_back(std::byte(m_bits & 0xff));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void AlignToByte()
+    {
+        if (m_count > 0) Write(0, 8 - m_count);
+    }
+
+    void WriteBytes(std::span<const std::byte> bytes)
+    {
+        AlignToByte();
+        m_out.insert(m_out.end(), bytes.begin(), bytes.end());
+    }
+};
+
+/**
+ * Code lengths of a Huffman code for the given symbol frequencies, limited to max_bits.
+ * Frequencies are flattened until the code fits, which costs a little compression only in the
+ * rare blocks that need it. At least two symbols get a code, so the code is always complete.
+ */
+std::vector<uint8_t> HuffmanCodeLengths(std::vector<uint32_t> freqs, unsigned max_bits)
+{
+    size_t used(std::ranges::count_if(freqs, [](uint32_t f) { return f > 0; }));
+    for (size_t i{0}; used < 2 && i < freqs.size(); ++i) {
+        if (freqs[i] == 0) {
+            freqs[i] = 1;
+            ++used;
+        }
+    }
+
+    std::vector<uint8_t> lengths(freqs.size());
+    while (true) {
+        // Nodes are the used symbols followed by the internal nodes; parents always come later.
+        std::vector<size_t> symbol_of_leaf;
+        std::vector<size_t> parent;
+        std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>, std::greater<>> queue;
+        for (size_t i{0}; i < freqs.size(); ++i) {
+            if (freqs[i] == 0) continue;
+            queue.emplace(freqs[i], symbol_of_leaf.size());
+            symbol_of_leaf.push_back(i);
+            parent.push_back(0);
+        }
+        while (queue.size() > 1) {
+            const auto [weight_a, a]{queue.top()};
+            queue.pop();
+            const auto [weight_b, b]{queue.top()};
+            queue.pop();
+            parent[a] = parent[b] = parent.size();
+            queue.emplace(weight_a + weight_b, parent.size());
+            parent.push_back(0);
+        }
+        std::vector<unsigned> depth(parent.size());
+        for (size_t node{parent.size() - 1}; node-- > 0;) depth[node] = depth[parent[node]] + 1;
+
+        if (*std::max_element(depth.begin(), depth.begin() + symbol_of_leaf.size()) <= max_bits) {
+            for (size_t leaf{0}; leaf < symbol_of_leaf.size(); ++leaf) lengths[symbol_of_leaf[leaf]] = depth[leaf];
+            return lengths;
+        }
+        for (auto& freq : freqs) {
+            if (freq > 0) freq = (freq + 1) / 2;
+        }
+    }
+}
+
+/** Canonical Huffman codes for the given code lengths, bit-reversed for BitWriter. */
+std::vector<uint16_t> CanonicalCodes(const std::vector<uint8_t>& lengths)
+{
+    std::array<uint16_t, MAX_CODE_BITS + 1> count{};
+    for (const auto len : lengths) ++count[len];
+    count[0] = 0;
+    std::array<uint16_t, MAX_CODE_BITS + 1> next_code{};
+    for (unsigned bits{1}, code{0}; bits <= MAX_CODE_BITS; ++bits) {
+        code = (code + count[bits - 1]) << 1;
+        next_code[bits] = code;
+    }
+    std::vector<uint16_t> codes(lengths.size());
+    for (size_t i{0}; i < lengths.size(); ++i) {
+        if (lengths[i] == 0) continue;
+        uint16_t code{next_code[lengths[i]]++};
+        uint16_t reversed{0};
+        for (unsigned bit{0}; bit < lengths[i]; ++bit, code >>= 1) reversed = (reversed << 1) | (code & 1);
+        codes[i] = reversed;
+    }
+    return codes;
+}
+
+/** The codes for one dynamic Huffman block and its size in bits. */
+class DynamicBlock
+{
+    std::vector<uint8_t> m_litlen_lengths, m_dist_lengths, m_codelen_lengths;
+    std::vector<uint16_t> m_litlen_codes, m_dist_codes, m_codelen_codes;
+    /** Run-length encoded code lengths: code length symbol and its extra bits value. */
+    std::vector<std::pair<uint8_t, uint8_t>> m_codelen_symbols;
+    size_t m_num_litlen{257}, m_num_dist{1}, m_num_codelen{4};
+    uint64_t m_bits{0};
+
+    static constexpr unsigned CodeLenExtraBits(uint8_t symbol) { return symbol == 16 ? 2 : symbol == 17 ? 3 : symbol == 18 ? 7 : 0; }
+
+    void EncodeCodeLengths(const std::vector<uint8_t>& lengths)
+    {
+        for (size_t i{0}; i < lengths.size();) {
+            const uint8_t len{lengths[i]};
+            size_t run{1};
+            while (i + run < lengths.size() && lengths[i + run] == len) ++run;
+            i += run;
+            if (len == 0) {
+                for (; run >= 11; run -= std::min<size_t>(run, 138)) m_codelen_symbols.emplace_back(18, std::min<size_t>(run, 138) - 11);
+                if (run >= 3) {
+                    m_codelen_symbols.emplace_back(17, run - 3);
+                    run = 0;
+                }
+            } else {
+                m_codelen_symbols.emplace_back(len, 0);
+                --run;
+                for (; run >= 3; run -= std::min<size_t>(run, 6)) m_codelen_symbols.emplace_back(16, std::min<size_t>(run, 6) - 3);
+            }
+            for (; run > 0; --run) m_codelen_symbols.emplace_back(len, 0);
+        }
+    }
+
+public:
+    explicit DynamicBlock(std::span<const Symbol> symbols)
+    {
+        std::vector<uint32_t> litlen_freqs(NUM_LITLEN_CODES), dist_freqs(NUM_DIST_CODES);
+        for (const auto& symbol : symbols) {
+            if (symbol.length == 0) {
+                ++litlen_freqs[symbol.value];
+            } else {
+                ++litlen_freqs[257 + CodeIndex(LENGTH_BASE, symbol.length)];
+                ++dist_freqs[CodeIndex(DIST_BASE, symbol.value)];
+            }
+        }
+        litlen_freqs[END_OF_BLOCK] = 1;
+        m_litlen_lengths = HuffmanCodeLengths(litlen_freqs, MAX_CODE_BITS);
+        m_dist_lengths = HuffmanCodeLengths(dist_freqs, MAX_CODE_BITS);
+        m_litlen_codes = CanonicalCodes(m_litlen_lengths);
+        m_dist_codes = CanonicalCodes(m_dist_lengths);
+        while (m_num_litlen < NUM_LITLEN_CODES && std::any_of(m_litlen_lengths.begin() + m_num_litlen, m_litlen_lengths.end(), [](uint8_t l) { return l > 0; })) ++m_num_litlen;
+        while (m_num_dist < NUM_DIST_CODES && std::any_of(m_dist_lengths.begin() + m_num_dist, m_dist_lengths.end(), [](uint8_t l) { return l > 0; })) ++m_num_dist;
+
+        std::vector<uint8_t> lengths(m_litlen_lengths.begin(), m_litlen_lengths.begin() + m_num_litlen);
+        lengths.insert(lengths.end(), m_dist_lengths.begin(), m_dist_lengths.begin() + m_num_dist);
+        EncodeCodeLengths(lengths);
+        std::vector<uint32_t> codelen_freqs(NUM_CODELEN_CODES);
+        for (const auto& [symbol, extra] : m_codelen_symbols) ++codelen_freqs[symbol];
+        m_codelen_lengths = HuffmanCodeLengths(codelen_freqs, MAX_CODELEN_BITS);
+        m_codelen_codes = CanonicalCodes(m_codelen_lengths);
+        m_num_codelen = NUM_CODELEN_CODES;
+        while (m_num_codelen > 4 && m_codelen_lengths[CODELEN_ORDER[m_num_codelen - 1]] == 0) --m_num_codelen;
+
+        m_bits = 3 + 5 + 5 + 4 + 3 * m_num_codelen + m_litlen_lengths[END_OF_BLOCK];
+        for (const auto& [symbol, extra] : m_codelen_symbols) m_bits += m_codelen_lengths[symbol] + CodeLenExtraBits(symbol);
+        for (const auto& symbol : symbols) {
+            if (symbol.length == 0) {
+                m_bits += m_litlen_lengths[symbol.value];
+            } else {
+                const auto len_index{CodeIndex(LENGTH_BASE, symbol.length)};
+                const auto dist_index{CodeIndex(DIST_BASE, symbol.value)};
+                m_bits += m_litlen_lengths[257 + len_index] + LENGTH_EXTRA[len_index] + m_dist_lengths[dist_index] + DIST_EXTRA[dist_index];
+            }
+        }
+    }
+
+    uint64_t Bits() const { return m_bits; }
+
+    void Write(BitWriter& writer, std::span<const Symbol> symbols, bool final) const
+    {
+        writer.Write(final, 1);
+        writer.Write(2, 2);
+        writer.Write(m_num_litlen - 257, 5);
+        writer.Write(m_num_dist - 1, 5);
+        writer.Write(m_num_codelen - 4, 4);
+        for (size_t i{0}; i < m_num_codelen; ++i) writer.Write(m_codelen_lengths[CODELEN_ORDER[i]], 3);
+        for (const auto& [symbol, extra] : m_codelen_symbols) {
+            writer.Write(m_codelen_codes[symbol], m_codelen_lengths[symbol]);
+            writer.Write(extra, CodeLenExtraBits(symbol));
+        }
+        for (const auto& symbol : symbols) {
+            if (symbol.length == 0) {
+                writer.Write(m_litlen_codes[symbol.value], m_litlen_lengths[symbol.value]);
+                continue;
+            }
+            const auto len_index{CodeIndex(LENGTH_BASE, symbol.length)};
+            writer.Write(m_litlen_codes[257 + len_index], m_litlen_lengths[257 + len_index]);
+            writer.Write(symbol.length - LENGTH_BASE[len_index], LENGTH_EXTRA[len_index]);
+            const auto dist_index{CodeIndex(DIST_BASE, symbol.value)};
+            writer.Write(m_dist_codes[dist_index], m_dist_lengths[dist_index]);
+            writer.Write(symbol.value - DIST_BASE[dist_index], DIST_EXTRA[dist_index]);
+        }
+        writer.Write(m_litlen_codes[END_OF_BLOCK], m_litlen_lengths[END_OF_BLOCK]);
+    }
+};
+
+void WriteStoredBlocks(BitWriter& writer, std::span<const std::byte> data, bool final)
+{
+    do {
+        const size_t size{std::min(data.size(), MAX_STORED_BLOCK)};
+        writer.Write(final && size == data.size(), 1);
+        writer.Write(0, 2);
+        writer.AlignToByte();
+        writer.Write(size, 16);
+        writer.Write(~size & 0xffff, 16);
+        writer.WriteBytes(data.first(size));
+        data = data.subspan(size);
+    } while (!data.empty());
+}
+
+/** Size of size bytes written as stored blocks, in bits. */
+uint64_t StoredBits(size_t size)
+{
+    return 8 * size + 40 * (size / MAX_STORED_BLOCK + 1);
+}
+
+uint32_t Hash3(const std::byte* p)
+{
+    const uint32_t v{uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16};
+    return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+} // namespace
+
+uint32_t CRC32(std::span<const std::byte> data, uint32_t crc)
+{
+    crc = ~crc;
+    for (const auto b : data) crc = CRC32_TABLE[(crc ^ uint8_t(b)) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t Adler32(std::span<const std::byte> data, uint32_t adler)
+{
+    // Largest number of bytes that can be summed before b may overflow 32 bits.
+    constexpr size_t MAX_RUN{5552};
+    uint32_t a{adler & 0xffff}, b{adler >> 16};
+    while (!data.empty()) {
+        const size_t run{std::min(data.size(), MAX_RUN)};
+        for (const auto byte : data.first(run)) {
+            a += uint8_t(byte);
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data = data.subspan(run);
+    }
+    return b << 16 | a;
+}
+
+std::vector<std::byte> DeflateCompress(std::span<const std::byte> data)
+{
+    std::vector<std::byte> out;
+    BitWriter writer{out};
+    if (data.empty()) {
+        WriteStoredBlocks(writer, data, /*final=*/true);
+        return out;
+    }
+
+    std::vector<int32_t> head(size_t{1} << HASH_BITS, -1);
+    std::vector<int32_t> prev(WINDOW_SIZE, -1);
+    const auto insert{[&](size_t pos) {
+        if (pos + MIN_MATCH > data.size()) return;
+        const uint32_t hash{Hash3(&data[pos])};
+        prev[pos % WINDOW_SIZE] = head[hash];
+        head[hash] = pos;
+    }};
+
+    std::vector<Symbol> symbols;
+    symbols.reserve(BLOCK_SYMBOLS);
+    size_t block_start{0};
+    // Data of blocks that are smaller stored is only written once a block compresses, or at the
+    // end, so that consecutive stored blocks are merged up to their maximum size.
+    size_t stored_start{0};
+    for (size_t pos{0}; pos < data.size();) {
+        size_t best_len{0}, best_dist{0};
+        if (pos + MIN_MATCH <= data.size()) {
+            const size_t max_len{std::min(MAX_MATCH, data.size() - pos)};
+            int32_t candidate{head[Hash3(&data[pos])]};
+            for (int chain{MAX_CHAIN}; candidate >= 0 && pos - candidate <= WINDOW_SIZE && chain > 0; --chain) {
+                if (data[candidate + best_len] == data[pos + best_len]) {
+                    size_t len{0};
+                    while (len < max_len && data[candidate + len] == data[pos + len]) ++len;
+                    if (len > best_len) {
+                        best_len = len;
+                        best_dist = pos - candidate;
+                        if (len >= std::min(NICE_MATCH, max_len)) break;
+                    }
+                }
+                const int32_t next{prev[candidate % WINDOW_SIZE]};
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        if (best_len >= MIN_MATCH) {
+            symbols.push_back({uint16_t(best_len), uint16_t(best_dist)});
+            for (size_t end{pos + best_len}; pos < end; ++pos) insert(pos);
+        } else {
+            symbols.push_back({0, uint16_t(data[pos])});
+            insert(pos++);
+        }
+
+        if (symbols.size() == BLOCK_SYMBOLS || pos == data.size()) {
+            const bool final{pos == data.size()};
+            const DynamicBlock block{symbols};
+            if (block.Bits() < StoredBits(pos - block_start)) {
+                if (stored_start < block_start) {
+                    WriteStoredBlocks(writer, data.subspan(stored_start, block_start - stored_start), /*final=*/false);
+                }
+                block.Write(writer, symbols, final);
+                stored_start = pos;
+            } else if (final) {
+                WriteStoredBlocks(writer, data.subspan(stored_start), /*final=*/true);
+            }
+            symbols.clear();
+            block_start = pos;
+        }
+    }
+    writer.AlignToByte();
+    return out;
+}
+
+std::vector<std::byte> GzipCompress(std::span<const std::byte> data)
+{
+    // Magic, CM=deflate, no flags, no modification time, no extra flags, unknown OS.
+    std::vector<std::byte> out{std::byte{0x1f}, std::byte{0x8b}, std::byte{8}, std::byte{0}, std::byte{0}, std::byte{0}, std::byte{0}, std::byte{0}, std::byte{0}, std::byte{0xff}};
+    const auto deflated{DeflateCompress(data)};
+    out.insert(out.end(), deflated.begin(), deflated.end());
+    std::array<std::byte, 8> trailer;
+    WriteLE32(trailer.data(), CRC32(data));
+    WriteLE32(trailer.data() + 4, uint32_t(data.size()));
+    out.insert(out.end(), trailer.begin(), trailer.end());
+    return out;
+}
+
+std::vector<std::byte> ZlibCompress(std::span<const std::byte> data)
+{
+    // CM=deflate with a 32 KiB window, default compression level, header check bits.
+    std::vector<std::byte> out{std::byte{0x78}, std::byte{0x9c}};
+    const auto deflated{DeflateCompress(data)};
+    out.insert(out.end(), deflated.begin(), deflated.end());
+    std::array<std::byte, 4> trailer;
+    WriteBE32(trailer.data(), Adler32(data));
+    out.insert(out.end(), trailer.begin(), trailer.end());
+    return out;
+}
+} // namespace util
@@ -0,0 +1,36 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_DEFLATE_H
+#define BITCOIN_UTIL_DEFLATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace util {
+/** CRC-32 as used by gzip (RFC 1952), continuing from a previous result crc. */
+uint32_t CRC32(std::span<const std::byte> data, uint32_t crc = 0);
+
+/** Adler-32 as used by the zlib format (RFC 1950), continuing from a previous result adler. */
+uint32_t Adler32(std::span<const std::byte> data, uint32_t adler = 1);
+
+/**
+ * Compress data into a raw DEFLATE stream (RFC 1951).
+ *
+ * This is a compact encoder meant for compressing HTTP responses: greedy LZ77 matching
+ * over the full 32 KiB window followed by a dynamic Huffman code per block, falling back
+ * to stored blocks for data that does not compress. It does not decompress.
+ */
+std::vector<std::byte> DeflateCompress(std::span<const std::byte> data);
+
+/** Compress data into the gzip format (RFC 1952), i.e. HTTP `Content-Encoding: gzip`. */
+std::vector<std::byte> GzipCompress(std::span<const std::byte> data);
+
+/** Compress data into the zlib format (RFC 1950), i.e. HTTP `Content-Encoding: deflate`. */
+std::vector<std::byte> ZlibCompress(std::span<const std::byte> data);
+} // namespace util
+
+#endif // BITCOIN_UTIL_DEFLATE_H
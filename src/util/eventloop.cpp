@@ -0,0 +1,157 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/eventloop.h>
+
+#include <tinyformat.h>
+#include <util/log.h>
+#include <util/sock.h>
+#include <util/syserror.h>
+#include <util/time.h>
+
+#include <cassert>
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef USE_EPOLL
+#include <unistd.h>
+#endif
+
+std::optional<SocketEventsMode> SocketEventsModeFromString(std::string_view str)
+{
+    if (str == "waitmany") return SocketEventsMode::WAIT_MANY;
+#ifdef USE_EPOLL
+    if (str == "epoll") return SocketEventsMode::EPOLL;
+#endif
+    return std::nullopt;
+}
+
+std::string SocketEventsModeToString(SocketEventsMode mode)
+{
+    switch (mode) {
+    case SocketEventsMode::WAIT_MANY: return "waitmany";
+#ifdef USE_EPOLL
+    case SocketEventsMode::EPOLL: return "epoll";
+#endif
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+std::string SocketEventsModesAvailable()
+{
+#ifdef USE_EPOLL
+    return "waitmany, epoll";
+#else
+    return "waitmany";
+#endif
+}
+
+bool WaitManyEventLoop::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock)
+{
+    if (events_per_sock.empty()) return false;
+    return events_per_sock.begin()->first->WaitMany(timeout, events_per_sock);
+}
+
+#ifdef USE_EPOLL
+static uint32_t ToEpollEvents(Sock::Event requested)
+{
+    uint32_t events{0};
+    if (requested & Sock::RecvEvent) events |= EPOLLIN;
+    if (requested & Sock::SendEvent) events |= EPOLLOUT;
+    return events;
+}
+
+EpollEventLoop::EpollEventLoop() : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (m_epoll_fd == -1) {
+        throw std::runtime_error(strprintf("epoll_create1() failed: %s", SysErrorString(errno)));
+    }
+}
+
+EpollEventLoop::~EpollEventLoop()
+{
+    close(m_epoll_fd);
+}
+
+bool EpollEventLoop::Sync(const Sock::EventsPerSock& events_per_sock)
+{
+    ++m_round;
+    for (const auto& [sock, events] : events_per_sock) {
+        const SOCKET fd{sock->m_socket};
+        epoll_event ev{};
+        ev.events = ToEpollEvents(events.requested);
+        ev.data.fd = fd;
+        const auto [it, inserted]{m_registered.try_emplace(fd, Registration{sock, events.requested, m_round})};
+        if (inserted) {
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+                LogDebug(BCLog::NET, "epoll_ctl(ADD, %d) failed: %s", fd, SysErrorString(errno));
+                m_registered.erase(it);
+                return false;
+            }
+            continue;
+        }
+        it->second.round = m_round;
+        if (it->second.requested != events.requested) {
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+                LogDebug(BCLog::NET, "epoll_ctl(MOD, %d) failed: %s", fd, SysErrorString(errno));
+                return false;
+            }
+            it->second.requested = events.requested;
+        }
+    }
+
+    for (auto it{m_registered.begin()}; it != m_registered.end();) {
+        if (it->second.round == m_round) {
+            ++it;
+            continue;
+        }
+        // Still open, because we hold a reference to it, so this cannot fail
+        // in a way that matters.
+        (void)epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+        it = m_registered.erase(it);
+    }
+    return true;
+}
+
+bool EpollEventLoop::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock)
+{
+    // Sync even an empty set, so sockets of disconnected peers are released.
+    if (!Sync(events_per_sock)) {
+        // Registering failed, e.g. because one of the sockets is not a real
+        // one. Serve this round the stateless way.
+        return events_per_sock.begin()->first->WaitMany(timeout, events_per_sock);
+    }
+    if (events_per_sock.empty()) return false;
+
+    m_ready.resize(m_registered.size());
+    const int n{epoll_wait(m_epoll_fd, m_ready.data(), m_ready.size(), count_milliseconds(timeout))};
+    if (n == -1) return false;
+
+    for (auto& [sock, events] : events_per_sock) {
+        events.occurred = 0;
+    }
+    for (int i{0}; i < n; ++i) {
+        const auto reg{m_registered.find(m_ready[i].data.fd)};
+        if (reg == m_registered.end()) continue;
+        const auto it{events_per_sock.find(reg->second.sock)};
+        if (it == events_per_sock.end()) continue;
+        const uint32_t revents{m_ready[i].events};
+        if (revents & EPOLLIN) it->second.occurred |= Sock::RecvEvent;
+        if (revents & EPOLLOUT) it->second.occurred |= Sock::SendEvent;
+        if (revents & (EPOLLERR | EPOLLHUP)) it->second.occurred |= Sock::ErrorEvent;
+    }
+    return true;
+}
+#endif // USE_EPOLL
+
+std::unique_ptr<EventLoop> MakeEventLoop(SocketEventsMode mode)
+{
+    switch (mode) {
+    case SocketEventsMode::WAIT_MANY: return std::make_unique<WaitManyEventLoop>();
+#ifdef USE_EPOLL
+    case SocketEventsMode::EPOLL: return std::make_unique<EpollEventLoop>();
+#endif
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
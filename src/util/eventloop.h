@@ -0,0 +1,111 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_EVENTLOOP_H
+#define BITCOIN_UTIL_EVENTLOOP_H
+
+#include <compat/compat.h>
+#include <util/sock.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+/** Mechanism used to wait for readiness of many sockets at once. */
+enum class SocketEventsMode {
+    //! `Sock::WaitMany()`: poll(2) or select(2), the whole set is passed in on every call.
+    WAIT_MANY,
+#ifdef USE_EPOLL
+    //! epoll(7), sockets stay registered with the kernel between calls.
+    EPOLL,
+#endif
+};
+
+std::optional<SocketEventsMode> SocketEventsModeFromString(std::string_view str);
+std::string SocketEventsModeToString(SocketEventsMode mode);
+/** Comma separated list of the modes available on this platform. */
+std::string SocketEventsModesAvailable();
+
+/**
+ * Waits for readiness of a set of sockets that changes little between calls,
+ * e.g. the connected peers of a node. Not thread safe; meant to be owned by the
+ * single thread servicing the sockets.
+ */
+class EventLoop
+{
+public:
+    virtual ~EventLoop() = default;
+
+    /**
+     * Same contract as `Sock::WaitMany()`. The caller passes the full set of
+     * sockets it is currently interested in on every call; implementations may
+     * remember the previous set and only act on the difference. An empty set
+     * returns false right away, but must still be passed, so that sockets
+     * remembered from previous calls are released.
+     */
+    [[nodiscard]] virtual bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock) = 0;
+};
+
+/** Stateless event loop delegating to `Sock::WaitMany()` (which also works with mocked sockets). */
+class WaitManyEventLoop final : public EventLoop
+{
+public:
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock) override;
+};
+
+#ifdef USE_EPOLL
+/**
+ * Event loop keeping sockets registered with an epoll instance between calls,
+ * so unchanged interest costs no system call and waiting costs O(ready sockets)
+ * in the kernel instead of O(sockets). Registered sockets are kept alive until
+ * they are dropped from the set, so their file descriptors cannot be reused
+ * while the kernel still reports on them.
+ */
+class EpollEventLoop final : public EventLoop
+{
+public:
+    EpollEventLoop();
+    ~EpollEventLoop() override;
+
+    EpollEventLoop(const EpollEventLoop&) = delete;
+    EpollEventLoop& operator=(const EpollEventLoop&) = delete;
+
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock) override;
+
+    /** Number of sockets currently registered with the kernel. */
+    size_t NumRegistered() const { return m_registered.size(); }
+
+private:
+    struct Registration {
+        std::shared_ptr<const Sock> sock;
+        Sock::Event requested;
+        uint64_t round;
+    };
+
+    /**
+     * Bring the kernel registrations in line with `events_per_sock`.
+     * @return false if a registration could not be added or changed.
+     */
+    bool Sync(const Sock::EventsPerSock& events_per_sock);
+
+    int m_epoll_fd;
+    //! Incremented on every Sync() to find registrations no longer requested.
+    uint64_t m_round{0};
+    std::unordered_map<SOCKET, Registration> m_registered;
+    std::vector<epoll_event> m_ready;
+};
+#endif // USE_EPOLL
+
+std::unique_ptr<EventLoop> MakeEventLoop(SocketEventsMode mode);
+
+#endif // BITCOIN_UTIL_EVENTLOOP_H
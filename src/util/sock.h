@@ -277,6 +277,8 @@ public:
     bool operator==(SOCKET s) const;
 
 protected:
+    friend class EpollEventLoop;
+
     /**
      * Contained socket. `INVALID_SOCKET` designates the object is empty.
      */
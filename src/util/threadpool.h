@@ -12,9 +12,11 @@
 #include <util/thread.h>
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <future>
+#include <memory>
 #include <queue>
 #include <ranges>
 #include <thread>
@@ -236,6 +238,44 @@ public:
         return {std::move(futures)};
     }
 
+    /**
+     * @brief Calls fn(i) for every i in [0, count), on up to max_parallel threads at once.
+     *
+     * The calling thread takes part in the work and returns once all calls have finished. Helper
+     * tasks that only get to run after the calling thread has taken the last index return without
+     * calling fn, so this is safe to call from within a submitted task, even when all other workers
+     * are busy. If the pool is inactive or interrupted, everything runs on the calling thread.
+     *
+     * @warning fn must not throw.
+     */
+    template <class F>
+    void ParallelFor(size_t count, size_t max_parallel, F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        struct State {
+            std::atomic<size_t> next{0};
+            Mutex mutex;
+            std::condition_variable cv;
+            size_t done GUARDED_BY(mutex){0};
+        };
+        const auto state{std::make_shared<State>()};
+        // fn is captured by reference: helpers only call it while the calling thread is waiting below.
+        const auto run{[state, count, &fn] {
+            size_t finished{0};
+            for (size_t i; (i = state->next.fetch_add(1, std::memory_order_relaxed)) < count; ++finished) fn(i);
+            if (finished == 0) return;
+            WITH_LOCK(state->mutex, state->done += finished);
+            state->cv.notify_all();
+        }};
+
+        const size_t threads{std::min({count, max_parallel, WorkersCount() + 1})};
+        for (size_t i{1}; i < threads; ++i) {
+            if (!Submit(run).has_value()) break;
+        }
+        run();
+        WAIT_LOCK(state->mutex, wait_lock);
+        state->cv.wait(wait_lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(state->mutex) { return state->done == count; });
+    }
+
     /**
      * @brief Execute a single queued task synchronously.
      * Removes one task from the queue and executes it on the calling thread.
@@ -0,0 +1,190 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_TIMINGWHEEL_H
+#define BITCOIN_UTIL_TIMINGWHEEL_H
+
+#include <util/check.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Hierarchical timing wheel holding at most one deadline per key.
+ *
+ * - Time is divided into ticks of a fixed resolution. Deadlines are rounded up to a whole
+ *   tick, so keys never expire early, and at most one tick late.
+ * - Level L has 64 slots of 64^L ticks each. A deadline is kept at the lowest level whose
+ *   current block it falls into, and is moved down a level each time the wheel enters its slot.
+ * - Schedule() and Cancel() are O(1). Advance() is O(1) amortized per expired key, plus a scan
+ *   of one occupancy bitmap per level, however far time moves.
+ * - Time may go backwards; keys then simply do not expire until it catches up again.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class TimingWheel
+{
+    static constexpr int SLOT_BITS{6};
+    static constexpr int SLOTS{1 << SLOT_BITS};
+    /** Enough levels to cover every non-negative int64_t tick. */
+    static constexpr int LEVELS{(63 + SLOT_BITS - 1) / SLOT_BITS};
+
+    struct Entry {
+        Key key;
+        int64_t tick;
+    };
+
+    struct Location {
+        uint8_t level;
+        uint8_t slot;
+        uint32_t index;
+    };
+
+    const std::chrono::microseconds m_resolution;
+    /** The tick up to which (inclusive) Advance() has expired keys. */
+    int64_t m_current{0};
+    std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> m_slots;
+    /** Bit s of m_occupied[L] is set iff m_slots[L][s] is not empty. */
+    std::array<uint64_t, LEVELS> m_occupied{};
+    std::unordered_map<Key, Location, Hash> m_locations;
+
+    int64_t ToTick(std::chrono::microseconds time) const
+    {
+        if (time.count() <= 0) return 0;
+        // Round up, so that a key is never reported before its deadline.
+        return (time.count() - 1) / m_resolution.count() + 1;
+    }
+
+    static int SlotAt(int64_t tick, int level) { return (tick >> (SLOT_BITS * level)) & (SLOTS - 1); }
+
+    void Insert(Entry entry)
+    {
+        // Overdue deadlines go in the current slot, which is the first one Advance() looks at.
+        const int64_t tick{std::max(entry.tick, m_current)};
+        const uint64_t diff{uint64_t(tick ^ m_current)};
+        const int level{diff == 0 ? 0 : int(std::bit_width(diff) - 1) / SLOT_BITS};
+        const int slot{SlotAt(tick, level)};
+        auto& entries{m_slots[level][slot]};
+        m_locations.insert_or_assign(entry.key, Location{uint8_t(level), uint8_t(slot), uint32_t(entries.size())});
+        entries.push_back(std::move(entry));
+        m_occupied[level] |= uint64_t{1} << slot;
+    }
+
+    /** Remove the entry at a location, keeping the location of the entry moved into its place. */
+    Entry Remove(const Location& loc)
+    {
+        auto& entries{m_slots[loc.level][loc.slot]};
+        Entry entry{std::move(entries[loc.index])};
+        if (loc.index + 1 != entries.size()) {
+            entries[loc.index] = std::move(entries.back());
+            m_locations[entries[loc.index].key].index = loc.index;
+        }
+        entries.pop_back();
+        if (entries.empty()) m_occupied[loc.level] &= ~(uint64_t{1} << loc.slot);
+        m_locations.erase(entry.key);
+        return entry;
+    }
+
+    /** Move all entries out of a slot, clearing it. */
+    std::vector<Entry> TakeSlot(int level, int slot)
+    {
+        std::vector<Entry> entries;
+        entries.swap(m_slots[level][slot]);
+        m_occupied[level] &= ~(uint64_t{1} << slot);
+        for (const Entry& entry : entries) m_locations.erase(entry.key);
+        return entries;
+    }
+
+    /** First tick of the earliest non-empty slot, or std::nullopt if the wheel is empty. */
+    std::optional<int64_t> NextOccupiedTick() const
+    {
+        // Each level only holds deadlines past those of the levels below it.
+        for (int level = 0; level < LEVELS; ++level) {
+            const int current_slot{SlotAt(m_current, level)};
+            const uint64_t ahead{m_occupied[level] & (~uint64_t{0} << current_slot)};
+            if (ahead == 0) continue;
+            const int slot{std::countr_zero(ahead)};
+            if (slot == current_slot) return m_current;
+            const int shift{SLOT_BITS * level};
+            const int64_t block_start{(m_current >> (shift + SLOT_BITS)) << (shift + SLOT_BITS)};
+            return block_start + (int64_t{slot} << shift);
+        }
+        return std::nullopt;
+    }
+
+public:
+    explicit TimingWheel(std::chrono::microseconds resolution) : m_resolution{resolution}
+    {
+        Assert(m_resolution.count() > 0);
+    }
+
+    size_t size() const { return m_locations.size(); }
+    bool empty() const { return m_locations.empty(); }
+    bool contains(const Key& key) const { return m_locations.contains(key); }
+
+    /** Set the deadline of a key, replacing any earlier one. */
+    void Schedule(const Key& key, std::chrono::microseconds deadline)
+    {
+        Cancel(key);
+        Insert(Entry{key, ToTick(deadline)});
+    }
+
+    /** Forget the deadline of a key. Returns whether there was one. */
+    bool Cancel(const Key& key)
+    {
+        const auto it{m_locations.find(key)};
+        if (it == m_locations.end()) return false;
+        Remove(it->second);
+        return true;
+    }
+
+    /** Lower bound on the next deadline, or std::nullopt if there is none. */
+    std::optional<std::chrono::microseconds> NextDeadline() const
+    {
+        const auto tick{NextOccupiedTick()};
+        if (!tick) return std::nullopt;
+        return *tick * m_resolution;
+    }
+
+    /** Remove and return all keys whose deadline is at or before now. */
+    std::vector<Key> Advance(std::chrono::microseconds now)
+    {
+        std::vector<Key> expired;
+        // Only whole ticks have passed: rounding now up as well would expire keys early.
+        const int64_t target{std::max<int64_t>(now.count(), 0) / m_resolution.count()};
+        while (true) {
+            const auto next{NextOccupiedTick()};
+            if (!next || *next > target) break;
+            if (*next != m_current) {
+                // Nothing is due in between, so jump straight to the slot.
+                m_current = *next;
+            }
+            // Entering a slot of a higher level means its deadlines now fall into the current
+            // block of a lower level: move them down, from the top so none are skipped.
+            bool moved{false};
+            for (int level = LEVELS - 1; level >= 1; --level) {
+                const int slot{SlotAt(m_current, level)};
+                if (!(m_occupied[level] & (uint64_t{1} << slot))) continue;
+                for (Entry& entry : TakeSlot(level, slot)) Insert(std::move(entry));
+                moved = true;
+            }
+            if (moved) continue;
+            // Everything in the current level 0 slot is due: its deadline is the current tick,
+            // or earlier if it was scheduled when already overdue.
+            for (Entry& entry : TakeSlot(0, SlotAt(m_current, 0))) expired.push_back(std::move(entry.key));
+            if (m_current == target) break;
+            ++m_current;
+        }
+        if (target > m_current) m_current = target;
+        return expired;
+    }
+};
+
+#endif // BITCOIN_UTIL_TIMINGWHEEL_H
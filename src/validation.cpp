@@ -99,6 +99,8 @@ static constexpr auto DATABASE_WRITE_INTERVAL_MIN{50min};
 static constexpr auto DATABASE_WRITE_INTERVAL_MAX{70min};
 /** Maximum age of our tip for us to be considered current for fee estimation */
 static constexpr std::chrono::hours MAX_FEE_ESTIMATION_TIP_AGE{3};
+/** Number of transactions AcceptToMemoryPoolBatch() submits per cs_main acquisition. */
+static constexpr size_t MEMPOOL_BATCH_SUBMIT_SIZE{100};
 const std::vector<std::string> CHECKLEVEL_DOC {
     "level 0 reads the blocks from disk",
     "level 1 verifies block validity",
@@ -1811,6 +1813,89 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     return result;
 }
 
+/**
+ * Run the standard script checks of a batch of transactions on the script check queue workers, so
+ * that their signatures are already in the signature cache when the transactions are submitted one
+ * by one. Transactions with missing inputs are skipped. Outputs of earlier transactions in the batch
+ * are made available to later ones, so chains of unconfirmed transactions are covered as well.
+ *
+ * This is purely a cache warm-up: results are discarded and serial acceptance stays authoritative.
+ */
+static void PreVerifyTransactionScripts(Chainstate& active_chainstate, CTxMemPool& pool,
+                                        const std::vector<std::pair<CTransactionRef, int64_t>>& txs)
+    EXCLUSIVE_LOCKS_REQUIRED(!::cs_main)
+{
+    AssertLockNotHeld(::cs_main);
+    auto& queue{active_chainstate.m_chainman.GetCheckQueue()};
+    if (!queue.HasThreads() || txs.size() < 2) return;
+
+    SignatureCache& signature_cache{active_chainstate.m_chainman.m_validation_cache.m_signature_cache};
+    // Precomputed transaction data is referenced by the script checks, so it must not be moved
+    // until all checks have completed.
+    std::vector<PrecomputedTransactionData> txsdata(txs.size());
+    std::vector<std::vector<CScriptCheck>> checks;
+    checks.reserve(txs.size());
+    {
+        LOCK2(::cs_main, pool.cs);
+        CCoinsViewMemPool view_mempool{&active_chainstate.CoinsTip(), pool};
+        CCoinsViewCache view{&view_mempool};
+        for (size_t i{0}; i < txs.size(); ++i) {
+            const CTransaction& tx{*txs[i].first};
+            TxValidationState dummy_state;
+            if (tx.IsCoinBase() || !CheckTransaction(tx, dummy_state) || pool.exists(tx.GetWitnessHash())) continue;
+
+            std::vector<CTxOut> spent_outputs;
+            spent_outputs.reserve(tx.vin.size());
+            for (const CTxIn& txin : tx.vin) {
+                const Coin& coin{view.AccessCoin(txin.prevout)};
+                if (coin.IsSpent()) break;
+                spent_outputs.emplace_back(coin.out);
+            }
+            if (spent_outputs.size() != tx.vin.size()) continue;
+            // Make this transaction's outputs visible to its descendants later in the batch.
+            AddCoins(view, tx, MEMPOOL_HEIGHT, /*check=*/true);
+
+            txsdata[i].Init(tx, std::move(spent_outputs));
+            auto& tx_checks{checks.emplace_back()};
+            tx_checks.reserve(tx.vin.size());
+            for (unsigned int n{0}; n < tx.vin.size(); ++n) {
+                tx_checks.emplace_back(txsdata[i].m_spent_outputs[n], tx, signature_cache, n,
+                                       STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txsdata[i]);
+            }
+        }
+    }
+
+    // The checks only read the spent outputs copied above, so they are run without holding cs_main.
+    CCheckQueueControl<CScriptCheck> control{queue};
+    for (auto& tx_checks : checks) control.Add(std::move(tx_checks));
+    // The queue stops at the first failing check. Anything skipped is simply verified during the
+    // serial submission, which also reports the actual failure.
+    (void)control.Complete();
+}
+
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate,
+                                                         const std::vector<std::pair<CTransactionRef, int64_t>>& txs,
+                                                         bool bypass_limits)
+{
+    AssertLockNotHeld(::cs_main);
+    assert(active_chainstate.GetMempool() != nullptr);
+    PreVerifyTransactionScripts(active_chainstate, *active_chainstate.GetMempool(), txs);
+
+    std::vector<MempoolAcceptResult> results;
+    results.reserve(txs.size());
+    while (results.size() < txs.size()) {
+        // Release cs_main between sub-batches, so that block and message processing are not held
+        // up for the whole batch.
+        LOCK(::cs_main);
+        const size_t end{std::min(results.size() + MEMPOOL_BATCH_SUBMIT_SIZE, txs.size())};
+        while (results.size() < end) {
+            const auto& [tx, accept_time]{txs[results.size()]};
+            results.emplace_back(AcceptToMemoryPool(active_chainstate, tx, accept_time, bypass_limits, /*test_accept=*/false));
+        }
+    }
+    return results;
+}
+
 PackageMempoolAcceptResult ProcessNewPackage(Chainstate& active_chainstate, CTxMemPool& pool,
                                                    const Package& package, bool test_accept, const std::optional<CFeeRate>& client_maxfeerate)
 {
@@ -4036,8 +4121,16 @@ void ChainstateManager::GenerateCoinbaseCommitment(CBlock& block, const CBlockIn
 
 bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams)
 {
-    return std::ranges::all_of(headers,
-                               [&](const auto& header) { return CheckProofOfWork(header.GetHash(), header.nBits, consensusParams); });
+    return HasValidProofOfWork(headers, GetBlockHeaderHashes(headers), consensusParams);
+}
+
+bool HasValidProofOfWork(std::span<const CBlockHeader> headers, std::span<const uint256> hashes, const Consensus::Params& consensusParams)
+{
+    assert(headers.size() == hashes.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (!CheckProofOfWork(hashes[i], headers[i].nBits, consensusParams)) return false;
+    }
+    return true;
 }
 
 bool IsBlockMutated(const CBlock& block, bool check_witness_root)
@@ -278,6 +278,25 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
                                        int64_t accept_time, bool bypass_limits, bool test_accept)
     EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+/**
+ * Try to add a batch of transactions to the mempool, each with its own accept time. The script checks
+ * of the transactions are first run in parallel on the script check queue, which warms the signature
+ * cache. Each transaction is then submitted in order through AcceptToMemoryPool(), so transactions
+ * must be sorted such that parents come before their children.
+ *
+ * cs_main is not held while the script checks run, and is released between small groups of
+ * submissions, so large batches do not stall block and message processing.
+ *
+ * This is only used when loading mempool.dat. Orphan resolution and reorg resubmission process
+ * transactions one at a time while already holding cs_main, and keep using AcceptToMemoryPool().
+ *
+ * @returns a MempoolAcceptResult for each transaction, in the same order as txs.
+ */
+std::vector<MempoolAcceptResult> AcceptToMemoryPoolBatch(Chainstate& active_chainstate,
+                                                         const std::vector<std::pair<CTransactionRef, int64_t>>& txs,
+                                                         bool bypass_limits)
+    EXCLUSIVE_LOCKS_REQUIRED(!cs_main);
+
 /**
 * Validate (and maybe submit) a package to the mempool. See doc/policy/packages.md for full details
 * on package validation rules.
@@ -420,6 +439,9 @@ BlockValidationState TestBlockValidity(
 /** Check that the proof of work on each blockheader matches the value in nBits */
 bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams);
 
+/** Same as above, for headers whose hashes (in the same order) have already been computed */
+bool HasValidProofOfWork(std::span<const CBlockHeader> headers, std::span<const uint256> hashes, const Consensus::Params& consensusParams);
+
 /** Check if a block has been mutated (with respect to its merkle root and witness commitments). */
 bool IsBlockMutated(const CBlock& block, bool check_witness_root);
 
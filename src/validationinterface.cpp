@@ -16,10 +16,14 @@
 #include <util/log.h>
 #include <util/task_runner.h>
 
+#include <algorithm>
+#include <atomic>
 #include <future>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 using kernel::ChainstateRole;
 
@@ -30,31 +34,59 @@ using kernel::ChainstateRole;
  * registered, and a std::list is used to store the callbacks that are
  * currently registered as well as any callbacks that are just unregistered
  * and about to be deleted when they are done executing.
+ *
+ * Every background event is inserted into each notification queue, and run
+ * there for the subscribers registered on that queue.
  */
 class ValidationSignalsImpl
 {
+public:
+    struct Queue {
+        std::string name;
+        std::unique_ptr<util::TaskRunnerInterface> runner;
+    };
+
 private:
     Mutex m_mutex;
     //! List entries consist of a callback pointer and reference count. The
     //! count is equal to the number of current executions of that entry, plus 1
     //! if it's registered. It cannot be 0 because that would imply it is
     //! unregistered and also not being executed (so shouldn't exist).
-    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; };
+    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; const Queue* queue{nullptr}; int count = 1; };
     std::list<ListEntry> m_list GUARDED_BY(m_mutex);
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
+    const ValidationSignals::TaskRunnerFactory m_queue_factory;
+    //! The default queue followed by the named ones, in order of creation. Queues
+    //! are never removed, so pointers to them stay valid. Declared last so that
+    //! the task runners are destroyed before the callbacks they may be running.
+    std::vector<std::unique_ptr<Queue>> m_queues GUARDED_BY(m_mutex);
 
-public:
-    std::unique_ptr<util::TaskRunnerInterface> m_task_runner;
+    Queue& GetQueue(std::string_view name) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        if (!m_queue_factory) return *m_queues.front();
+        for (const auto& queue : m_queues) {
+            if (queue->name == name) return *queue;
+        }
+        std::string queue_name{name};
+        auto runner{Assert(m_queue_factory(queue_name))};
+        return *m_queues.emplace_back(std::make_unique<Queue>(std::move(queue_name), std::move(runner)));
+    }
 
-    explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-        : m_task_runner{std::move(Assert(task_runner))} {}
+public:
+    explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner, ValidationSignals::TaskRunnerFactory queue_factory)
+        : m_queue_factory{std::move(queue_factory)}
+    {
+        LOCK(m_mutex);
+        m_queues.emplace_back(std::make_unique<Queue>(std::string{DEFAULT_VALIDATION_QUEUE}, std::move(Assert(task_runner))));
+    }
 
-    void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    void Register(std::shared_ptr<CValidationInterface> callbacks, std::string_view queue) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto inserted = m_map.emplace(callbacks.get(), m_list.end());
         if (inserted.second) inserted.first->second = m_list.emplace(m_list.end());
         inserted.first->second->callbacks = std::move(callbacks);
+        inserted.first->second->queue = &GetQueue(queue);
     }
 
     void Unregister(CValidationInterface* callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
@@ -80,10 +112,15 @@ public:
         m_map.clear();
     }
 
-    template<typename F> void Iterate(F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    //! Call f on the subscribers of queue, or on all subscribers if queue is null.
+    template<typename F> void Iterate(const Queue* queue, F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         WAIT_LOCK(m_mutex, lock);
         for (auto it = m_list.begin(); it != m_list.end();) {
+            if (queue && it->queue != queue) {
+                ++it;
+                continue;
+            }
             ++it->count;
             {
                 REVERSE_LOCK(lock, m_mutex);
@@ -92,35 +129,97 @@ public:
             it = --it->count ? std::next(it) : m_list.erase(it);
         }
     }
+
+    std::vector<Queue*> Queues() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        std::vector<Queue*> queues;
+        queues.reserve(m_queues.size());
+        for (const auto& queue : m_queues) queues.push_back(queue.get());
+        return queues;
+    }
+
+    //! Insert task into every queue, to be called with that queue.
+    //! Runners are called without m_mutex held, as they may run the task right away.
+    void Enqueue(std::function<void(const Queue&)> task) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        const auto queues{Queues()};
+        const auto shared_task{std::make_shared<const std::function<void(const Queue&)>>(std::move(task))};
+        for (const Queue* queue : queues) {
+            queue->runner->insert([queue, shared_task] { (*shared_task)(*queue); });
+        }
+    }
+
+    //! Call func once every queue has run the tasks inserted before it.
+    void EnqueueBarrier(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        const auto queues{Queues()};
+        if (queues.size() == 1) {
+            queues.front()->runner->insert(std::move(func));
+            return;
+        }
+        struct Barrier {
+            std::atomic<size_t> remaining;
+            std::function<void()> func;
+        };
+        const auto barrier{std::make_shared<Barrier>(queues.size(), std::move(func))};
+        for (const Queue* queue : queues) {
+            queue->runner->insert([barrier] {
+                if (--barrier->remaining == 0) barrier->func();
+            });
+        }
+    }
+
+    std::vector<ValidationQueueInfo> GetQueueInfo() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<ValidationQueueInfo> info;
+        const auto queues{Queues()};
+        {
+            LOCK(m_mutex);
+            for (const Queue* queue : queues) {
+                const auto subscribers{std::ranges::count_if(m_map, [&](const auto& entry) { return entry.second->queue == queue; })};
+                info.push_back({.name = queue->name, .subscribers = size_t(subscribers), .pending = 0});
+            }
+        }
+        for (size_t i{0}; i < queues.size(); ++i) info[i].pending = queues[i]->runner->size();
+        return info;
+    }
 };
 
-ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner))} {}
+ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, TaskRunnerFactory queue_factory)
+    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner), std::move(queue_factory))} {}
 
 ValidationSignals::~ValidationSignals() = default;
 
 void ValidationSignals::FlushBackgroundCallbacks()
 {
-    m_internals->m_task_runner->flush();
+    for (const auto* queue : m_internals->Queues()) queue->runner->flush();
 }
 
 size_t ValidationSignals::CallbacksPending()
 {
-    return m_internals->m_task_runner->size();
+    size_t pending{0};
+    for (const auto* queue : m_internals->Queues()) pending = std::max(pending, queue->runner->size());
+    return pending;
+}
+
+std::vector<ValidationQueueInfo> ValidationSignals::GetQueueInfo()
+{
+    return m_internals->GetQueueInfo();
 }
 
-void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
+void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, std::string_view queue)
 {
     // Each connection captures the shared_ptr to ensure that each callback is
     // executed before the subscriber is destroyed. For more details see #18338.
-    m_internals->Register(std::move(callbacks));
+    m_internals->Register(std::move(callbacks), queue);
 }
 
-void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks)
+void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks, std::string_view queue)
 {
     // Create a shared_ptr with a no-op deleter - CValidationInterface lifecycle
     // is managed by the caller.
-    RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}});
+    RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}}, queue);
 }
 
 void ValidationSignals::UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
@@ -140,7 +239,7 @@ void ValidationSignals::UnregisterAllValidationInterfaces()
 
 void ValidationSignals::CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    m_internals->m_task_runner->insert(std::move(func));
+    m_internals->EnqueueBarrier(std::move(func));
 }
 
 void ValidationSignals::SyncWithValidationInterfaceQueue()
@@ -156,18 +255,19 @@ void ValidationSignals::SyncWithValidationInterfaceQueue()
 
 // Use a macro instead of a function for conditional logging to prevent
 // evaluating arguments when logging is not enabled.
-#define ENQUEUE_AND_LOG_EVENT(event, log_msg)                                                                    \
-    do {                                                                                                         \
-        static_assert(std::is_rvalue_reference_v<decltype((event))>,                                             \
-                      "event must be passed as an rvalue");                                                      \
-        static_assert(std::is_rvalue_reference_v<decltype((log_msg))>,                                           \
-                      "log_msg must be passed as an rvalue");                                                    \
-        auto enqueue_log_msg = (log_msg);                                                                        \
-        LOG_EVENT("Enqueuing %s", enqueue_log_msg);                                                              \
-        m_internals->m_task_runner->insert([local_log_msg = std::move(enqueue_log_msg), local_event = (event)] { \
-            LOG_EVENT("%s", local_log_msg);                                                                      \
-            local_event();                                                                                       \
-        });                                                                                                      \
+#define ENQUEUE_AND_LOG_EVENT(event, log_msg)                                                                      \
+    do {                                                                                                           \
+        static_assert(std::is_rvalue_reference_v<decltype((event))>,                                               \
+                      "event must be passed as an rvalue");                                                        \
+        static_assert(std::is_rvalue_reference_v<decltype((log_msg))>,                                             \
+                      "log_msg must be passed as an rvalue");                                                      \
+        auto enqueue_log_msg = (log_msg);                                                                          \
+        LOG_EVENT("Enqueuing %s", enqueue_log_msg);                                                                \
+        m_internals->Enqueue([local_log_msg = std::move(enqueue_log_msg), local_event = (event), this](            \
+                                 const ValidationSignalsImpl::Queue& queue) {                                      \
+            LOG_EVENT("%s (%s queue)", local_log_msg, queue.name);                                                 \
+            m_internals->Iterate(&queue, local_event);                                                             \
+        });                                                                                                        \
     } while (0)
 
 #define LOG_MSG(fmt, ...) \
@@ -185,8 +285,8 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
                           pindexNew->GetBlockHash().ToString(),
                           pindexFork ? pindexFork->GetBlockHash().ToString() : "null",
                           fInitialDownload);
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    auto event = [pindexNew, pindexFork, fInitialDownload](CValidationInterface& callbacks) {
+        callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -194,7 +294,7 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
 void ValidationSignals::ActiveTipChange(const CBlockIndex& new_tip, bool is_ibd)
 {
     LOG_EVENT("%s: new block hash=%s block height=%d", __func__, new_tip.GetBlockHash().ToString(), new_tip.nHeight);
-    m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ActiveTipChange(new_tip, is_ibd); });
+    m_internals->Iterate(nullptr, [&](CValidationInterface& callbacks) { callbacks.ActiveTipChange(new_tip, is_ibd); });
 }
 
 void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
@@ -202,8 +302,8 @@ void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInf
     auto log_msg = LOG_MSG("%s: txid=%s wtxid=%s", __func__,
                           tx.info.m_tx->GetHash().ToString(),
                           tx.info.m_tx->GetWitnessHash().ToString());
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
+    auto event = [tx, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionAddedToMempool(tx, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -213,8 +313,8 @@ void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx,
                           tx->GetHash().ToString(),
                           tx->GetWitnessHash().ToString(),
                           RemovalReasonToString(reason));
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
+    auto event = [tx, reason, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -224,8 +324,8 @@ void ValidationSignals::BlockConnected(const ChainstateRole& role, std::shared_p
     auto log_msg = LOG_MSG("%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
                           pindex->nHeight);
-    auto event = [role, pblock = std::move(pblock), pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
+    auto event = [role, pblock = std::move(pblock), pindex](CValidationInterface& callbacks) {
+        callbacks.BlockConnected(role, pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -235,8 +335,8 @@ void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<Rem
     auto log_msg = LOG_MSG("%s: block height=%s txs removed=%s", __func__,
                           nBlockHeight,
                           txs_removed_for_block.size());
-    auto event = [txs_removed_for_block, nBlockHeight, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight); });
+    auto event = [txs_removed_for_block, nBlockHeight](CValidationInterface& callbacks) {
+        callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -246,8 +346,8 @@ void ValidationSignals::BlockDisconnected(std::shared_ptr<const CBlock> pblock,
     auto log_msg = LOG_MSG("%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
                           pindex->nHeight);
-    auto event = [pblock = std::move(pblock), pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
+    auto event = [pblock = std::move(pblock), pindex](CValidationInterface& callbacks) {
+        callbacks.BlockDisconnected(pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -256,8 +356,8 @@ void ValidationSignals::ChainStateFlushed(const ChainstateRole& role, const CBlo
 {
     auto log_msg = LOG_MSG("%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
-    auto event = [role, locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
+    auto event = [role, locator](CValidationInterface& callbacks) {
+        callbacks.ChainStateFlushed(role, locator);
     };
     ENQUEUE_AND_LOG_EVENT(std::move(event), std::move(log_msg));
 }
@@ -266,10 +366,10 @@ void ValidationSignals::BlockChecked(const std::shared_ptr<const CBlock>& block,
 {
     LOG_EVENT("%s: block hash=%s state=%s", __func__,
               block->GetHash().ToString(), state.ToString());
-    m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockChecked(block, state); });
+    m_internals->Iterate(nullptr, [&](CValidationInterface& callbacks) { callbacks.BlockChecked(block, state); });
 }
 
 void ValidationSignals::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock> &block) {
     LOG_EVENT("%s: block hash=%s", __func__, block->GetHash().ToString());
-    m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.NewPoWValidBlock(pindex, block); });
+    m_internals->Iterate(nullptr, [&](CValidationInterface& callbacks) { callbacks.NewPoWValidBlock(pindex, block); });
 }
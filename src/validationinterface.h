@@ -14,6 +14,8 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace kernel {
@@ -162,26 +164,54 @@ protected:
     friend class ValidationInterfaceTest;
 };
 
+/** Name of the notification queue subscribers are registered on by default. */
+static constexpr std::string_view DEFAULT_VALIDATION_QUEUE{"default"};
+
+/** State of one of the notification queues of ValidationSignals. */
+struct ValidationQueueInfo {
+    std::string name;
+    //! Number of subscribers registered on the queue
+    size_t subscribers;
+    //! Number of events not yet delivered to all of them
+    size_t pending;
+};
+
 class ValidationSignalsImpl;
 class ValidationSignals {
 private:
     std::unique_ptr<ValidationSignalsImpl> m_internals;
 
 public:
+    //! Creates the task runner of a named notification queue.
+    using TaskRunnerFactory = std::function<std::unique_ptr<util::TaskRunnerInterface>(const std::string& name)>;
+
     // The task runner will block validation if it calls its insert method's
     // func argument synchronously. In this class func contains a loop that
-    // dispatches a single validation event to all subscribers sequentially.
-    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner);
+    // dispatches a single validation event to all subscribers of a queue sequentially.
+    //
+    // Subscribers can be registered on named queues of their own, each with a
+    // task runner made by queue_factory, so that a slow subscriber does not delay
+    // the others. Without a queue_factory, all subscribers share task_runner.
+    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, TaskRunnerFactory queue_factory = {});
 
     ~ValidationSignals();
 
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Number of events pending on the longest queue */
     size_t CallbacksPending();
 
-    /** Register subscriber */
-    void RegisterValidationInterface(CValidationInterface* callbacks);
+    /** Subscriber and pending event counts of each queue, the default queue first */
+    std::vector<ValidationQueueInfo> GetQueueInfo();
+
+    /**
+     * Register subscriber. Its background callbacks are delivered on the named
+     * queue, which is shared by all subscribers registered with the same name and
+     * created on first use. The name is also used for the queue's thread, so it
+     * should not be longer than 13 characters.
+     */
+    void RegisterValidationInterface(CValidationInterface* callbacks, std::string_view queue = DEFAULT_VALIDATION_QUEUE);
     /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
     void UnregisterValidationInterface(CValidationInterface* callbacks);
     /** Unregister all subscribers */
@@ -192,13 +222,14 @@ public:
     // unregistration is nonblocking and can return before the last notification is
     // processed.
     /** Register subscriber */
-    void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
+    void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, std::string_view queue = DEFAULT_VALIDATION_QUEUE);
     /** Unregister subscriber */
     void UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
 
     /**
-     * Pushes a function to callback onto the notification queue, guaranteeing any
+     * Pushes a function to callback onto the notification queues, guaranteeing any
      * callbacks generated prior to now are finished when the function is called.
+     * The function is called once, on the thread of the queue that gets to it last.
      *
      * Be very careful blocking on func to be called if any locks are held -
      * validation interface clients may not be able to make progress as they often
@@ -5,6 +5,7 @@
 #ifndef BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -39,6 +40,8 @@ public:
             outbound_message_high_water_mark = sndhwm;
         }
     }
+    //! Number of messages that were not published because the publish queue was full or sending them failed.
+    uint64_t GetDroppedMessages() const { return m_dropped_messages; }
 
     virtual bool Initialize(void *pcontext) = 0;
     virtual void Shutdown() = 0;
@@ -61,6 +64,7 @@ protected:
     std::string type;
     std::string address;
     int outbound_message_high_water_mark{DEFAULT_ZMQ_SNDHWM}; // aka SNDHWM
+    std::atomic<uint64_t> m_dropped_messages{0};
 };
 
 #endif // BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
@@ -11,20 +11,26 @@
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <streams.h>
+#include <sync.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/log.h>
+#include <util/thread.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
-#include <cstdarg>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -36,48 +42,143 @@ static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
 
-// Internal function to send multipart message
-static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
+static void FreeZmqMessageData(void* /*data*/, void* hint)
 {
-    va_list args;
-    va_start(args, size);
+    delete static_cast<std::vector<std::byte>*>(hint);
+}
 
-    while (1)
-    {
-        zmq_msg_t msg;
+// Internal function to send a command, data and sequence number as a multipart
+// message. The data buffer is handed over to ZMQ, which frees it once sent.
+static bool zmq_send_multipart(void *sock, const char* command, std::vector<std::byte>&& data, uint32_t sequence)
+{
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(msgseq, sequence);
 
-        int rc = zmq_msg_init_size(&msg, size);
-        if (rc != 0)
-        {
-            zmqError("Unable to initialize ZMQ msg");
-            va_end(args);
-            return -1;
-        }
+    zmq_msg_t parts[3];
+    const size_t command_size{strlen(command)};
+    if (zmq_msg_init_size(&parts[0], command_size) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        return false;
+    }
+    memcpy(zmq_msg_data(&parts[0]), command, command_size);
 
-        void *buf = zmq_msg_data(&msg);
-        memcpy(buf, data, size);
+    auto buffer{std::make_unique<std::vector<std::byte>>(std::move(data))};
+    if (zmq_msg_init_data(&parts[1], buffer->data(), buffer->size(), FreeZmqMessageData, buffer.get()) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        zmq_msg_close(&parts[0]);
+        return false;
+    }
+    buffer.release(); // now owned by parts[1]
 
-        data = va_arg(args, const void*);
+    if (zmq_msg_init_size(&parts[2], sizeof(msgseq)) != 0) {
+        zmqError("Unable to initialize ZMQ msg");
+        zmq_msg_close(&parts[0]);
+        zmq_msg_close(&parts[1]);
+        return false;
+    }
+    memcpy(zmq_msg_data(&parts[2]), msgseq, sizeof(msgseq));
 
-        rc = zmq_msg_send(&msg, sock, data ? ZMQ_SNDMORE : 0);
-        if (rc == -1)
-        {
+    for (size_t i = 0; i < 3; ++i) {
+        if (zmq_msg_send(&parts[i], sock, i < 2 ? ZMQ_SNDMORE : 0) == -1) {
             zmqError("Unable to send ZMQ msg");
-            zmq_msg_close(&msg);
-            va_end(args);
-            return -1;
+            for (; i < 3; ++i) zmq_msg_close(&parts[i]);
+            return false;
         }
+    }
+    return true;
+}
 
-        zmq_msg_close(&msg);
+namespace {
+/**
+ * Sends the messages of all publish notifiers from a dedicated thread, in the
+ * order they were queued, so that publishing does not hold up the validation
+ * interface queue the notifications are delivered on. All messages queued while
+ * the thread was busy are taken as one batch.
+ */
+class ZMQPublisher
+{
+public:
+    struct Message {
+        void* socket;
+        const char* command;
+        std::vector<std::byte> data;
+        uint32_t sequence;
+        std::atomic<uint64_t>* dropped;
+    };
+
+    ~ZMQPublisher() { Stop(); }
+
+    //! Queue a message, starting the thread if needed.
+    //! @returns false if the message was dropped because the queue is full.
+    bool Push(Message&& message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            LOCK(m_mutex);
+            // A message larger than the limit is still queued on its own.
+            if (!m_queue.empty() && m_queue_size + message.data.size() > MAX_ZMQ_PUBLISH_QUEUE_SIZE) return false;
+            if (!m_thread.joinable()) {
+                m_stop = false;
+                m_thread = std::thread(&util::TraceThread, "zmqpub", [this] { ThreadPublish(); });
+            }
+            m_queue_size += message.data.size();
+            m_queue.push_back(std::move(message));
+        }
+        m_cv.notify_all();
+        return true;
+    }
 
-        if (!data)
-            break;
+    //! Wait until all queued messages have been sent.
+    void Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_queue.empty() && !m_sending; });
+    }
 
-        size = va_arg(args, size_t);
+    //! Send all queued messages and stop the thread.
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
     }
-    va_end(args);
-    return 0;
-}
+
+private:
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Message> m_queue GUARDED_BY(m_mutex);
+    //! Total size of the data of the messages in m_queue.
+    size_t m_queue_size GUARDED_BY(m_mutex){0};
+    bool m_sending GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+
+    void ThreadPublish() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        for (;;) {
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+
+            std::deque<Message> batch;
+            batch.swap(m_queue);
+            m_queue_size = 0;
+            m_sending = true;
+            {
+                REVERSE_LOCK(lock, m_mutex);
+                for (Message& message : batch) {
+                    if (!zmq_send_multipart(message.socket, message.command, std::move(message.data), message.sequence)) {
+                        ++*message.dropped;
+                    }
+                }
+            }
+            m_sending = false;
+            m_cv.notify_all();
+        }
+    }
+};
+
+ZMQPublisher g_zmq_publisher;
+} // namespace
 
 static bool IsZMQAddressIPV6(const std::string &zmq_address)
 {
@@ -179,6 +280,10 @@ void CZMQAbstractPublishNotifier::Shutdown()
         }
     }
 
+    // Queued messages refer to this notifier and possibly its socket
+    g_zmq_publisher.Flush();
+    if (mapPublishNotifiers.empty()) g_zmq_publisher.Stop();
+
     if (count == 1)
     {
         LogDebug(BCLog::ZMQ, "Close socket at address %s\n", address);
@@ -191,17 +296,22 @@ void CZMQAbstractPublishNotifier::Shutdown()
 }
 
 bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
+{
+    const auto bytes{static_cast<const std::byte*>(data)};
+    return SendZmqMessage(command, std::vector<std::byte>(bytes, bytes + size));
+}
+
+bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, std::vector<std::byte>&& data)
 {
     assert(psocket);
 
     /* send three parts, command & data & a LE 4byte sequence number */
-    unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(msgseq, nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
-        return false;
+    if (!g_zmq_publisher.Push({psocket, command, std::move(data), nSequence, &m_dropped_messages})) {
+        ++m_dropped_messages;
+        LogDebug(BCLog::ZMQ, "Publish queue full, dropping %s message to %s\n", command, address);
+    }
 
-    /* increment memory only sequence number after sending */
+    /* increment memory only sequence number after queueing */
     nSequence++;
 
     return true;
@@ -239,16 +349,16 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
         return false;
     }
 
-    return SendZmqMessage(MSG_RAWBLOCK, block.data(), block.size());
+    return SendZmqMessage(MSG_RAWBLOCK, std::move(block));
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
 {
     uint256 hash = transaction.GetHash().ToUint256();
     LogDebug(BCLog::ZMQ, "Publish rawtx %s to %s\n", hash.GetHex(), this->address);
-    DataStream ss;
-    ss << TX_WITH_WITNESS(transaction);
-    return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    std::vector<std::byte> data(GetSerializeSize(TX_WITH_WITNESS(transaction)));
+    SpanWriter{data} << TX_WITH_WITNESS(transaction);
+    return SendZmqMessage(MSG_RAWTX, std::move(data));
 }
 
 // Helper function to send a 'sequence' topic message with the following structure:
@@ -15,6 +15,10 @@
 
 class CBlockIndex;
 
+//! Maximum size of the message data queued for publishing, across all publish notifiers.
+//! Messages that do not fit are dropped.
+static constexpr size_t MAX_ZMQ_PUBLISH_QUEUE_SIZE{64 << 20};
+
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
@@ -27,8 +31,13 @@ public:
           * command
           * data
           * message sequence number
+       The message is queued and sent from the publisher thread. Messages
+       dropped because the queue is full still use up a sequence number,
+       so subscribers can notice them.
     */
     bool SendZmqMessage(const char *command, const void* data, size_t size);
+    //! Same, but hands the data over to ZMQ instead of copying it.
+    bool SendZmqMessage(const char *command, std::vector<std::byte>&& data);
 
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
@@ -34,6 +34,7 @@ static RPCMethod getzmqnotifications()
                             {RPCResult::Type::STR, "type", "Type of notification"},
                             {RPCResult::Type::STR, "address", "Address of the publisher"},
                             {RPCResult::Type::NUM, "hwm", "Outbound message high water mark"},
+                            {RPCResult::Type::NUM, "dropped", "Number of messages not published because the publish queue was full or sending failed"},
                         }},
                     }
                 },
@@ -50,6 +51,7 @@ static RPCMethod getzmqnotifications()
             obj.pushKV("type", n->GetType());
             obj.pushKV("address", n->GetAddress());
             obj.pushKV("hwm", n->GetOutboundMessageHighWaterMark());
+            obj.pushKV("dropped", n->GetDroppedMessages());
             result.push_back(std::move(obj));
         }
     }
@@ -7,15 +7,18 @@
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import assert_equal, str_to_b64str
 
+import gzip
 import http.client
 import time
 import urllib.parse
+import zlib
 
 # Configuration option for some tests
 RPCSERVERTIMEOUT = 2
 # Set in httpserver.h
 MAX_HEADERS_SIZE = 8192
 MAX_BODY_SIZE = 32 * 1024 * 1024
+MIN_COMPRESSED_BODY_SIZE = 1024
 
 # When a test expects a server disconnection, any of these errors are
 # acceptable. The specific event is determined by race condition and platform OS.
@@ -123,6 +126,7 @@ class HTTPBasicsTest (BitcoinTestFramework):
         self.check_close_connection()
         self.check_excessive_request_size()
         self.check_pipelining()
+        self.check_compression()
         self.check_chunked_transfer()
         self.check_idle_timeout()
         self.check_server_busy_idle_timeout()
@@ -260,14 +264,15 @@ class HTTPBasicsTest (BitcoinTestFramework):
         conn.set_timeout(5)
 
         # Send two requests in a row.
-        # The first request will block the second indefinitely
+        # The first request blocks until a new block arrives.
         conn.post_raw('/', f'{{"method": "waitforblockheight", "params": [{tip_height + 1}]}}')
         conn.post_raw('/', '{"method": "getblockcount"}')
 
         try:
-            # The server should not respond to the second request until the first
-            # request has been handled. Since the server will not respond at all
-            # to the first request until we generate a block we expect a socket timeout.
+            # The second request is handled right away, but its response is
+            # held back until the first request has been responded to. Since
+            # the server will not respond at all to the first request until we
+            # generate a block we expect a socket timeout.
             conn.recv_raw()
             assert False
         except TimeoutError:
@@ -282,10 +287,45 @@ class HTTPBasicsTest (BitcoinTestFramework):
             res += conn.recv_raw()
 
         # waitforblockheight was responded to first, and then getblockcount
-        # which includes the block added after the request was made
+        # which ran in parallel, before the block was added
         chunks = res.split(b'"result":')
         assert chunks[1].startswith(b'{"hash":')
-        assert chunks[2].startswith(bytes(f'{tip_height + 1}', 'utf8'))
+        assert chunks[2].startswith(bytes(f'{tip_height}', 'utf8'))
+
+    def check_compression(self):
+        self.log.info("Check negotiated response compression")
+        conn = BitcoinHTTPConnection(self.node)
+        body = '{"method": "help"}'
+        plain = conn.post('/', body)
+        assert_equal(plain.getheader('Content-Encoding'), None)
+        plain_body = plain.read()
+        assert len(plain_body) > MIN_COMPRESSED_BODY_SIZE
+
+        for accept_encoding, content_encoding, decompress in [
+            ('gzip', 'gzip', gzip.decompress),
+            ('deflate', 'deflate', zlib.decompress),
+            ('deflate, gzip;q=0.5', 'gzip', gzip.decompress),
+            ('gzip;q=0, deflate', 'deflate', zlib.decompress),
+            ('*', 'gzip', gzip.decompress),
+            ('identity', None, None),
+            ('gzip;q=0, *;q=0', None, None),
+        ]:
+            conn.add_header('Accept-Encoding', accept_encoding)
+            response = conn.post('/', body)
+            assert_equal(response.status, http.client.OK)
+            assert_equal(response.getheader('Content-Encoding'), content_encoding)
+            assert_equal(response.getheader('Vary'), 'Accept-Encoding')
+            data = response.read()
+            if decompress is not None:
+                assert len(data) < len(plain_body)
+                data = decompress(data)
+            assert_equal(data, plain_body)
+
+        # Small responses are sent as they are
+        response = conn.post('/', '{"method": "getblockcount"}')
+        assert_equal(response.getheader('Content-Encoding'), None)
+        assert_equal(response.getheader('Vary'), None)
+        response.read()
 
 
     def check_chunked_transfer(self):
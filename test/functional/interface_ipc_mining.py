@@ -423,6 +423,41 @@ class IPCMiningTest(BitcoinTestFramework):
 
         asyncio.run(capnp.run(async_routine()))
 
+    def run_template_diff_test(self):
+        """Verify that getDiff() turns the previous template's transactions into the new ones."""
+        self.log.info("Running template diff test")
+        node = self.nodes[0]
+
+        async def async_routine():
+            ctx, mining = await make_mining_ctx(self)
+            async with AsyncExitStack() as stack:
+                template = await mining_create_block_template(mining, stack, ctx, self.default_block_create_options)
+                assert template is not None
+                self.log.debug("A template from createNewBlock has no diff")
+                assert not (await template.getDiff(ctx)).hasResult
+
+                block = await mining_get_block(template, ctx)
+                tx = self.miniwallet.send_self_transfer(fee_rate=10, from_node=node)
+                template_next = await mining_wait_next_template(template, stack, ctx, self.default_block_wait_options)
+                assert template_next is not None
+
+                self.log.debug("The diff of a template from waitNext adds the new transaction")
+                response = await template_next.getDiff(ctx)
+                assert response.hasResult
+                diff = response.result
+                vtx = [block_tx.wtxid_hex for block_tx in block.vtx[1:]]
+                for index in reversed(list(diff.removed)):
+                    del vtx[index - 1]
+                for added in diff.added:
+                    added_tx = CTransaction()
+                    added_tx.deserialize(BytesIO(added.tx))
+                    vtx.insert(added.index - 1, added_tx.wtxid_hex)
+                block_next = await mining_get_block(template_next, ctx)
+                assert_equal(vtx, [block_tx.wtxid_hex for block_tx in block_next.vtx[1:]])
+                assert tx["wtxid"] in vtx
+
+        asyncio.run(capnp.run(async_routine()))
+
     def run_block_max_weight_test(self):
         """Verify IPC createNewBlock() and waitNext() preserve the -blockmaxweight policy."""
         self.log.info("Running block_max_weight test")
@@ -759,6 +794,7 @@ class IPCMiningTest(BitcoinTestFramework):
         self.run_block_template_test()
         self.run_coinbase_and_submission_test()
         self.run_waitnext_mining_policy_test()
+        self.run_template_diff_test()
         self.run_block_max_weight_test()
         self.run_ipc_option_override_test()
         self.run_transaction_lookup_test()
@@ -16,7 +16,10 @@ import urllib.parse
 from test_framework.messages import (
     BLOCK_HEADER_SIZE,
     COIN,
+    COutPoint,
+    CTxOut,
     deser_block_spent_outputs,
+    ser_string,
 )
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
@@ -330,6 +333,44 @@ class RESTTest (BitcoinTestFramework):
                 self.test_rest_request(f"/headers/{bb_hash}", ret_type=RetType.BYTES, status=400, query_params={"count": num}),
             )
 
+        self.log.info("Test the /range URIs")
+        tip_height = self.nodes[0].getblockcount()
+        start_height = tip_height - 4
+        range_hashes = [self.nodes[0].getblockhash(height) for height in range(start_height, tip_height + 1)]
+
+        response = self.test_rest_request(f"/range/headers/{start_height}/5", req_type=ReqType.BIN, ret_type=RetType.OBJ)
+        assert_equal(response.getheader('transfer-encoding'), 'chunked')
+        assert_equal(response.read().hex(), "".join(self.nodes[0].getblockheader(h, False) for h in range_hashes))
+        # Ranges end at the tip
+        response = self.test_rest_request(f"/range/headers/{start_height}/1000", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(len(response), 5 * BLOCK_HEADER_SIZE)
+
+        response = self.test_rest_request(f"/range/block/{start_height}/5", req_type=ReqType.HEX, ret_type=RetType.BYTES)
+        assert_equal(response.decode().rstrip(), "".join(self.nodes[0].getblock(h, 0) for h in range_hashes))
+        response = self.test_rest_request(f"/range/block/{start_height}/2", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(response.hex(), "".join(self.nodes[0].getblock(h, 0) for h in range_hashes[:2]))
+
+        rpc_blockfilters = [self.nodes[0].getblockfilter(h) for h in range_hashes]
+        response = self.test_rest_request(f"/range/blockfilter/basic/{start_height}/5", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(response, b"".join(bytes([0]) + bytes.fromhex(h)[::-1] + ser_string(bytes.fromhex(f['filter'])) for h, f in zip(range_hashes, rpc_blockfilters)))
+        response = self.test_rest_request(f"/range/blockfilterheaders/basic/{start_height}/5", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(response, b"".join(bytes.fromhex(f['header'])[::-1] for f in rpc_blockfilters))
+        response = self.test_rest_request("/range/blockfilterheaders/basic/0/1", req_type=ReqType.HEX, ret_type=RetType.BYTES)
+        assert_equal(bytes.fromhex(response.decode().rstrip())[::-1].hex(), self.nodes[0].getblockfilter(self.nodes[0].getblockhash(0))['header'])
+
+        # Check invalid range requests
+        resp = self.test_rest_request("/range/headers/-1/5", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid height: -1")
+        resp = self.test_rest_request("/range/headers/0/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid count: 0")
+        resp = self.test_rest_request(f"/range/block/{tip_height + 1}/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request(f"/range/blockfilter/{INVALID_PARAM}/0/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), f"Unknown filtertype {INVALID_PARAM}")
+        resp = self.test_rest_request("/range/headers/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid URI format. Expected /rest/range/headers/<start_height>/<count>.<bin|hex>")
+        self.test_rest_request("/range/headers/0/1", ret_type=RetType.OBJ, status=400)
+
         self.log.info("Test tx inclusion in the /mempool and /block URIs")
 
         # Make 3 chained txs and mine them on node 1
@@ -415,6 +456,57 @@ class RESTTest (BitcoinTestFramework):
         for tx in txs:
             assert tx in json_obj['tx']
 
+        self.log.info("Test the /utxoset URI")
+
+        def get_utxoset(**query_params):
+            stream = BytesIO(self.test_rest_request("/utxoset", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params=query_params))
+            best_block = stream.read(32)[::-1].hex()
+            height = int.from_bytes(stream.read(4), 'little')
+            coins = []
+            while stream.tell() < len(stream.getbuffer()):
+                outpoint = COutPoint()
+                outpoint.deserialize(stream)
+                coin_height = int.from_bytes(stream.read(4), 'little')
+                coinbase = stream.read(1) == b'\x01'
+                txout = CTxOut()
+                txout.deserialize(stream)
+                coins.append((outpoint, coin_height, coinbase, txout))
+            return best_block, height, coins
+
+        # The export reads the coins database, which gettxoutsetinfo flushes to
+        txoutset_info = self.nodes[0].gettxoutsetinfo()
+        best_block, height, coins = get_utxoset()
+        assert_equal(best_block, txoutset_info['bestblock'])
+        assert_equal(height, txoutset_info['height'])
+        assert_equal(len(coins), txoutset_info['txouts'])
+        assert_equal(sum(txout.nValue for _, _, _, txout in coins), txoutset_info['total_amount'] * COIN)
+        assert any(coinbase for _, _, coinbase, _ in coins)
+
+        response = self.test_rest_request("/utxoset", req_type=ReqType.HEX, ret_type=RetType.BYTES)
+        assert_equal(bytes.fromhex(response.decode().rstrip()), self.test_rest_request("/utxoset", req_type=ReqType.BIN, ret_type=RetType.BYTES))
+
+        # Resume after the 10th coin
+        cursor = coins[9][0]
+        _, _, resumed_coins = get_utxoset(cursor=f"{cursor.hash:064x}-{cursor.n}")
+        assert_equal([c[0].serialize() for c in resumed_coins], [c[0].serialize() for c in coins[10:]])
+
+        script_types = {}
+        for _, _, _, txout in coins:
+            script_hex = txout.scriptPubKey.hex()
+            if script_hex not in script_types:
+                script_types[script_hex] = self.nodes[0].decodescript(script_hex)['type']
+        for filter_types in [["witness_v1_taproot"], ["pubkeyhash", "witness_v0_keyhash"], ["witness_v0_scripthash"]]:
+            _, _, filtered_coins = get_utxoset(scripttype=",".join(filter_types))
+            expected = [c[0].serialize() for c in coins if script_types[c[3].scriptPubKey.hex()] in filter_types]
+            assert_equal([c[0].serialize() for c in filtered_coins], expected)
+
+        # Check invalid utxoset requests
+        resp = self.test_rest_request("/utxoset", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"scripttype": INVALID_PARAM})
+        assert_equal(resp.read().decode('utf-8').rstrip(), f"Unknown scripttype {INVALID_PARAM}")
+        resp = self.test_rest_request("/utxoset", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"cursor": INVALID_PARAM})
+        assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid cursor: {INVALID_PARAM}")
+        self.test_rest_request("/utxoset", ret_type=RetType.OBJ, status=400)
+
         self.log.info("Test the /chaininfo URI")
 
         bb_hash = self.nodes[0].getbestblockhash()
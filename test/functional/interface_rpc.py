@@ -4,11 +4,14 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Tests some generic aspects of the RPC interface."""
 
+import http.client
 import json
 import os
+import struct
+import urllib.parse
 from dataclasses import dataclass
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.util import assert_equal, assert_greater_than_or_equal, str_to_b64str
 from threading import Thread
 from typing import Optional
 import subprocess
@@ -79,6 +82,46 @@ def expect_http_rpc_status(expected_http_status, expected_rpc_error_code, node,
     assert_equal(status, expected_http_status)
 
 
+def decode_cbor(data: bytes, pos: int = 0) -> tuple[object, int]:
+    """Decode the subset of CBOR the RPC server produces, converting tag 23 byte strings to hex."""
+    initial = data[pos]
+    major, info = initial >> 5, initial & 0x1f
+    pos += 1
+    if initial == 0xfb:
+        return struct.unpack(">d", data[pos:pos + 8])[0], pos + 8
+    if major == 7:
+        return {0x14: False, 0x15: True, 0x16: None}[info], pos
+    if info < 24:
+        arg = info
+    else:
+        size = 1 << (info - 24)
+        arg = int.from_bytes(data[pos:pos + size], "big")
+        pos += size
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major == 2:
+        return data[pos:pos + arg], pos + arg
+    if major == 3:
+        return data[pos:pos + arg].decode("utf-8"), pos + arg
+    if major == 4:
+        items = []
+        for _ in range(arg):
+            item, pos = decode_cbor(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        obj = {}
+        for _ in range(arg):
+            key, pos = decode_cbor(data, pos)
+            obj[key], pos = decode_cbor(data, pos)
+        return obj, pos
+    assert_equal((major, arg), (6, 23))
+    value, pos = decode_cbor(data, pos)
+    return value.hex(), pos
+
+
 def test_work_queue_getblock(node, got_exceeded_error):
     while not got_exceeded_error:
         try:
@@ -226,6 +269,35 @@ class RPCInterfaceTest(BitcoinTestFramework):
         # Sanity check: command was not executed
         assert_equal(block_count + 1, self.nodes[0].getblockcount())
 
+    def test_cbor_replies(self):
+        self.log.info("Testing CBOR encoded replies...")
+        node = self.nodes[0]
+        url = urllib.parse.urlparse(node.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        auth = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"}
+        for method, params in [
+            ("getblock", [node.getbestblockhash(), 0]),
+            ("getblock", [node.getbestblockhash(), 2]),
+            ("getblockchaininfo", []),
+            ("getblockheader", ["00" * 32]),
+        ]:
+            body = json.dumps({"jsonrpc": "2.0", "id": 1, "method": method, "params": params})
+            conn.request("POST", "/", body, auth)
+            response = conn.getresponse()
+            assert_equal(response.getheader("Content-Type"), "application/json")
+            json_reply = json.loads(response.read())
+            for accept in ["application/cbor", "application/json;q=0.9, application/cbor"]:
+                conn.request("POST", "/", body, {**auth, "Accept": accept})
+                response = conn.getresponse()
+                assert_equal(response.getheader("Content-Type"), "application/cbor")
+                data = response.read()
+                cbor_reply, end = decode_cbor(data)
+                assert_equal(end, len(data))
+                assert_equal(cbor_reply, json_reply)
+        # Not acceptable
+        conn.request("POST", "/", '{"method": "getblockcount"}', {**auth, "Accept": "application/cbor;q=0"})
+        assert_equal(conn.getresponse().getheader("Content-Type"), "application/json")
+
     def test_work_queue_exceeded(self):
         self.log.info("Testing work queue exceeded...")
         self.restart_node(0, ['-rpcworkqueue=1', '-rpcthreads=1'])
@@ -242,6 +314,7 @@ class RPCInterfaceTest(BitcoinTestFramework):
         self.test_getrpcinfo()
         self.test_batch_requests()
         self.test_http_status_codes()
+        self.test_cbor_replies()
         self.test_work_queue_exceeded()
 
 
@@ -251,10 +251,10 @@ class ZMQTest (BitcoinTestFramework):
 
         self.log.info("Test the getzmqnotifications RPC")
         assert_equal(self.nodes[0].getzmqnotifications(), [
-            {"type": "pubhashblock", "address": address, "hwm": 1000},
-            {"type": "pubhashtx", "address": address, "hwm": 1000},
-            {"type": "pubrawblock", "address": address, "hwm": 1000},
-            {"type": "pubrawtx", "address": address, "hwm": 1000},
+            {"type": "pubhashblock", "address": address, "hwm": 1000, "dropped": 0},
+            {"type": "pubhashtx", "address": address, "hwm": 1000, "dropped": 0},
+            {"type": "pubrawblock", "address": address, "hwm": 1000, "dropped": 0},
+            {"type": "pubrawtx", "address": address, "hwm": 1000, "dropped": 0},
         ])
 
         assert_equal(self.nodes[1].getzmqnotifications(), [])
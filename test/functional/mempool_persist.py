@@ -33,6 +33,9 @@ Test is as follows:
     mempool.
   - Verify that savemempool throws when the RPC is called if
     node1 can't write to disk.
+  - Verify that a version 3 mempool.dat written at the current chain tip
+    takes the same-tip path, and that files with a different recorded tip
+    or in version 2 are loaded as well.
 
 """
 from decimal import Decimal
@@ -196,6 +199,7 @@ class MempoolPersistTest(BitcoinTestFramework):
 
         self.test_importmempool_union()
         self.test_persist_unbroadcast()
+        self.test_dump_versions()
 
     def test_persist_unbroadcast(self):
         node0 = self.nodes[0]
@@ -219,6 +223,41 @@ class MempoolPersistTest(BitcoinTestFramework):
         node0.mockscheduler(16 * 60)  # 15 min + 1 for buffer
         self.wait_until(lambda: len(conn.get_invs()) == 1)
 
+    def test_dump_versions(self):
+        node0 = self.nodes[0]
+        self.mini_wallet.send_self_transfer(from_node=node0)
+        num_txs = len(node0.getrawmempool())
+        mempooldat0 = node0.chain_path / "mempool.dat"
+        # Version (8 bytes) and obfuscation key (compact size and 8 bytes) come before the chain tip.
+        tip_offset = 8 + 1 + 8
+        same_tip_msg = f"Mempool file was written at the current chain tip {node0.getbestblockhash()}"
+        imported_msg = f"Imported mempool transactions from file: {num_txs} succeeded"
+
+        self.log.debug("Restart node0 at the same tip. Verify that the version 3 file takes the same-tip path")
+        with node0.assert_debug_log([same_tip_msg, imported_msg]):
+            self.restart_node(0)
+        data = mempooldat0.read_bytes()
+        assert_equal(int.from_bytes(data[:8], "little"), 3)
+
+        self.log.debug("Change the recorded chain tip. Verify that node0 falls back to regular batches")
+        self.stop_node(0)
+        data = bytearray(mempooldat0.read_bytes())
+        data[tip_offset] ^= 0xff
+        mempooldat0.write_bytes(data)
+        with node0.assert_debug_log([imported_msg], unexpected_msgs=[same_tip_msg]):
+            self.start_node(0)
+        assert_equal(len(node0.getrawmempool()), num_txs)
+
+        self.log.debug("Convert the file to version 2. Verify that node0 still loads it")
+        self.stop_node(0)
+        data = mempooldat0.read_bytes()
+        # Dropping the 32 byte chain tip keeps the rest of the file aligned with the obfuscation key.
+        data = (2).to_bytes(8, "little") + data[8:tip_offset] + data[tip_offset + 32:]
+        mempooldat0.write_bytes(data)
+        with node0.assert_debug_log([imported_msg], unexpected_msgs=[same_tip_msg]):
+            self.start_node(0)
+        assert_equal(len(node0.getrawmempool()), num_txs)
+
     def test_importmempool_union(self):
         self.log.debug("Submit different transactions to node0 and node1's mempools")
         self.start_node(0)
@@ -7,19 +7,28 @@ from collections import defaultdict
 
 from test_framework.messages import (
     CInv,
+    MSG_BLOCK,
+    MSG_WITNESS_FLAG,
     msg_getdata,
 )
 from test_framework.p2p import P2PInterface
 from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
 
 
 class P2PStoreBlock(P2PInterface):
     def __init__(self):
         super().__init__()
         self.blocks = defaultdict(int)
+        self.responses = []
 
     def on_block(self, message):
         self.blocks[message.block.hash_int] += 1
+        self.responses.append(message.block.hash_int)
+
+    def on_pong(self, message):
+        super().on_pong(message)
+        self.responses.append("pong")
 
 
 class GetdataTest(BitcoinTestFramework):
@@ -43,6 +52,22 @@ class GetdataTest(BitcoinTestFramework):
         p2p_block_store.send_and_ping(good_getdata)
         p2p_block_store.wait_until(lambda: p2p_block_store.blocks[best_block] == 1)
 
+        self.log.info("test that blocks read from disk are sent in order with other responses")
+        # Blocks other than the most recent one are read from disk by the block serve threads.
+        old_blocks = [int(self.nodes[0].getblockhash(height), 16) for height in (10, 20, 30)]
+        # sync_with_ping() sends two pings, both of which must be answered after the blocks.
+        p2p_block_store.responses = []
+        p2p_block_store.send_without_ping(msg_getdata([CInv(t=MSG_BLOCK | MSG_WITNESS_FLAG, h=old_blocks[0])]))
+        p2p_block_store.sync_with_ping()
+        assert_equal(p2p_block_store.responses, [old_blocks[0], "pong", "pong"])
+
+        p2p_block_store.responses = []
+        p2p_block_store.send_without_ping(msg_getdata([CInv(t=MSG_BLOCK | MSG_WITNESS_FLAG, h=old_blocks[1])]))
+        p2p_block_store.send_without_ping(msg_getdata([CInv(t=MSG_BLOCK, h=old_blocks[2]),
+                                                       CInv(t=MSG_BLOCK | MSG_WITNESS_FLAG, h=old_blocks[0])]))
+        p2p_block_store.sync_with_ping()
+        assert_equal(p2p_block_store.responses, [old_blocks[1], old_blocks[2], old_blocks[0], "pong", "pong"])
+
 
 if __name__ == '__main__':
     GetdataTest(__file__).main()
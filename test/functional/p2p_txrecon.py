@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction reconciliation rounds (REQRECON, SKETCH and RECONCILDIFF) with an inbound
+peer, for which the node is the responder.
+"""
+
+import time
+
+from test_framework.messages import (
+    msg_reconcildiff,
+    msg_reqrecon,
+    msg_sendtxrcncl,
+    msg_verack,
+    msg_wtxidrelay,
+)
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+# Keep in sync with src/node/txreconciliation.h
+RECON_REQUEST_INTERVAL = 8
+RECON_REQUEST_MIN_INTERVAL = RECON_REQUEST_INTERVAL // 2
+RECON_ROUND_TIMEOUT = 3 * RECON_REQUEST_INTERVAL
+
+
+class ReconcilingPeer(P2PInterface):
+    """Inbound peer which signals reconciliation support before VERACK."""
+    def __init__(self):
+        super().__init__()
+        self.sketches = []
+
+    def on_version(self, message):
+        sendtxrcncl = msg_sendtxrcncl()
+        sendtxrcncl.version = 1
+        sendtxrcncl.salt = 2
+        self.send_without_ping(msg_wtxidrelay())
+        self.send_without_ping(sendtxrcncl)
+        self.send_without_ping(msg_verack())
+        self.nServices = message.nServices
+        self.relay = message.relay
+
+    def on_sketch(self, message):
+        self.sketches.append(message)
+
+    def request_sketch(self):
+        request = msg_reqrecon()
+        request.set_size = 0
+        request.q = 0
+        self.send_and_ping(request)
+
+
+class TxReconTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [['-txreconciliation']]
+
+    def recon_stats(self):
+        return self.nodes[0].getnetworkinfo()["txreconciliation"]
+
+    def run_test(self):
+        node = self.nodes[0]
+        now = int(time.time())
+        node.setmocktime(now)
+
+        assert_equal(self.recon_stats(), {
+            "rounds_succeeded": 0,
+            "rounds_failed": 0,
+            "txs_reconciled": 0,
+            "txs_announced": 0,
+            "bytes_sent": 0,
+            "bytes_saved": 0,
+        })
+
+        with node.assert_debug_log(["Register peer=0"]):
+            peer = node.add_p2p_connection(ReconcilingPeer())
+
+        self.log.info("A round with nothing to reconcile gets an empty sketch")
+        peer.request_sketch()
+        peer.wait_until(lambda: len(peer.sketches) == 1)
+        assert_equal(peer.sketches[0].skdata, b"")
+        diff = msg_reconcildiff()
+        diff.success = 1
+        peer.send_and_ping(diff)
+        assert_equal(self.recon_stats()["rounds_succeeded"], 1)
+
+        self.log.info("Requests sooner than the minimum interval are ignored")
+        node.setmocktime(now + RECON_REQUEST_MIN_INTERVAL - 1)
+        with node.assert_debug_log(["reqrecon from peer=0 ignored, as it came too soon after the previous one"]):
+            peer.request_sketch()
+        assert_equal(len(peer.sketches), 1)
+        node.setmocktime(now + RECON_REQUEST_MIN_INTERVAL)
+        peer.request_sketch()
+        peer.wait_until(lambda: len(peer.sketches) == 2)
+
+        self.log.info("A round the peer does not complete times out")
+        node.setmocktime(now + RECON_REQUEST_MIN_INTERVAL + RECON_ROUND_TIMEOUT)
+        with node.assert_debug_log(["Reconciliation with peer=0 timed out: announcing 0"]):
+            peer.sync_with_ping()
+        assert_equal(self.recon_stats()["rounds_failed"], 1)
+
+        self.log.info("A RECONCILDIFF outside of a round is a protocol violation")
+        with node.assert_debug_log(["unexpected reconcildiff"]):
+            peer.send_without_ping(diff)
+            peer.wait_for_disconnect()
+
+
+if __name__ == '__main__':
+    TxReconTest(__file__).main()
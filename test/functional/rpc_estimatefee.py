@@ -7,10 +7,17 @@
 Test the following RPCs:
    - estimatesmartfee
    - estimaterawfee
+   - estimatemempoolfee
 """
+from decimal import Decimal
 
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_raises_rpc_error
+from test_framework.util import (
+    assert_approx,
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
 
 class EstimateFeeTest(BitcoinTestFramework):
     def set_test_params(self):
@@ -50,6 +57,35 @@ class EstimateFeeTest(BitcoinTestFramework):
         self.nodes[0].estimaterawfee(1, None)
         self.nodes[0].estimaterawfee(1, 1)
 
+        self.test_estimatemempoolfee()
+
+    def test_estimatemempoolfee(self):
+        node = self.nodes[0]
+        self.log.info("Test estimatemempoolfee")
+        assert_raises_rpc_error(-1, "estimatemempoolfee", node.estimatemempoolfee)
+        assert_raises_rpc_error(-8, "Invalid conf_target, must be between 1 and 1008", node.estimatemempoolfee, 0)
+        assert_raises_rpc_error(-8, "Invalid conf_target, must be between 1 and 1008", node.estimatemempoolfee, 1009)
+
+        min_feerate = node.getmempoolinfo()["mempoolminfee"]
+        assert_equal(node.estimatemempoolfee(1), {"feerate": min_feerate, "mempoolbound": False, "blocks": 1})
+
+        # Twelve ~100 kvB transactions at 20 sat/vB and twelve at 10 sat/vB: a bit more than one block
+        # at the higher feerate, and a bit less than three blocks in total.
+        wallet = MiniWallet(node)
+        for fee_rate in [Decimal("0.0002")] * 12 + [Decimal("0.0001")] * 12:
+            wallet.send_self_transfer(from_node=node, fee_rate=fee_rate, target_vsize=99_000, confirmed_only=True)
+        estimate = node.estimatemempoolfee(1)
+        assert estimate["mempoolbound"]
+        assert_approx(estimate["feerate"], Decimal("0.0002"), vspan=Decimal("0.000001"))
+        assert_approx(node.estimatemempoolfee(2)["feerate"], Decimal("0.0001"), vspan=Decimal("0.000001"))
+        assert_equal(node.estimatemempoolfee(3), {"feerate": min_feerate, "mempoolbound": False, "blocks": 3})
+
+        self.log.info("Test that estimatemempoolfee follows blocks and reorgs")
+        block_hash = self.generate(node, 1)[0]
+        assert_approx(node.estimatemempoolfee(1)["feerate"], Decimal("0.0001"), vspan=Decimal("0.000001"))
+        node.invalidateblock(block_hash)
+        assert_equal(node.estimatemempoolfee(1), estimate)
+
 
 if __name__ == '__main__':
     EstimateFeeTest(__file__).main()
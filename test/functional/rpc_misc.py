@@ -120,6 +120,16 @@ class RpcMiscTest(BitcoinTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test getvalidationqueueinfo")
+        node.syncwithvalidationinterfacequeue()
+        queues = node.getvalidationqueueinfo()
+        # The default queue comes first, and each index has a queue of its own
+        assert_equal(list(queues)[0], "default")
+        assert_greater_than(queues["default"]["subscribers"], 0)
+        for name in ["txidx", "blkfltbscidx", "coinstatsidx", "txospenderidx"]:
+            assert_equal(queues[name]["subscribers"], 1)
+        assert all(q["pending"] == 0 for q in queues.values())
+
         # Test a deprecated category
         all_result = node.logging(include=['all'])
         assert_equal(True, all(enabled is True for category, enabled in all_result.items()))
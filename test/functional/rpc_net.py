@@ -142,9 +142,10 @@ class NetTest(BitcoinTestFramework):
         peer_info = self.nodes[0].getpeerinfo()[no_version_peer_id]
         peer_info.pop("addr")
         peer_info.pop("addrbind")
-        # The next two fields will vary for v2 connections because we send a rng-based number of decoy messages
+        # The next three fields will vary for v2 connections because we send a rng-based number of decoy messages
         peer_info.pop("bytesrecv")
         peer_info.pop("bytessent")
+        peer_info.pop("sendcalls")
         assert_equal(
             peer_info,
             {
@@ -160,6 +161,8 @@ class NetTest(BitcoinTestFramework):
                 "id": no_version_peer_id,
                 "inbound": True,
                 "inflight": [],
+                "inflight_limit": 16,
+                "blocks_received": 0,
                 "last_block": 0,
                 "last_transaction": 0,
                 "lastrecv": 0 if not self.options.v2transport else no_version_peer_conntime,